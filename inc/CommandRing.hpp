@@ -0,0 +1,208 @@
+// MIT License
+//
+// Copyright (c) 2022-2025 James Smith of OrangeFox86
+// https://github.com/OrangeFox86/DreamcastControllerUsbPico
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef __COMMAND_RING_H__
+#define __COMMAND_RING_H__
+
+#include <stdint.h>
+#include <string.h>
+#include <atomic>
+#include <vector>
+
+//! Ring buffer of received commands along with an index of the complete ones
+//!
+//! There is exactly one producer, which receives characters, and one consumer, which processes
+//! complete commands; neither ever waits on the other. The producer only ever writes past the last
+//! complete command, and the consumer only ever releases commands it is done with, so each command
+//! may be handed over in place. Positions are free-running and only wrapped when indexing.
+class CommandRing
+{
+    public:
+        //! A complete command in the ring buffer
+        struct Item
+        {
+            //! Position of the first character
+            uint32_t start;
+            //! Number of characters (text is followed by a NULL terminator which isn't counted)
+            uint16_t len;
+            //! true for a binary frame or false for a text command
+            bool isFrame;
+        };
+
+        //! Constructor
+        CommandRing() :
+            mRing(),
+            mTail(0),
+            mHead(0),
+            mItems(),
+            mItemTail(0),
+            mItemHead(0),
+            mUnwrapped()
+        {}
+
+        //! @returns the number of free characters (producer side)
+        inline uint32_t getFreeSpace() const
+        {
+            return MAX_QUEUE_SIZE - getUsedSpace();
+        }
+
+        //! @returns the number of characters which haven't been released (producer side)
+        inline uint32_t getUsedSpace() const
+        {
+            return mTail - mHead.load(std::memory_order_acquire);
+        }
+
+        //! @returns true iff another item may be committed (producer side)
+        inline bool isItemSpaceAvailable() const
+        {
+            return (mItemTail.load(std::memory_order_relaxed)
+                    - mItemHead.load(std::memory_order_acquire)) < MAX_ITEMS;
+        }
+
+        //! @returns the position after the last added character (producer side)
+        inline uint32_t getTail() const
+        {
+            return mTail;
+        }
+
+        //! Drops characters added after the given position which haven't been committed yet
+        //! (producer side)
+        //! @param[in] tail  The new tail position
+        inline void setTail(uint32_t tail)
+        {
+            mTail = tail;
+        }
+
+        //! @param[in] pos  Position of a character that was added, but not yet committed
+        //! @returns the character at the given position (producer side)
+        inline char at(uint32_t pos) const
+        {
+            return mRing[pos % MAX_QUEUE_SIZE];
+        }
+
+        //! Adds a character - caller must check getFreeSpace() first (producer side)
+        inline void push(char c)
+        {
+            mRing[mTail++ % MAX_QUEUE_SIZE] = c;
+        }
+
+        //! Adds characters - caller must check getFreeSpace() first (producer side)
+        //! @param[in] chars  The characters to add
+        //! @param[in] len  Number of characters to add
+        void push(const char* chars, uint32_t len)
+        {
+            uint32_t pos = mTail % MAX_QUEUE_SIZE;
+            uint32_t first = MAX_QUEUE_SIZE - pos;
+            if (first > len)
+            {
+                first = len;
+            }
+            memcpy(&mRing[pos], chars, first);
+            memcpy(&mRing[0], chars + first, len - first);
+            mTail += len;
+        }
+
+        //! Adds a complete command to the index, making it available to the consumer - caller must
+        //! check isItemSpaceAvailable() first (producer side)
+        //! @param[in] start  Position of the first character of the command
+        //! @param[in] len  Number of characters in the command (not including text terminator)
+        //! @param[in] isFrame  true for a binary frame or false for a NULL terminated text command
+        void commit(uint32_t start, uint32_t len, bool isFrame)
+        {
+            uint32_t itemTail = mItemTail.load(std::memory_order_relaxed);
+            Item& item = mItems[itemTail % MAX_ITEMS];
+            item.start = start;
+            item.len = len;
+            item.isFrame = isFrame;
+            mItemTail.store(itemTail + 1, std::memory_order_release);
+        }
+
+        //! Gets the next complete command without releasing it (consumer side)
+        //! @param[out] item  Set to the next command
+        //! @param[out] chars  Set to the contiguous characters of the command, valid until release()
+        //! @returns false if there is no complete command available
+        bool peek(Item& item, const char*& chars)
+        {
+            uint32_t itemHead = mItemHead.load(std::memory_order_relaxed);
+            if (itemHead == mItemTail.load(std::memory_order_acquire))
+            {
+                return false;
+            }
+
+            // The producer doesn't touch this item until it is released
+            item = mItems[itemHead % MAX_ITEMS];
+            uint32_t size = getSize(item);
+            uint32_t pos = item.start % MAX_QUEUE_SIZE;
+            chars = &mRing[pos];
+
+            if (pos + size > MAX_QUEUE_SIZE)
+            {
+                // Wrapped around the end of the ring buffer - rare enough that copying is fine
+                mUnwrapped.assign(&mRing[pos], &mRing[MAX_QUEUE_SIZE]);
+                mUnwrapped.insert(mUnwrapped.end(), &mRing[0], &mRing[pos + size - MAX_QUEUE_SIZE]);
+                chars = &mUnwrapped[0];
+            }
+
+            return true;
+        }
+
+        //! Releases the command last returned by peek() along with its characters (consumer side)
+        void release()
+        {
+            uint32_t itemHead = mItemHead.load(std::memory_order_relaxed);
+            const Item& item = mItems[itemHead % MAX_ITEMS];
+            mHead.store(item.start + getSize(item), std::memory_order_release);
+            mItemHead.store(itemHead + 1, std::memory_order_release);
+        }
+
+    private:
+        //! @returns the number of characters the given item occupies in the ring buffer
+        static inline uint32_t getSize(const Item& item)
+        {
+            return item.len + (item.isFrame ? 0 : 1);
+        }
+
+    public:
+        //! Max of 2 KB of memory to use for the ring buffer (must be a power of 2)
+        static const uint32_t MAX_QUEUE_SIZE = 2048;
+        //! Maximum number of complete commands waiting to be processed (must be a power of 2)
+        static const uint32_t MAX_ITEMS = 64;
+
+    private:
+        //! Receive ring buffer
+        char mRing[MAX_QUEUE_SIZE];
+        //! Position after the last received character (producer only)
+        uint32_t mTail;
+        //! Position of the first character which hasn't been released (written by consumer only)
+        std::atomic<uint32_t> mHead;
+        //! Index of complete commands
+        Item mItems[MAX_ITEMS];
+        //! Position after the last complete command in mItems (written by producer only)
+        std::atomic<uint32_t> mItemTail;
+        //! Position of the next command in mItems to process (written by consumer only)
+        std::atomic<uint32_t> mItemHead;
+        //! Holds a command which wraps around the end of mRing so it may be handed over in one piece
+        std::vector<char> mUnwrapped;
+};
+
+#endif // __COMMAND_RING_H__
@@ -0,0 +1,220 @@
+// MIT License
+//
+// Copyright (c) 2022-2025 James Smith of OrangeFox86
+// https://github.com/OrangeFox86/DreamcastControllerUsbPico
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef __DEFERRED_LOG_H__
+#define __DEFERRED_LOG_H__
+
+#include <stdint.h>
+#include <atomic>
+
+//! Lock-free, single producer/single consumer log buffer
+//!
+//! Instead of formatting text at the call site, each call stores the address of the format string
+//! plus the raw arguments as 32-bit words. Formatting is left to a host-side tool
+//! (scripts/decode_log.py) which resolves format string and %s addresses using the built ELF file.
+//! This keeps the cost of a log call to a handful of word writes so that logging may be left
+//! enabled without disturbing Maple Bus timing.
+//!
+//! Serialized record layout (all multi-byte values are little endian):
+//!   [SYNC_BYTE] [number of args] [format address: 4 bytes] [args: 4 bytes each]
+//! A record with format address 0 and 1 argument reports the number of dropped records.
+class DeferredLog
+{
+    public:
+        //! Constructor
+        //! @param[in] buffer  The word buffer to use as storage
+        //! @param[in] numWords  Number of words in buffer (must be a power of 2)
+        DeferredLog(uint32_t* buffer, uint32_t numWords) :
+            mBuffer(buffer),
+            mMask(numWords - 1),
+            mHead(0),
+            mTail(0),
+            mDroppedCount(0),
+            mReportedDroppedCount(0)
+        {}
+
+        //! Adds a log record to the buffer (producer side only)
+        //! @param[in] fmt  The printf-style format string (must reside in static memory)
+        //! @param[in] args  The arguments, each cast to a 32-bit word
+        //! @param[in] numArgs  Number of words in args (at most MAX_ARGS)
+        //! @returns true if the record was added or false if it was dropped
+        bool log(const char* fmt, const uint32_t* args, uint8_t numArgs)
+        {
+            if (numArgs > MAX_ARGS)
+            {
+                numArgs = MAX_ARGS;
+            }
+
+            const uint32_t numWords = HEADER_WORDS + numArgs;
+            const uint32_t head = mHead.load(std::memory_order_relaxed);
+            const uint32_t tail = mTail.load(std::memory_order_acquire);
+            if ((mMask + 1) - (head - tail) < numWords)
+            {
+                // Only the producer writes this value, so read-modify-write atomics aren't needed
+                mDroppedCount.store(
+                    mDroppedCount.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+                return false;
+            }
+
+            mBuffer[head & mMask] = numArgs;
+            mBuffer[(head + 1) & mMask] = static_cast<uint32_t>(reinterpret_cast<uintptr_t>(fmt));
+            for (uint32_t i = 0; i < numArgs; ++i)
+            {
+                mBuffer[(head + HEADER_WORDS + i) & mMask] = args[i];
+            }
+
+            mHead.store(head + numWords, std::memory_order_release);
+            return true;
+        }
+
+        //! Convenience function which casts each argument to a 32-bit word then logs it
+        //! @param[in] fmt  The printf-style format string (must reside in static memory)
+        //! @param[in] args  Integer or pointer arguments
+        //! @returns true if the record was added or false if it was dropped
+        template<typename... Args>
+        inline bool print(const char* fmt, Args... args)
+        {
+            const uint32_t words[sizeof...(Args) + 1] = {toWord(args)..., 0};
+            return log(fmt, words, sizeof...(Args));
+        }
+
+        //! Serializes as many whole records as will fit into the given buffer (consumer side only)
+        //! @param[out] out  The buffer to write serialized records to
+        //! @param[in] maxLen  The number of bytes available in out
+        //! @returns the number of bytes written to out
+        uint32_t read(uint8_t* out, uint32_t maxLen)
+        {
+            uint32_t len = 0;
+
+            const uint32_t dropped = mDroppedCount.load(std::memory_order_relaxed);
+            if (dropped != mReportedDroppedCount)
+            {
+                if (maxLen < recordSize(1))
+                {
+                    return 0;
+                }
+                const uint32_t count = dropped - mReportedDroppedCount;
+                len += serialize(&out[len], 0, &count, 1);
+                mReportedDroppedCount = dropped;
+            }
+
+            uint32_t tail = mTail.load(std::memory_order_relaxed);
+            const uint32_t head = mHead.load(std::memory_order_acquire);
+            while (tail != head)
+            {
+                const uint8_t numArgs = mBuffer[tail & mMask];
+                const uint32_t size = recordSize(numArgs);
+                if (len + size > maxLen)
+                {
+                    break;
+                }
+
+                uint32_t args[MAX_ARGS];
+                for (uint32_t i = 0; i < numArgs; ++i)
+                {
+                    args[i] = mBuffer[(tail + HEADER_WORDS + i) & mMask];
+                }
+                len += serialize(&out[len], mBuffer[(tail + 1) & mMask], args, numArgs);
+                tail += HEADER_WORDS + numArgs;
+            }
+            mTail.store(tail, std::memory_order_release);
+
+            return len;
+        }
+
+        //! @returns true if there is nothing left to read
+        inline bool isEmpty() const
+        {
+            return (
+                mTail.load(std::memory_order_relaxed) == mHead.load(std::memory_order_acquire)
+                && mReportedDroppedCount == mDroppedCount.load(std::memory_order_relaxed)
+            );
+        }
+
+        //! @returns the serialized size in bytes of a record with the given number of arguments
+        static inline uint32_t recordSize(uint8_t numArgs)
+        {
+            return 6 + (4 * numArgs);
+        }
+
+    public:
+        //! The maximum number of arguments a single record may hold
+        static const uint8_t MAX_ARGS = 6;
+        //! The first byte of each serialized record
+        static const uint8_t SYNC_BYTE = 0xA5;
+
+    private:
+        static inline uint32_t toWord(const char* value)
+        {
+            return static_cast<uint32_t>(reinterpret_cast<uintptr_t>(value));
+        }
+
+        template<typename T>
+        static inline uint32_t toWord(T value)
+        {
+            return static_cast<uint32_t>(value);
+        }
+
+        static uint32_t serialize(uint8_t* out, uint32_t fmt, const uint32_t* args, uint8_t numArgs)
+        {
+            uint8_t* p = out;
+            *p++ = SYNC_BYTE;
+            *p++ = numArgs;
+            p = serializeWord(p, fmt);
+            for (uint32_t i = 0; i < numArgs; ++i)
+            {
+                p = serializeWord(p, args[i]);
+            }
+            return p - out;
+        }
+
+        static inline uint8_t* serializeWord(uint8_t* out, uint32_t word)
+        {
+            *out++ = word & 0xFF;
+            *out++ = (word >> 8) & 0xFF;
+            *out++ = (word >> 16) & 0xFF;
+            *out++ = (word >> 24) & 0xFF;
+            return out;
+        }
+
+    private:
+        //! Number of words stored ahead of the arguments (number of args, format address)
+        static const uint32_t HEADER_WORDS = 2;
+        //! The word storage
+        uint32_t* const mBuffer;
+        //! Mask used to wrap indices into mBuffer
+        const uint32_t mMask;
+        //! Free-running write index (written by producer only)
+        std::atomic<uint32_t> mHead;
+        //! Free-running read index (written by consumer only)
+        std::atomic<uint32_t> mTail;
+        //! Number of records dropped because the buffer was full (written by producer only)
+        std::atomic<uint32_t> mDroppedCount;
+        //! The value of mDroppedCount last reported by read() (consumer only)
+        uint32_t mReportedDroppedCount;
+};
+
+//! @returns the global deferred log instance used by DEBUG_PRINT
+DeferredLog& get_deferred_log();
+
+#endif // __DEFERRED_LOG_H__
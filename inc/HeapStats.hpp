@@ -0,0 +1,58 @@
+// MIT License
+//
+// Copyright (c) 2022-2025 James Smith of OrangeFox86
+// https://github.com/OrangeFox86/DreamcastControllerUsbPico
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef __HEAP_STATS_H__
+#define __HEAP_STATS_H__
+
+#include <stdint.h>
+#include "hal/System/MutexInterface.hpp"
+
+//! Heap usage counters maintained by the global operator new/delete replacements
+//! These are only active when the HEAP_STATS_ENABLED CMake option is set or in the unit test build;
+//! otherwise all values remain 0.
+struct HeapStats
+{
+    //! Number of bytes currently allocated (not including bookkeeping overhead)
+    uint32_t liveBytes;
+    //! Highest value of liveBytes since start or last call to heap_stats_reset_peak()
+    uint32_t peakBytes;
+    //! Number of allocations which haven't been freed yet
+    uint32_t liveAllocations;
+    //! Number of allocations made since start
+    uint32_t totalAllocations;
+};
+
+//! @returns a snapshot of the current heap counters
+HeapStats heap_stats_get();
+
+//! @returns the number of allocations made since start (cheaper than heap_stats_get())
+uint32_t heap_stats_total_allocations();
+
+//! Resets the peak to the current number of live bytes
+void heap_stats_reset_peak();
+
+//! Sets the mutex used to serialize counter updates when more than one core allocates
+//! @param[in] mutex  The mutex to use or nullptr for none (critical section mutex recommended)
+void heap_stats_set_mutex(MutexInterface* mutex);
+
+#endif // __HEAP_STATS_H__
@@ -0,0 +1,156 @@
+// MIT License
+//
+// Copyright (c) 2022-2025 James Smith of OrangeFox86
+// https://github.com/OrangeFox86/DreamcastControllerUsbPico
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef __LATENCY_HISTOGRAM_H__
+#define __LATENCY_HISTOGRAM_H__
+
+#include <stdint.h>
+#include <atomic>
+
+//! Histogram of latency samples in fixed width microsecond bins
+//!
+//! add() must only be called from a single context. The getters and reset() may be called from any
+//! other context. Only atomic loads and stores are used (no read-modify-write operations), so this
+//! works across RP2040 cores without locking. A concurrent reset() may lose a sample being added, and
+//! percentiles computed while samples are being added may be off by those samples.
+class LatencyHistogram
+{
+    public:
+        //! Constructor
+        LatencyHistogram() :
+            mBins(),
+            mMaxUs(0),
+            mResetRequested(false)
+        {}
+
+        //! Adds a latency sample
+        //! @param[in] latencyUs  The latency in microseconds
+        void add(uint32_t latencyUs)
+        {
+            if (mResetRequested)
+            {
+                clear();
+                mResetRequested = false;
+            }
+
+            uint32_t idx = latencyUs / BIN_WIDTH_US;
+            if (idx >= NUM_BINS)
+            {
+                idx = NUM_BINS - 1;
+            }
+            mBins[idx].store(mBins[idx].load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+
+            if (latencyUs > mMaxUs.load(std::memory_order_relaxed))
+            {
+                mMaxUs.store(latencyUs, std::memory_order_relaxed);
+            }
+        }
+
+        //! Clears all samples before the next sample is added (from the adding context)
+        void reset()
+        {
+            mResetRequested = true;
+        }
+
+        //! @returns the number of samples
+        uint32_t getCount() const
+        {
+            if (mResetRequested)
+            {
+                return 0;
+            }
+
+            uint32_t count = 0;
+            for (uint32_t i = 0; i < NUM_BINS; ++i)
+            {
+                count += mBins[i].load(std::memory_order_relaxed);
+            }
+            return count;
+        }
+
+        //! @returns the largest sample in microseconds or 0 if there are no samples
+        uint32_t getMaxUs() const
+        {
+            return mResetRequested ? 0 : mMaxUs.load(std::memory_order_relaxed);
+        }
+
+        //! @param[in] permille  The percentile in tenths of a percent [0,1000] (ex: 990 for p99)
+        //! @returns the upper edge of the bin which contains the given percentile in microseconds
+        //!          (the largest sample for samples beyond the last bin) or 0 if there are no samples
+        uint32_t getPercentileUs(uint32_t permille) const
+        {
+            uint32_t count = getCount();
+            if (count == 0)
+            {
+                return 0;
+            }
+
+            // Number of samples at or below the percentile (at least 1)
+            uint32_t target = (static_cast<uint64_t>(count) * permille + 999) / 1000;
+            if (target == 0)
+            {
+                target = 1;
+            }
+
+            uint32_t cumulative = 0;
+            for (uint32_t i = 0; i < NUM_BINS - 1; ++i)
+            {
+                cumulative += mBins[i].load(std::memory_order_relaxed);
+                if (cumulative >= target)
+                {
+                    uint32_t upperUs = (i + 1) * BIN_WIDTH_US;
+                    uint32_t maxUs = getMaxUs();
+                    return (maxUs < upperUs) ? maxUs : upperUs;
+                }
+            }
+
+            return getMaxUs();
+        }
+
+    private:
+        //! Zeroes all samples (adding context only)
+        void clear()
+        {
+            for (uint32_t i = 0; i < NUM_BINS; ++i)
+            {
+                mBins[i].store(0, std::memory_order_relaxed);
+            }
+            mMaxUs.store(0, std::memory_order_relaxed);
+        }
+
+    public:
+        //! Width of each bin in microseconds
+        static const uint32_t BIN_WIDTH_US = 50;
+        //! Number of bins; the last bin collects everything at or beyond its lower edge
+        static const uint32_t NUM_BINS = 128;
+
+    private:
+        //! Sample count of each bin
+        std::atomic<uint32_t> mBins[NUM_BINS];
+        //! Largest sample
+        std::atomic<uint32_t> mMaxUs;
+        //! Set by reset() and cleared in the adding context once samples are cleared
+        std::atomic<bool> mResetRequested;
+};
+
+#endif // __LATENCY_HISTOGRAM_H__
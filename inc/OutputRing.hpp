@@ -0,0 +1,323 @@
+// MIT License
+//
+// Copyright (c) 2022-2025 James Smith of OrangeFox86
+// https://github.com/OrangeFox86/DreamcastControllerUsbPico
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef __OUTPUT_RING_H__
+#define __OUTPUT_RING_H__
+
+#include <stdint.h>
+#include <string.h>
+#include <atomic>
+#include "hal/System/MutexInterface.hpp"
+#include "hal/System/LockGuard.hpp"
+#include "hal/Usb/LineOutput.hpp"
+
+//! Byte stream buffer which any number of producers append to without ever waiting on the consumer
+//!
+//! The consumer side is lock-free. Producers are serialized with each other only for as long as it
+//! takes to copy their data in (the M0+ has no atomic read-modify-write, so a short critical section
+//! is the cheapest way to let both cores and IRQs produce). When there isn't room for everything
+//! given to write(), nothing is written and the dropped bytes are counted instead, so a stalled
+//! consumer never blocks a producer and the stream never contains part of a single write() call.
+//!
+//! Text which is written a piece at a time (stdio calls its driver several times for one line) goes
+//! through writeText() instead. A line is only started when there is room for lineReserve bytes, so
+//! the rest of a line which fits in that reserve is never dropped. A line which can't be started is
+//! dropped through its end of line, and a line which outgrows the reserve is cut short but still
+//! terminated, so a full buffer drops whole lines instead of corrupting them.
+//!
+//! Lines which are available all at once go through writeLine() instead, which adds the whole line
+//! or none of it no matter how long it is. The last reservedSize bytes of the buffer may only be
+//! used by lines no longer than MAX_RESERVED_LINE_LEN given to writeLine(), so that a producer may
+//! still report that a longer line of its own was dropped.
+class OutputRing : public LineOutput
+{
+    public:
+        //! Constructor
+        //! @param[in] buffer  The byte buffer to use as storage
+        //! @param[in] size  Number of bytes in buffer (must be a power of 2)
+        //! @param[in] producerMutex  Serializes producers (should be short-lived and IRQ safe)
+        //! @param[in] lineReserve  Number of free bytes needed to start a line in writeText()
+        //! @param[in] reservedSize  Number of bytes only short lines given to writeLine() may use
+        //! @param[in] lineEnd  End of line added by writeLine()
+        OutputRing(uint8_t* buffer,
+                   uint32_t size,
+                   MutexInterface& producerMutex,
+                   uint32_t lineReserve = 0,
+                   uint32_t reservedSize = 0,
+                   const char* lineEnd = "\n") :
+            mBuffer(buffer),
+            mMask(size - 1),
+            mProducerMutex(producerMutex),
+            mLineReserve(lineReserve),
+            mReservedSize(reservedSize),
+            mLineEnd(reinterpret_cast<const uint8_t*>(lineEnd)),
+            mLineEndLen(strlen(lineEnd)),
+            mHead(0),
+            mTail(0),
+            mDroppedCount(0),
+            mLineOpen(false),
+            mDroppingLine(false)
+        {}
+
+        //! Appends all of the given data or none of it (producer side)
+        //! @param[in] data  The data to append
+        //! @param[in] len  Number of bytes in data
+        //! @returns true if the data was added or false if it was dropped
+        bool write(const uint8_t* data, uint32_t len)
+        {
+            LockGuard lockGuard(mProducerMutex);
+            if (!lockGuard.isLocked())
+            {
+                // Would deadlock - a producer was interrupted on this core
+                return false;
+            }
+
+            if (getFreeSpace() < len)
+            {
+                addDropped(len);
+                return false;
+            }
+
+            copyIn(data, len);
+            return true;
+        }
+
+        //! Appends text which may be just part of a line (producer side)
+        //! @param[in] data  The text to append
+        //! @param[in] len  Number of bytes in data
+        //! @returns true if all of the text was added or false if any of it was dropped
+        bool writeText(const uint8_t* data, uint32_t len)
+        {
+            LockGuard lockGuard(mProducerMutex);
+            if (!lockGuard.isLocked())
+            {
+                // Would deadlock - a producer was interrupted on this core
+                return false;
+            }
+
+            bool allWritten = true;
+            while (len > 0)
+            {
+                // Split off everything through the next end of line
+                const uint8_t* eol = static_cast<const uint8_t*>(memchr(data, '\n', len));
+                const uint32_t segmentLen = (eol != nullptr) ? (eol - data + 1) : len;
+                if (!writeLineSegment(data, segmentLen, eol != nullptr))
+                {
+                    allWritten = false;
+                }
+                data += segmentLen;
+                len -= segmentLen;
+            }
+            return allWritten;
+        }
+
+        //! Appends a whole line or none of it (producer side)
+        //! @param[in] text  The text of the line, without its end of line
+        //! @param[in] len  Number of characters in text
+        //! @returns true if the line was added or false if it was dropped
+        bool writeLine(const char* text, uint32_t len) final
+        {
+            LockGuard lockGuard(mProducerMutex);
+            if (!lockGuard.isLocked())
+            {
+                // Would deadlock - a producer was interrupted on this core
+                return false;
+            }
+
+            const uint32_t total = len + mLineEndLen;
+            if (getFreeSpace(total <= MAX_RESERVED_LINE_LEN) < total)
+            {
+                addDropped(total);
+                return false;
+            }
+
+            copyIn(reinterpret_cast<const uint8_t*>(text), len);
+            copyIn(mLineEnd, mLineEndLen);
+            return true;
+        }
+
+        //! @returns the length of the longest line which writeLine() may ever add
+        uint32_t getMaxLineLength() const final
+        {
+            return (mMask + 1) - mReservedSize - mLineEndLen;
+        }
+
+        //! Removes up to maxLen bytes from the front of the stream (consumer side only)
+        //! @param[out] out  The buffer to write to
+        //! @param[in] maxLen  The number of bytes available in out
+        //! @returns the number of bytes written to out
+        uint32_t read(uint8_t* out, uint32_t maxLen)
+        {
+            const uint32_t tail = mTail.load(std::memory_order_relaxed);
+            const uint32_t head = mHead.load(std::memory_order_acquire);
+            uint32_t len = head - tail;
+            if (len > maxLen)
+            {
+                len = maxLen;
+            }
+
+            const uint32_t pos = tail & mMask;
+            uint32_t first = (mMask + 1) - pos;
+            if (first > len)
+            {
+                first = len;
+            }
+            memcpy(out, &mBuffer[pos], first);
+            memcpy(out + first, &mBuffer[0], len - first);
+
+            mTail.store(tail + len, std::memory_order_release);
+            return len;
+        }
+
+        //! @returns true if there is nothing left to read
+        inline bool isEmpty() const
+        {
+            return (mTail.load(std::memory_order_relaxed) == mHead.load(std::memory_order_acquire));
+        }
+
+        //! @returns the total number of bytes dropped because the buffer was full
+        inline uint32_t getDroppedCount() const final
+        {
+            return mDroppedCount.load(std::memory_order_relaxed);
+        }
+
+    private:
+        //! @returns the number of bytes which may be written (producer side)
+        //! @param[in] useReserved  true to include the space reserved for short lines
+        inline uint32_t getFreeSpace(bool useReserved = false) const
+        {
+            const uint32_t free = (mMask + 1)
+                - (mHead.load(std::memory_order_relaxed) - mTail.load(std::memory_order_acquire));
+            if (useReserved)
+            {
+                return free;
+            }
+            return (free > mReservedSize) ? (free - mReservedSize) : 0;
+        }
+
+        //! Copies data in - caller must check getFreeSpace() first (producer side, while locked)
+        void copyIn(const uint8_t* data, uint32_t len)
+        {
+            const uint32_t head = mHead.load(std::memory_order_relaxed);
+            const uint32_t pos = head & mMask;
+            uint32_t first = (mMask + 1) - pos;
+            if (first > len)
+            {
+                first = len;
+            }
+            memcpy(&mBuffer[pos], data, first);
+            memcpy(&mBuffer[0], data + first, len - first);
+
+            mHead.store(head + len, std::memory_order_release);
+        }
+
+        //! Counts dropped bytes (producer side, while locked)
+        inline void addDropped(uint32_t len)
+        {
+            // Only producers write this value, and they are serialized
+            mDroppedCount.store(
+                mDroppedCount.load(std::memory_order_relaxed) + len, std::memory_order_relaxed);
+        }
+
+        //! Appends part of a line (producer side, while locked)
+        //! @param[in] data  The text to append, which has no end of line before its last byte
+        //! @param[in] len  Number of bytes in data
+        //! @param[in] endsLine  true iff the last byte of data is an end of line
+        //! @returns true if the text was added or false if it was dropped
+        bool writeLineSegment(const uint8_t* data, uint32_t len, bool endsLine)
+        {
+            if (mDroppingLine)
+            {
+                // The start of this line was dropped, so the rest of it is too
+                mDroppingLine = !endsLine;
+                addDropped(len);
+                return false;
+            }
+
+            uint32_t needed = len;
+            if (!mLineOpen && !endsLine && needed < mLineReserve)
+            {
+                // Starting a line which is written in pieces
+                needed = mLineReserve;
+            }
+            if (!endsLine)
+            {
+                // Always leave room to terminate an open line
+                ++needed;
+            }
+
+            if (getFreeSpace() >= needed)
+            {
+                copyIn(data, len);
+                mLineOpen = !endsLine;
+                return true;
+            }
+
+            if (mLineOpen)
+            {
+                // This line outgrew the reserve - cut it short, but keep following lines whole
+                // (the room left for this is only gone if write() was used in the middle of a line)
+                if (getFreeSpace(true) > 0)
+                {
+                    const uint8_t eol = '\n';
+                    copyIn(&eol, 1);
+                }
+                mLineOpen = false;
+            }
+            mDroppingLine = !endsLine;
+            addDropped(len);
+            return false;
+        }
+
+    public:
+        //! Longest line, with its end of line, which may use the reserved space in writeLine()
+        static const uint32_t MAX_RESERVED_LINE_LEN = 64;
+
+    private:
+        //! The byte storage
+        uint8_t* const mBuffer;
+        //! Mask used to wrap indices into mBuffer
+        const uint32_t mMask;
+        //! Serializes producers
+        MutexInterface& mProducerMutex;
+        //! Number of free bytes needed to start a line in writeText()
+        const uint32_t mLineReserve;
+        //! Number of bytes only short lines given to writeLine() may use
+        const uint32_t mReservedSize;
+        //! End of line added by writeLine()
+        const uint8_t* const mLineEnd;
+        //! Number of bytes in mLineEnd
+        const uint32_t mLineEndLen;
+        //! Free-running write index (written by producers only)
+        std::atomic<uint32_t> mHead;
+        //! Free-running read index (written by consumer only)
+        std::atomic<uint32_t> mTail;
+        //! Number of bytes dropped because the buffer was full (written by producers only)
+        std::atomic<uint32_t> mDroppedCount;
+        //! true when writeText() has added the start of a line but not its end (producers only)
+        bool mLineOpen;
+        //! true when writeText() is dropping the rest of a line (producers only)
+        bool mDroppingLine;
+};
+
+#endif // __OUTPUT_RING_H__
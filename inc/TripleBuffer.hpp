@@ -0,0 +1,165 @@
+// MIT License
+//
+// Copyright (c) 2022-2025 James Smith of OrangeFox86
+// https://github.com/OrangeFox86/DreamcastControllerUsbPico
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef __TRIPLE_BUFFER_H__
+#define __TRIPLE_BUFFER_H__
+
+#include <stdint.h>
+#include <atomic>
+
+//! Lock-free handoff of whole values from a single writer context to a single reader context
+//!
+//! The writer fills a buffer which the reader is guaranteed not to be looking at, then publishes it
+//! with a single store. The reader always gets the most recently published value and never sees a
+//! partially written one. Only atomic loads and stores are used (no read-modify-write operations),
+//! so this works across RP2040 cores without spin locks and without masking interrupts.
+//!
+//! Each publish increments a generation number which lets the reader detect new data.
+template <typename T>
+class TripleBuffer
+{
+    public:
+        //! Constructor - all buffers default constructed; generation starts at 0
+        TripleBuffer() :
+            mBuffers(),
+            mLatest(0),
+            mReading(0),
+            mWriteIdx(INVALID_IDX),
+            mWriteGeneration(0),
+            mReadState(0)
+        {}
+
+        //! Constructor
+        //! @param[in] initialValue  The value to initialize all buffers to; generation starts at 0
+        TripleBuffer(const T& initialValue) :
+            mBuffers{initialValue, initialValue, initialValue},
+            mLatest(0),
+            mReading(0),
+            mWriteIdx(INVALID_IDX),
+            mWriteGeneration(0),
+            mReadState(0)
+        {}
+
+        //! Writer side: retrieves the buffer to fill before the next call to publish()
+        //! The buffer holds arbitrary previous data; callers must set all of it
+        //! @returns reference to the buffer to write to
+        T& getWriteBuffer()
+        {
+            if (mWriteIdx == INVALID_IDX)
+            {
+                const uint32_t latestIdx = mLatest.load() & IDX_MASK;
+                const uint32_t readingIdx = mReading.load();
+                mWriteIdx = 0;
+                while (mWriteIdx == latestIdx || mWriteIdx == readingIdx)
+                {
+                    ++mWriteIdx;
+                }
+            }
+            return mBuffers[mWriteIdx];
+        }
+
+        //! Writer side: makes the buffer retrieved from getWriteBuffer() available to the reader
+        void publish()
+        {
+            getWriteBuffer();
+            mWriteGeneration = (mWriteGeneration + 1) & (UINT32_MAX >> IDX_BITS);
+            mLatest.store((mWriteGeneration << IDX_BITS) | mWriteIdx);
+            mWriteIdx = INVALID_IDX;
+        }
+
+        //! Writer side: copies the given value into the write buffer and publishes it
+        //! @param[in] value  The value to publish
+        inline void write(const T& value)
+        {
+            getWriteBuffer() = value;
+            publish();
+        }
+
+        //! Reader side: checks for data published since the last call to read()
+        //! @returns true iff new data is available
+        inline bool isNewDataAvailable() const
+        {
+            return (mLatest.load() != mReadState);
+        }
+
+        //! Reader side: retrieves the most recently published value
+        //! @returns reference to the latest value which remains valid until the next call to read()
+        const T& read()
+        {
+            uint32_t latest = mLatest.load();
+            if (latest != mReadState)
+            {
+                // Claim the latest buffer then make sure it wasn't recycled by the writer in the
+                // meantime. The writer never selects the buffer which is currently latest, so this
+                // only loops when the writer published again between the two loads.
+                uint32_t check;
+                while (true)
+                {
+                    mReading.store(latest & IDX_MASK);
+                    check = mLatest.load();
+                    if (check == latest)
+                    {
+                        break;
+                    }
+                    latest = check;
+                }
+                mReadState = latest;
+            }
+            return mBuffers[mReadState & IDX_MASK];
+        }
+
+        //! Reader side: @returns the generation of the value last returned by read()
+        inline uint32_t getReadGeneration() const
+        {
+            return (mReadState >> IDX_BITS);
+        }
+
+        //! @returns the generation of the most recently published value
+        inline uint32_t getLatestGeneration() const
+        {
+            return (mLatest.load() >> IDX_BITS);
+        }
+
+    private:
+        //! Number of low bits in mLatest used for buffer index
+        static const uint32_t IDX_BITS = 2;
+        //! Mask for the buffer index in mLatest
+        static const uint32_t IDX_MASK = (1 << IDX_BITS) - 1;
+        //! Value of mWriteIdx when no write buffer is selected
+        static const uint32_t INVALID_IDX = 3;
+
+        //! The three buffers
+        T mBuffers[3];
+        //! Generation (upper bits) and index (lower bits) of the most recently published buffer
+        std::atomic<uint32_t> mLatest;
+        //! Index of the buffer claimed by the reader (written by reader only)
+        std::atomic<uint32_t> mReading;
+        //! Buffer selected by the writer or INVALID_IDX (writer only)
+        uint32_t mWriteIdx;
+        //! Generation of the last publish (writer only)
+        uint32_t mWriteGeneration;
+        //! Value of mLatest which the reader last claimed (reader only)
+        uint32_t mReadState;
+};
+
+#endif // __TRIPLE_BUFFER_H__
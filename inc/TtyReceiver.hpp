@@ -0,0 +1,404 @@
+// MIT License
+//
+// Copyright (c) 2022-2025 James Smith of OrangeFox86
+// https://github.com/OrangeFox86/DreamcastControllerUsbPico
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef __TTY_RECEIVER_H__
+#define __TTY_RECEIVER_H__
+
+#include <stdint.h>
+#include <stdio.h>
+#include "CommandRing.hpp"
+
+// Command structure: [whitespace]<command-char>[command]<\n>
+// The text command "#B" followed by a single EOL character switches the stream to binary frames:
+//   <length: 16-bit little endian><command-char>[data]
+// A binary frame with command-char '#' and no data switches the stream back to text
+
+//! Splits characters received on a TTY into commands, switching between text and binary framing
+//!
+//! This is the producer side of a CommandRing; the consumer takes complete commands with peek() and
+//! release(). Mode changes, session resets and dropped frame errors are generated here as frames so
+//! that the consumer sees them in order with all other commands. Frames with MODE_CHAR are never
+//! taken from the host, so they are always one of these generated frames:
+//!   MODE_CHAR                   - switched to binary (acknowledged to the host)
+//!   MODE_CHAR TEXT_MODE_CHAR    - switched back to text
+//!   MODE_CHAR RESET_CHAR        - the host closed the session
+//! Calls on the producer side must be serialized by the caller.
+class TtyReceiver
+{
+    public:
+        //! Function which writes characters out as is
+        typedef void (*WriteRawFn)(const uint8_t* data, uint32_t len);
+
+        //! Constructor
+        //! @param[in] writeRaw  Used to echo text back (called before the echoed command is committed)
+        TtyReceiver(WriteRawFn writeRaw) :
+            mRing(),
+            mWriteRaw(writeRaw),
+            mLastIsEol(false),
+            mLineLength(0),
+            mBinaryMode(false),
+            mFrameHeader(),
+            mFrameHeaderLen(0),
+            mFrameLength(0),
+            mFrameRemaining(0),
+            mFrameStart(0),
+            mDiscardFrame(false),
+            mDiscardCommand('\0'),
+            mOverflowDetected(false),
+            mResetPending(false)
+        {}
+
+        //! Adds received characters (producer side)
+        //! Characters received as text are echoed back, before any response to them may be written
+        void addChars(const char* chars, uint32_t len)
+        {
+            if (mResetPending)
+            {
+                // Try again now that the consumer may have made room
+                mResetPending = !pushControlFrame(RESET_CHAR);
+            }
+
+            // Only text which leads the given characters is echoed since the host isn't a terminal
+            // once it switches to binary
+            bool echo = true;
+            while (len > 0)
+            {
+                uint32_t count = 0;
+                if (mBinaryMode)
+                {
+                    count = addBinary(chars, len);
+                    echo = false;
+                }
+                else
+                {
+                    count = addText(chars, len, echo);
+                }
+                chars += count;
+                len -= count;
+            }
+        }
+
+        //! Ends the session, switching back to text mode and dropping any partially received frame
+        //! (producer side)
+        void resetMode()
+        {
+            if (mBinaryMode)
+            {
+                if (mFrameHeaderLen == FRAME_LENGTH_SIZE && !mDiscardFrame)
+                {
+                    // Drop the partially received frame
+                    mRing.setTail(mFrameStart);
+                }
+
+                mBinaryMode = false;
+                mFrameHeaderLen = 0;
+                mDiscardFrame = false;
+                mLastIsEol = false;
+                mLineLength = 0;
+            }
+
+            mResetPending = !pushControlFrame(RESET_CHAR);
+        }
+
+        //! @returns true when the stream is in binary mode (producer side)
+        inline bool isBinaryMode() const
+        {
+            return mBinaryMode;
+        }
+
+        //! Gets the next complete command without releasing it (consumer side)
+        //! @param[out] item  Set to the next command
+        //! @param[out] chars  Set to the contiguous characters of the command, valid until release()
+        //! @returns false if there is no complete command available
+        inline bool peek(CommandRing::Item& item, const char*& chars)
+        {
+            return mRing.peek(item, chars);
+        }
+
+        //! Releases the command last returned by peek() (consumer side)
+        inline void release()
+        {
+            mRing.release();
+        }
+
+    private:
+        //! Adds characters while in text mode
+        //! @param[in] echo  true to echo back the characters
+        //! @returns the number of characters consumed, which is less than len if mode switched
+        uint32_t addText(const char* chars, uint32_t len, bool echo)
+        {
+            // Echo back (no crlf processing since calling directly) - each command is echoed before
+            // it is made available to the consumer so that the echo always comes before its response
+            const char* echoChars = chars;
+
+            for (uint32_t i = 0; i < len; ++i, ++chars)
+            {
+                const char c = *chars;
+                const bool isEol = (c == '\r' || c == '\n');
+
+                if (mOverflowDetected)
+                {
+                    if (isEol)
+                    {
+                        printf("Error: Command input overflow %lu\n",
+                               (long unsigned int)mRing.getUsedSpace());
+                        // Remove only command that overflowed; anything before it is complete
+                        mRing.setTail(mRing.getTail() - mLineLength);
+                        mLineLength = 0;
+                        mOverflowDetected = false;
+                    }
+                    else
+                    {
+                        mLastIsEol = false;
+                    }
+                }
+                else if (c == '\x08' || c == '\x7F')
+                {
+                    // Can't backspace before the start of this line
+                    if (mLineLength > 0)
+                    {
+                        // Backspace
+                        mRing.setTail(mRing.getTail() - 1);
+                        --mLineLength;
+                    }
+                }
+                else if (isEol)
+                {
+                    if (!mLastIsEol)
+                    {
+                        const uint32_t lineStart = mRing.getTail() - mLineLength;
+                        const bool isModeCommand = (mLineLength == 2
+                                                    && mRing.at(lineStart) == MODE_CHAR
+                                                    && mRing.at(lineStart + 1) == BINARY_MODE_CHAR);
+
+                        if (echo)
+                        {
+                            mWriteRaw(reinterpret_cast<const uint8_t*>(echoChars),
+                                      chars + 1 - echoChars);
+                            echoChars = chars + 1;
+                        }
+
+                        if (isModeCommand)
+                        {
+                            // Switch now so the characters which follow this one are taken as binary
+                            mRing.setTail(lineStart);
+                            mLineLength = 0;
+                            mBinaryMode = true;
+                            mFrameHeaderLen = 0;
+                            // Acknowledged in order with all other responses
+                            pushFrame(MODE_CHAR, nullptr, 0);
+                            return i + 1;
+                        }
+
+                        if (mLineLength > 0)
+                        {
+                            if (mRing.isItemSpaceAvailable())
+                            {
+                                // Room for the terminator is always left when adding characters
+                                mRing.push('\0');
+                                mRing.commit(lineStart, mLineLength, false);
+                            }
+                            else
+                            {
+                                printf("Error: Command input overflow %lu\n",
+                                       (long unsigned int)mRing.getUsedSpace());
+                                mRing.setTail(lineStart);
+                            }
+                        }
+
+                        mLastIsEol = true;
+                        mLineLength = 0;
+                    }
+                }
+                else if (mRing.getFreeSpace() <= 1)
+                {
+                    // Flag overflow - this command will be ignored
+                    mOverflowDetected = true;
+                    mLastIsEol = false;
+                }
+                else
+                {
+                    mRing.push(c);
+                    mLastIsEol = false;
+                    ++mLineLength;
+                }
+            }
+
+            if (echo && chars > echoChars)
+            {
+                mWriteRaw(reinterpret_cast<const uint8_t*>(echoChars), chars - echoChars);
+            }
+
+            return len;
+        }
+
+        //! Adds characters while in binary mode
+        //! @returns the number of characters consumed, which is less than len if mode switched
+        uint32_t addBinary(const char* chars, uint32_t len)
+        {
+            uint32_t i = 0;
+            while (i < len && mBinaryMode)
+            {
+                if (mFrameHeaderLen < FRAME_LENGTH_SIZE)
+                {
+                    mFrameHeader[mFrameHeaderLen++] = chars[i++];
+                    if (mFrameHeaderLen == FRAME_LENGTH_SIZE)
+                    {
+                        mFrameLength = mFrameHeader[0] | (mFrameHeader[1] << 8);
+                        mFrameRemaining = mFrameLength;
+                        mFrameStart = mRing.getTail();
+                        // Space only grows while the frame is received, so this is checked just once
+                        mDiscardFrame = (mFrameLength > mRing.getFreeSpace()
+                                         || !mRing.isItemSpaceAvailable());
+
+                        if (mFrameLength == 0)
+                        {
+                            // Empty frame - nothing to do
+                            mFrameHeaderLen = 0;
+                        }
+                    }
+                }
+                else
+                {
+                    // Whole chunks are copied without looking at each character
+                    uint32_t count = len - i;
+                    if (count > mFrameRemaining)
+                    {
+                        count = mFrameRemaining;
+                    }
+
+                    if (mDiscardFrame)
+                    {
+                        if (mFrameRemaining == mFrameLength)
+                        {
+                            mDiscardCommand = chars[i];
+                        }
+                    }
+                    else
+                    {
+                        mRing.push(chars + i, count);
+                    }
+
+                    i += count;
+                    mFrameRemaining -= count;
+
+                    if (mFrameRemaining == 0)
+                    {
+                        mFrameHeaderLen = 0;
+
+                        if (mDiscardFrame)
+                        {
+                            // Let the host know which command was dropped
+                            mDiscardFrame = false;
+                            pushFrame(BINARY_ERROR_CHAR, &mDiscardCommand, 1);
+                        }
+                        else if (mRing.at(mFrameStart) == MODE_CHAR)
+                        {
+                            // Switch now so the characters which follow this frame are taken as text
+                            mRing.setTail(mFrameStart);
+                            mBinaryMode = false;
+                            mLastIsEol = false;
+                            mLineLength = 0;
+                            pushControlFrame(TEXT_MODE_CHAR);
+                        }
+                        else
+                        {
+                            mRing.commit(mFrameStart, mFrameLength, true);
+                        }
+                    }
+                }
+            }
+
+            return i;
+        }
+
+        //! Pushes a complete binary frame which is generated on receive
+        //! @returns false if there was nowhere to put it
+        bool pushFrame(char command, const char* data, uint32_t len)
+        {
+            if (mRing.getFreeSpace() < len + 1 || !mRing.isItemSpaceAvailable())
+            {
+                // Nowhere to put it
+                return false;
+            }
+
+            uint32_t start = mRing.getTail();
+            mRing.push(command);
+            mRing.push(data, len);
+            mRing.commit(start, len + 1, true);
+            return true;
+        }
+
+        //! Pushes a MODE_CHAR frame which tells the consumer about a change to the session
+        //! @returns false if there was nowhere to put it
+        bool pushControlFrame(char control)
+        {
+            return pushFrame(MODE_CHAR, &control, 1);
+        }
+
+    public:
+        //! The character which leads mode switch commands and frames
+        static const char MODE_CHAR = '#';
+        //! The character which follows MODE_CHAR in the text command which switches to binary mode
+        static const char BINARY_MODE_CHAR = 'B';
+        //! The command character of binary error frames
+        static const char BINARY_ERROR_CHAR = '!';
+        //! Data of the MODE_CHAR frame generated when switched back to text
+        static const char TEXT_MODE_CHAR = 'T';
+        //! Data of the MODE_CHAR frame generated when the session is reset
+        static const char RESET_CHAR = 'R';
+        //! Number of bytes in the length field of a binary frame
+        static const uint32_t FRAME_LENGTH_SIZE = 2;
+
+    private:
+        //! Received commands
+        CommandRing mRing;
+        //! Writes echoed characters
+        const WriteRawFn mWriteRaw;
+        //! Flag that is set to true if the last read character is an EOL (used to ignore further EOL)
+        bool mLastIsEol;
+        //! Number of characters in the text line currently being received
+        uint32_t mLineLength;
+        //! true when the stream is in binary mode
+        bool mBinaryMode;
+        //! Length bytes received for the binary frame currently being received
+        uint8_t mFrameHeader[FRAME_LENGTH_SIZE];
+        //! Number of bytes in mFrameHeader
+        uint32_t mFrameHeaderLen;
+        //! Length of the binary frame currently being received
+        uint32_t mFrameLength;
+        //! Number of bytes left to receive in the binary frame currently being received
+        uint32_t mFrameRemaining;
+        //! Position of the binary frame currently being received
+        uint32_t mFrameStart;
+        //! true when the binary frame currently being received didn't fit and is dropped
+        bool mDiscardFrame;
+        //! Command character of the frame being dropped
+        char mDiscardCommand;
+        //! true when overflow in mRing
+        bool mOverflowDetected;
+        //! true when the session was reset but there was no room to let the consumer know yet
+        bool mResetPending;
+};
+
+#endif // __TTY_RECEIVER_H__
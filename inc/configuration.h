@@ -25,12 +25,39 @@
 #define __CONFIGURATION_H__
 
 // true to setup and print debug messages over UART0 (pin 1, 115200 8N1)
-// Warning: enabling debug messages drastically degrades communication performance
+// Warning: when DEFERRED_DEBUG_MESSAGES is false, enabling debug messages drastically degrades
+//          communication performance
 #define SHOW_DEBUG_MESSAGES false
 
+// true to defer debug messages: each message is stored as a format string address plus raw
+// arguments and later sent as binary over UART0 by the first core during idle time
+// Use scripts/decode_log.py along with the built ELF file to convert the output back to text
+// false to print formatted text inline (blocking)
+#define DEFERRED_DEBUG_MESSAGES true
+
+// Number of 32-bit words reserved for deferred debug messages (must be a power of 2)
+#define DEFERRED_LOG_BUFFER_WORDS 1024
+
+// true to count heap usage through global operator new/delete (see HeapStats.hpp)
+// This adds 8 bytes of overhead to each allocation; it is always enabled in the unit test build
+// Enable with cmake -DHEAP_STATS_ENABLED=ON, which also sets PICO_CXX_DISABLE_ALLOCATION_OVERRIDES so
+// the SDK doesn't define its own new/delete
+#ifndef HEAP_STATS_ENABLED
+#define HEAP_STATS_ENABLED false
+#endif
+
 // true to enable USB CDC (serial) interface to directly control the maple bus
 #define USB_CDC_ENABLED true
 
+// true to enable USB vendor (bulk) interface which carries length-prefixed binary maple bus frames
+// (Windows binds WinUSB to it automatically through the MS OS 2.0 descriptors)
+#define USB_VENDOR_ENABLED true
+
+// true to present all players through a single HID interface: each report carries the state of every
+// player along with a bitmap of the players which changed, so the host reads all players at once
+// false to present one HID gamepad interface per player
+#define USB_COMPOSITE_GAMEPAD_REPORT false
+
 // Adjust the CPU clock frequency here (133 MHz is maximum documented stable frequency)
 #define CPU_FREQ_KHZ 133000
 
@@ -55,6 +82,14 @@
 // 1750 was selected based on the average time it takes a Dreamcast controller to transmit each bit
 #define MAPLE_RESPONSE_NS_PER_BIT 1750
 
+// Empty ports are probed every 2 ms for 250 ms after boot, disconnect or any line activity; after that,
+// the probe interval starts at 16 ms and doubles up to this ceiling (16000 keeps a fixed 16 ms interval)
+#define EMPTY_PORT_PROBE_MAX_INTERVAL_US 250000
+
+// When controller polls are aligned to USB start of frame, each condition is scheduled to be received
+// this many microseconds before the next frame begins (time for the report to reach the HID endpoint)
+#define USB_FRAME_ALIGNMENT_MARGIN_US 150
+
 // Maximum amount of time in microseconds to pass in between received words before read is canceled
 // Dreamcast controllers sometimes have a ~180 us gap between words, so 300 us accommodates for that
 #define MAPLE_INTER_WORD_READ_TIMEOUT_US 300
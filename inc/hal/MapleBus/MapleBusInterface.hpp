@@ -84,11 +84,16 @@ class MapleBusInterface
             const uint32_t* readBuffer;
             //! The number of words received or 0 if no new data available
             uint32_t readBufferLen;
+            //! When phase is READ_COMPLETE, the time at which the end of the response was received or
+            //! 0 if unknown
+            uint64_t readCompleteTimeUs;
 
             Status() :
                 phase(Phase::INVALID),
+                failureReason(FailureReason::NONE),
                 readBuffer(nullptr),
-                readBufferLen(0)
+                readBufferLen(0),
+                readCompleteTimeUs(0)
             {}
         };
 
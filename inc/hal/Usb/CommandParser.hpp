@@ -30,6 +30,21 @@
 #include "hal/System/MutexInterface.hpp"
 
 // Command structure: [whitespace]<command-char>[command]<\n>
+// Binary command structure: <length: 16-bit little endian><command-char>[data]
+//   where length is the number of bytes which follow it (command-char and data)
+
+//! Destination of binary response frames
+class BinaryOutput
+{
+public:
+    virtual ~BinaryOutput() {}
+
+    //! Writes a complete binary frame
+    //! @param[in] command  The command character of the frame
+    //! @param[in] data  The frame data
+    //! @param[in] len  Number of bytes in data
+    virtual void writeFrame(char command, const uint8_t* data, uint32_t len) = 0;
+};
 
 //! Command parser for processing commands from a TTY stream
 class CommandParser
@@ -43,6 +58,28 @@ public:
     //! Called when newline reached; submit command and reset
     virtual void submit(const char* chars, uint32_t len) = 0;
 
+    //! Called when a complete binary frame is received with one of my command characters
+    //! @param[in] command  The command character of the frame
+    //! @param[in] data  The frame data (command character removed)
+    //! @param[in] len  Number of bytes in data
+    //! @param[in] output  Where binary responses are to be written (now or later)
+    //! @returns false if binary commanding isn't supported by this parser
+    virtual bool submitBinary(char command, const uint8_t* data, uint32_t len, BinaryOutput& output)
+    {
+        return false;
+    }
+
+    //! Called when the stream switches between text and binary, in order with submitted commands
+    //! @param[in] output  Where anything written outside of a response is to be framed, or nullptr
+    //!                    once the stream is back to text
+    virtual void setBinaryOutput(BinaryOutput* output)
+    {}
+
+    //! Called when the host closes the stream, in order with submitted commands (the next session
+    //! starts in text mode)
+    virtual void sessionReset()
+    {}
+
     //! Prints help message for this command
     virtual void printHelp() = 0;
 };
@@ -26,6 +26,7 @@
 
 #include <stdint.h>
 #include "dreamcast_structures.h"
+#include "LatencyHistogram.hpp"
 
 //! This interface is used to decouple the USB functionality in HAL from the Dreamcast functionality
 class DreamcastControllerObserver
@@ -36,7 +37,10 @@ class DreamcastControllerObserver
 
         //! Sets the current Dreamcast controller condition
         //! @param[in] controllerCondition  The current condition of the Dreamcast controller
-        virtual void setControllerCondition(const ControllerCondition& controllerCondition) = 0;
+        //! @param[in] receivedTimeUs  The time at which the condition was received from the Maple
+        //!                            Bus or 0 if unknown
+        virtual void setControllerCondition(const ControllerCondition& controllerCondition,
+                                            uint64_t receivedTimeUs) = 0;
 
         //! Sets the current Dreamcast secondary controller condition
         //! @param[in] secondaryControllerCondition  The current secondary condition of the
@@ -49,6 +53,10 @@ class DreamcastControllerObserver
 
         //! Called when controller disconnected
         virtual void controllerDisconnected() = 0;
+
+        //! @returns the histogram of latencies from condition received to report delivered to the
+        //!          USB host or nullptr if not measured
+        virtual LatencyHistogram* getInputLatencyHistogram() { return nullptr; }
 };
 
 #endif // __DREAMCAST_CONTROLLER_OBSERVER_H__
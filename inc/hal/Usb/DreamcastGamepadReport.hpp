@@ -0,0 +1,198 @@
+// MIT License
+//
+// Copyright (c) 2022-2025 James Smith of OrangeFox86
+// https://github.com/OrangeFox86/DreamcastControllerUsbPico
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef __DREAMCAST_GAMEPAD_REPORT_H__
+#define __DREAMCAST_GAMEPAD_REPORT_H__
+
+#include <stdint.h>
+#include <string.h>
+#include "dreamcast_structures.h"
+
+typedef struct __attribute__((packed))
+{
+  int8_t  x;         ///< Delta x  movement of left analog-stick
+  int8_t  y;         ///< Delta y  movement of left analog-stick
+  int8_t  z;         ///< Delta z  movement of right analog-joystick
+  int8_t  rz;        ///< Delta Rz movement of right analog-joystick
+  int8_t  rx;        ///< Delta Rx movement of analog left trigger
+  int8_t  ry;        ///< Delta Ry movement of analog right trigger
+  uint8_t hat;       ///< Buttons mask for currently pressed buttons in the DPad/hat
+  uint32_t buttons;  ///< Buttons mask for currently pressed buttons
+  uint8_t pad;       ///< Vendor data (padding)
+}hid_dc_gamepad_report_t;
+
+//! Converts Dreamcast controller conditions into gamepad HID reports in a single table driven pass
+//!
+//! The 8-byte condition is read as 2 little endian words:
+//!   word 0: l trigger, r trigger, then 16 active low digital bits (z y x d upb downb leftb rightb
+//!           c b a start up down left right)
+//!   word 1: rAnalogUD, rAnalogLR, lAnalogUD, lAnalogLR
+//! Each nibble of pressed digital bits indexes a table of HID buttons, and the d-pad nibble indexes
+//! a table of hat values, so no bit is handled individually.
+class DreamcastGamepadReportBuilder
+{
+    public:
+        //! HID hat switch values (same as GAMEPAD_HAT_* in TinyUSB)
+        enum Hat : uint8_t
+        {
+            HAT_CENTERED = 0,
+            HAT_UP,
+            HAT_UP_RIGHT,
+            HAT_RIGHT,
+            HAT_DOWN_RIGHT,
+            HAT_DOWN,
+            HAT_DOWN_LEFT,
+            HAT_LEFT,
+            HAT_UP_LEFT
+        };
+
+        //! Constructor
+        DreamcastGamepadReportBuilder() :
+            mConditionWords{0, 0},
+            mValid(false),
+            mReport(),
+            mDpadMask(0)
+        {}
+
+        //! Rebuilds the report from the given condition unless it is the same as the last one
+        //! @param[in] condition  The current condition of the Dreamcast controller
+        //! @returns true iff the condition changed and the report was rebuilt
+        inline bool setCondition(const controller_condition_t& condition)
+        {
+            uint32_t words[2];
+            memcpy(words, &condition, sizeof(words));
+            if (mValid && words[0] == mConditionWords[0] && words[1] == mConditionWords[1])
+            {
+                return false;
+            }
+
+            mConditionWords[0] = words[0];
+            mConditionWords[1] = words[1];
+            mValid = true;
+            build(words, mReport, mDpadMask);
+            return true;
+        }
+
+        //! Forces the next call to setCondition() to rebuild the report
+        inline void reset()
+        {
+            mValid = false;
+        }
+
+        //! @returns the report built from the last condition (pad is left 0)
+        inline const hid_dc_gamepad_report_t& getReport() const
+        {
+            return mReport;
+        }
+
+        //! @returns the pressed d-pad buttons of the last condition (bit 0: up, 1: down, 2: left,
+        //!          3: right)
+        inline uint8_t getDpadMask() const
+        {
+            return mDpadMask;
+        }
+
+        //! Builds a report from a condition
+        //! @param[in] words  The condition as 2 little endian words
+        //! @param[out] report  The report to write (pad is left unchanged)
+        //! @param[out] dpadMask  The pressed d-pad buttons (bit 0: up, 1: down, 2: left, 3: right)
+        static inline void build(const uint32_t words[2],
+                                 hid_dc_gamepad_report_t& report,
+                                 uint8_t& dpadMask)
+        {
+            const uint32_t pressed = (~words[0] >> 16) & 0xFFFF;
+            report.buttons = toButtons(pressed);
+            dpadMask = pressed >> 12;
+            report.hat = toHat(dpadMask);
+            report.z = toAxis(words[0]);
+            report.rz = toAxis(words[0] >> 8);
+            report.ry = toAxis(words[1]);
+            report.rx = toAxis(words[1] >> 8);
+            report.y = toAxis(words[1] >> 16);
+            report.x = toAxis(words[1] >> 24);
+        }
+
+        //! @param[in] dpadMask  The pressed d-pad buttons (bit 0: up, 1: down, 2: left, 3: right)
+        //! @returns the hat value; up and down take priority over left and right when opposing
+        static inline uint8_t toHat(uint8_t dpadMask)
+        {
+            //! Hat value for each combination of pressed up, down, left, right
+            static const uint8_t DPAD_TO_HAT[16] = {
+                HAT_CENTERED, HAT_UP, HAT_DOWN, HAT_UP,
+                HAT_LEFT, HAT_UP_LEFT, HAT_DOWN_LEFT, HAT_UP_LEFT,
+                HAT_RIGHT, HAT_UP_RIGHT, HAT_DOWN_RIGHT, HAT_UP_RIGHT,
+                HAT_LEFT, HAT_UP_LEFT, HAT_DOWN_LEFT, HAT_UP_LEFT
+            };
+            return DPAD_TO_HAT[dpadMask & 0x0F];
+        }
+
+        //! @param[in] pressed  Pressed digital bits of the condition (bit 0: z ... bit 11: start)
+        //! @returns the HID buttons mask for the non d-pad digital bits
+        static inline uint32_t toButtons(uint32_t pressed)
+        {
+            //! HID buttons for pressed z, y, x, d (buttons 5, 4, 3, 10)
+            static const uint16_t BUTTONS_0_TO_3[16] = {
+                0x000, 0x020, 0x010, 0x030, 0x008, 0x028, 0x018, 0x038,
+                0x400, 0x420, 0x410, 0x430, 0x408, 0x428, 0x418, 0x438
+            };
+            //! HID buttons for pressed upb, downb, leftb, rightb (buttons 9, 8, 7, 6)
+            static const uint16_t BUTTONS_4_TO_7[16] = {
+                0x000, 0x200, 0x100, 0x300, 0x080, 0x280, 0x180, 0x380,
+                0x040, 0x240, 0x140, 0x340, 0x0C0, 0x2C0, 0x1C0, 0x3C0
+            };
+            //! HID buttons for pressed c, b, a, start (buttons 2, 1, 0, 11)
+            static const uint16_t BUTTONS_8_TO_11[16] = {
+                0x000, 0x004, 0x002, 0x006, 0x001, 0x005, 0x003, 0x007,
+                0x800, 0x804, 0x802, 0x806, 0x801, 0x805, 0x803, 0x807
+            };
+            return BUTTONS_0_TO_3[pressed & 0x0F]
+                   | BUTTONS_4_TO_7[(pressed >> 4) & 0x0F]
+                   | BUTTONS_8_TO_11[(pressed >> 8) & 0x0F];
+        }
+
+        //! @param[in] value  Dreamcast axis value in the low byte (0 to 255; 128 neutral)
+        //! @returns the HID axis value (-127 to 127)
+        static inline int8_t toAxis(uint32_t value)
+        {
+            int8_t axis = static_cast<int8_t>((value & 0xFF) ^ 0x80);
+            // -128 is outside of the logical range of the report descriptor
+            return axis + (axis == -128);
+        }
+
+    public:
+        //! Mask of the HID buttons which are set from the condition (all others are left to the
+        //! secondary condition)
+        static const uint32_t CONDITION_BUTTON_MASK = 0x00000FFF;
+
+    private:
+        //! The last condition passed to setCondition()
+        uint32_t mConditionWords[2];
+        //! False until the first condition or after reset()
+        bool mValid;
+        //! The report built from the last condition
+        hid_dc_gamepad_report_t mReport;
+        //! The pressed d-pad buttons of the last condition
+        uint8_t mDpadMask;
+};
+
+#endif // __DREAMCAST_GAMEPAD_REPORT_H__
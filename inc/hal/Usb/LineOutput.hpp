@@ -0,0 +1,49 @@
+// MIT License
+//
+// Copyright (c) 2022-2025 James Smith of OrangeFox86
+// https://github.com/OrangeFox86/DreamcastControllerUsbPico
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <stdint.h>
+
+//! Destination of whole text lines which never waits on the host
+class LineOutput
+{
+public:
+    //! Virtual destructor
+    virtual ~LineOutput() {}
+
+    //! Writes a whole line, or none of it if there isn't room right now
+    //! @param[in] text  The text of the line (the output adds its own end of line)
+    //! @param[in] len  Number of characters in text
+    //! @returns false if the line was dropped
+    virtual bool writeLine(const char* text, uint32_t len) = 0;
+
+    //! @returns the length of the longest line which may ever be written (without end of line)
+    virtual uint32_t getMaxLineLength() const = 0;
+
+    //! @returns the total number of bytes dropped because there wasn't room
+    virtual uint32_t getDroppedCount() const = 0;
+};
+
+//! @returns the output of whole lines to the CDC interface (usable before USB is initialized)
+LineOutput* usb_cdc_get_line_output();
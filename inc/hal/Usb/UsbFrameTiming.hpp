@@ -0,0 +1,122 @@
+// MIT License
+//
+// Copyright (c) 2022-2025 James Smith of OrangeFox86
+// https://github.com/OrangeFox86/DreamcastControllerUsbPico
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef __USB_FRAME_TIMING_H__
+#define __USB_FRAME_TIMING_H__
+
+#include <stdint.h>
+#include <atomic>
+
+//! Tracks the phase of the USB start of frame (SOF) relative to the local microsecond clock
+//!
+//! startOfFrame() is called from the USB context on every SOF, and getPhaseUs() may be called from
+//! any other context. Start of frame notifications are delayed by a varying amount of processing,
+//! so the earliest observation is taken as the truth. The estimate slowly relaxes later so that it
+//! follows drift between the host's clock and the local clock.
+class UsbFrameTiming
+{
+    public:
+        //! Constructor
+        UsbFrameTiming() :
+            mPhaseUs(0),
+            mLastFrameTimeUs(0),
+            mValid(false)
+        {}
+
+        //! Called from the USB context on every start of frame
+        //! @param[in] timeUs  The time at which the start of frame was observed
+        void startOfFrame(uint64_t timeUs)
+        {
+            uint32_t observedPhaseUs = timeUs % FRAME_PERIOD_US;
+            uint32_t phaseUs = observedPhaseUs;
+            if (mValid)
+            {
+                phaseUs = mPhaseUs;
+                int32_t deltaUs = phaseDelta(observedPhaseUs, phaseUs);
+                if (deltaUs < 0)
+                {
+                    // Observed with less latency than before
+                    phaseUs = observedPhaseUs;
+                }
+                else if (deltaUs > 0)
+                {
+                    phaseUs = (phaseUs + RELAX_US_PER_FRAME) % FRAME_PERIOD_US;
+                }
+            }
+            mPhaseUs = phaseUs;
+            mLastFrameTimeUs = static_cast<uint32_t>(timeUs);
+            mValid = true;
+        }
+
+        //! @param[in] currentTimeUs  The current time
+        //! @param[out] phaseUs  Set to the time of start of frame modulo FRAME_PERIOD_US
+        //! @returns true iff start of frame is currently being received
+        bool getPhaseUs(uint64_t currentTimeUs, uint32_t& phaseUs) const
+        {
+            // The signed age covers a frame observed after currentTimeUs was sampled
+            int32_t ageUs = static_cast<int32_t>(static_cast<uint32_t>(currentTimeUs) - mLastFrameTimeUs);
+            if (!mValid || ageUs > static_cast<int32_t>(STALE_US))
+            {
+                return false;
+            }
+
+            phaseUs = mPhaseUs;
+            return true;
+        }
+
+        //! @param[in] a  A phase in [0, FRAME_PERIOD_US)
+        //! @param[in] b  A phase in [0, FRAME_PERIOD_US)
+        //! @returns a - b wrapped to [-FRAME_PERIOD_US / 2, FRAME_PERIOD_US / 2)
+        static int32_t phaseDelta(uint32_t a, uint32_t b)
+        {
+            int32_t deltaUs = static_cast<int32_t>(a) - static_cast<int32_t>(b);
+            if (deltaUs >= static_cast<int32_t>(FRAME_PERIOD_US / 2))
+            {
+                deltaUs -= FRAME_PERIOD_US;
+            }
+            else if (deltaUs < -static_cast<int32_t>(FRAME_PERIOD_US / 2))
+            {
+                deltaUs += FRAME_PERIOD_US;
+            }
+            return deltaUs;
+        }
+
+    public:
+        //! Full speed USB frame period
+        static const uint32_t FRAME_PERIOD_US = 1000;
+        //! Start of frame is considered lost after this much time without one (ex: suspended)
+        static const uint32_t STALE_US = 10000;
+        //! Amount the estimate moves later on each frame observed later than the estimate (must be
+        //! larger than the worst case clock drift per frame)
+        static const uint32_t RELAX_US_PER_FRAME = 1;
+
+    private:
+        //! Estimated time of start of frame modulo FRAME_PERIOD_US
+        std::atomic<uint32_t> mPhaseUs;
+        //! Lower 32 bits of the time the last start of frame was observed
+        std::atomic<uint32_t> mLastFrameTimeUs;
+        //! Set once the first start of frame is observed
+        std::atomic<bool> mValid;
+};
+
+#endif // __USB_FRAME_TIMING_H__
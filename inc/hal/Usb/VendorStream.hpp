@@ -0,0 +1,64 @@
+// MIT License
+//
+// Copyright (c) 2022-2025 James Smith of OrangeFox86
+// https://github.com/OrangeFox86/DreamcastControllerUsbPico
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <stdint.h>
+#include <memory>
+#include "hal/System/MutexInterface.hpp"
+
+// Frame structure (both directions): <length: 16-bit little endian><length bytes of data>
+
+class VendorStream;
+
+//! Handles binary requests received over the USB vendor interface
+class VendorRequestHandler
+{
+public:
+    //! Virtual destructor
+    virtual ~VendorRequestHandler() {}
+    //! Called from the process handling maple bus execution for each complete request
+    //! @param[in] data  The request data (length prefix removed)
+    //! @param[in] len  Number of bytes in data
+    //! @param[in] stream  The stream to send responses to
+    virtual void handleRequest(const uint8_t* data, uint32_t len, VendorStream& stream) = 0;
+};
+
+//! Length-prefixed binary frames over a USB vendor bulk interface
+class VendorStream
+{
+public:
+    //! Virtual destructor
+    virtual ~VendorStream() {}
+    //! Sets the request handler - must be done before any other function called
+    virtual void setRequestHandler(std::shared_ptr<VendorRequestHandler> handler) = 0;
+    //! Queues a response frame to be sent to the host (length prefix is added)
+    //! @param[in] data  The response data
+    //! @param[in] len  Number of bytes in data
+    //! @returns false if the response didn't fit in the output queue and was dropped
+    virtual bool sendResponse(const uint8_t* data, uint32_t len) = 0;
+    //! Called from the process handling maple bus execution
+    virtual void process() = 0;
+};
+
+VendorStream* usb_vendor_create_stream(MutexInterface* m);
@@ -26,4 +26,6 @@
 extern "C" {
 void set_usb_descriptor_number_of_gamepads(uint8_t num);
 uint8_t get_usb_descriptor_number_of_gamepads();
+void set_usb_descriptor_composite_gamepad(bool composite);
+bool get_usb_descriptor_composite_gamepad();
 }
\ No newline at end of file
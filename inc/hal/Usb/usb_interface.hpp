@@ -26,6 +26,7 @@
 
 #include "UsbFileSystem.hpp"
 #include "DreamcastControllerObserver.hpp"
+#include "UsbFrameTiming.hpp"
 #include "hal/System/MutexInterface.hpp"
 #include <vector>
 
@@ -43,5 +44,8 @@ uint32_t get_num_usb_controllers();
 //! Must return the file system
 UsbFileSystem& usb_msc_get_file_system();
 
+//! @returns the USB start of frame timing, updated from usb_task()
+const UsbFrameTiming& usb_get_frame_timing();
+
 
 #endif // __USB_INTERFACE_H__
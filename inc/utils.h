@@ -34,8 +34,14 @@
 #define INT_DIVIDE_FLOOR(x,y) ((x)/(y))
 
 #if SHOW_DEBUG_MESSAGES && !defined(UNITTEST)
-    #include <stdio.h>
-    #define DEBUG_PRINT(...) printf (__VA_ARGS__)
+    #if DEFERRED_DEBUG_MESSAGES
+        // Note: all arguments must be integers or pointers to strings in static memory
+        #include "DeferredLog.hpp"
+        #define DEBUG_PRINT(...) get_deferred_log().print (__VA_ARGS__)
+    #else
+        #include <stdio.h>
+        #define DEBUG_PRINT(...) printf (__VA_ARGS__)
+    #endif
 #else
     #define DEBUG_PRINT(...)
 #endif
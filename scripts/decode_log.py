@@ -0,0 +1,134 @@
+#!/usr/bin/env python3
+
+# MIT License
+#
+# Copyright (c) 2022-2025 James Smith & Mike Kosek of OrangeFox86
+# https://github.com/OrangeFox86/DreamcastControllerUsbPico
+
+# Decodes the binary output of deferred debug messages (see DEFERRED_DEBUG_MESSAGES in
+# inc/configuration.h) back into text. Format strings and %s arguments are looked up by address in
+# the ELF file which was flashed to the device.
+
+import sys
+import re
+import struct
+import argparse
+from elftools.elf.elffile import ELFFile
+
+SYNC_BYTE = 0xA5
+MAX_ARGS = 6
+HEADER_SIZE = 6
+
+# Matches a single printf conversion specification
+FORMAT_SPEC_RE = re.compile(r'%([-+ #0]*)(\d*)(?:\.(\d+))?(hh|h|ll|l|z|j|t)?([diouxXcsp%])')
+
+class StringTable:
+    def __init__(self, elf_path):
+        self.segments = []
+        self.cache = {}
+        with open(elf_path, 'rb') as f:
+            elf = ELFFile(f)
+            for section in elf.iter_sections():
+                addr = section['sh_addr']
+                if addr != 0 and section['sh_type'] == 'SHT_PROGBITS':
+                    self.segments.append((addr, section.data()))
+
+    def lookup(self, addr):
+        if addr in self.cache:
+            return self.cache[addr]
+        result = None
+        for start, data in self.segments:
+            if start <= addr < start + len(data):
+                offset = addr - start
+                end = data.find(b'\0', offset)
+                if end < 0:
+                    end = len(data)
+                result = data[offset:end].decode('utf-8', errors='replace')
+                break
+        self.cache[addr] = result
+        return result
+
+def format_record(strings, fmt_addr, args):
+    if fmt_addr == 0:
+        return f'<{args[0] if args else "?"} message(s) dropped>\n'
+
+    fmt = strings.lookup(fmt_addr)
+    if fmt is None:
+        return f'<unknown format 0x{fmt_addr:08X} {" ".join(f"0x{a:08X}" for a in args)}>\n'
+
+    arg_iter = iter(args)
+
+    def replace(match):
+        flags, width, precision, _, conversion = match.groups()
+        if conversion == '%':
+            return '%'
+        value = next(arg_iter, 0)
+        if conversion == 's':
+            text = strings.lookup(value)
+            return ('%' + flags + width + 's') % (text if text is not None else f'<0x{value:08X}>')
+        if conversion in 'di' and value & 0x80000000:
+            value -= 0x100000000
+        if conversion == 'u':
+            conversion = 'd'
+        elif conversion == 'p':
+            conversion = 'x'
+            flags += '#'
+        spec = '%' + flags + width + (('.' + precision) if precision else '') + conversion
+        return spec % value
+
+    return FORMAT_SPEC_RE.sub(replace, fmt)
+
+def decode_stream(stream, strings, out):
+    buffer = b''
+    while True:
+        data = stream.read(1)
+        if not data:
+            break
+        buffer += data
+        while True:
+            start = buffer.find(bytes([SYNC_BYTE]))
+            if start < 0:
+                buffer = b''
+                break
+            buffer = buffer[start:]
+            if len(buffer) < 2:
+                break
+            num_args = buffer[1]
+            if num_args > MAX_ARGS:
+                # Not a real record start - resynchronize
+                buffer = buffer[1:]
+                continue
+            size = HEADER_SIZE + 4 * num_args
+            if len(buffer) < size:
+                break
+            fmt_addr, = struct.unpack_from('<I', buffer, 2)
+            args = list(struct.unpack_from(f'<{num_args}I', buffer, HEADER_SIZE))
+            out.write(format_record(strings, fmt_addr, args))
+            out.flush()
+            buffer = buffer[size:]
+
+def main(argv):
+    parser = argparse.ArgumentParser(description='Decodes deferred debug messages into text')
+    parser.add_argument('elf', type=str, help='Path to the ELF file which is loaded on the device')
+    parser.add_argument('--port', type=str, default=None, help='Serial port to read from (requires pyserial)')
+    parser.add_argument('--baud', type=int, default=115200, help='Serial port BAUD (default: 115200)')
+    parser.add_argument('--input', type=str, default=None, help='Captured binary file to read from (default: stdin)')
+
+    args = parser.parse_args(args=argv)
+
+    strings = StringTable(args.elf)
+
+    if args.port is not None:
+        import serial
+        with serial.Serial(args.port, args.baud) as stream:
+            decode_stream(stream, strings, sys.stdout)
+    elif args.input is not None:
+        with open(args.input, 'rb') as stream:
+            decode_stream(stream, strings, sys.stdout)
+    else:
+        decode_stream(sys.stdin.buffer, strings, sys.stdout)
+
+    return 0
+
+if __name__ == "__main__":
+    sys.exit(main(sys.argv[1:]))
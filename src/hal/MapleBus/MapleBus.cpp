@@ -137,6 +137,7 @@ MapleBus::MapleBus(uint32_t pinA, int32_t dirPin, bool dirOutHigh) :
     mExpectingResponse(false),
     mProcKillTime(0xFFFFFFFFFFFFFFFFULL),
     mLastReceivedWordTimeUs(0),
+    mReadCompleteTimeUs(0),
     mLastReadTransferCount(0)
 {
     mapleWriteIsr[mSmOut.mSmIdx] = this;
@@ -196,6 +197,8 @@ inline void MapleBus::readIsr()
     else if (mCurrentPhase == Phase::READ_IN_PROGRESS)
     {
         mSmIn.stop();
+        // Start of the input latency measurement (see DreamcastControllerObserver)
+        mReadCompleteTimeUs = time_us_64();
         mCurrentPhase = Phase::READ_COMPLETE;
     }
     // else: shouldn't have reached here
@@ -424,6 +427,7 @@ MapleBusInterface::Status MapleBus::processEvents(uint64_t currentTimeUs)
                 {
                     status.readBuffer = mLastRead;
                     status.readBufferLen = dmaWordsRead - 1;
+                    status.readCompleteTimeUs = mReadCompleteTimeUs;
                 }
                 else
                 {
@@ -164,6 +164,8 @@ class MapleBus : public MapleBusInterface
         volatile uint64_t mProcKillTime;
         //! The last time which number of received words changed
         uint64_t mLastReceivedWordTimeUs;
+        //! The time at which the end sequence of the last read was received (set in readIsr)
+        volatile uint64_t mReadCompleteTimeUs;
         //! The last sampled read word transfer count
         uint32_t mLastReadTransferCount;
 };
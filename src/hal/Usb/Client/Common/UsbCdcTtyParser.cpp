@@ -23,176 +23,171 @@
 
 #include "UsbCdcTtyParser.hpp"
 #include "hal/System/LockGuard.hpp"
+#include "cdc.hpp"
 
-#include <limits>
 #include <string.h>
-#include <algorithm>
 #include <stdio.h>
 
-const char* UsbCdcTtyParser::WHITESPACE_CHARS = "\r\n\t ";
-const char* UsbCdcTtyParser::INPUT_EOL_CHARS = "\r\n";
-const char UsbCdcTtyParser::RX_EOL_CHAR = '\n';
-const char* UsbCdcTtyParser::BACKSPACE_CHARS = "\x08\x7F";
-
 UsbCdcTtyParser::UsbCdcTtyParser(MutexInterface& m, char helpChar) :
-    mParserRx(),
-    mLastIsEol(false),
+    mReceiver(cdc_write_raw),
+    mTxFrame(),
     mParserMutex(m),
-    mCommandReady(false),
     mHelpChar(helpChar),
     mParsers(),
-    mOverflowDetected(false)
+    mDispatch()
 {}
 
 void UsbCdcTtyParser::addCommandParser(std::shared_ptr<CommandParser> parser)
 {
     mParsers.push_back(parser);
+
+    for (const char* c = parser->getCommandChars(); *c != '\0'; ++c)
+    {
+        CommandParser*& entry = mDispatch[static_cast<uint8_t>(*c)];
+        if (entry == nullptr)
+        {
+            entry = parser.get();
+        }
+    }
 }
 
 void UsbCdcTtyParser::addChars(const char* chars, uint32_t len)
 {
-    // Entire function is locked
     LockGuard lockGuard(mParserMutex);
+    mReceiver.addChars(chars, len);
+}
 
-    // Reserve space for new characters
-    uint32_t newCapacity = mParserRx.size() + len;
-    if (newCapacity > MAX_QUEUE_SIZE)
+void UsbCdcTtyParser::resetMode()
+{
+    LockGuard lockGuard(mParserMutex);
+    mReceiver.resetMode();
+}
+
+void UsbCdcTtyParser::process()
+{
+    // Only do something if a command is ready
+    CommandRing::Item item;
+    const char* chars;
+    if (!mReceiver.peek(item, chars))
     {
-        newCapacity = MAX_QUEUE_SIZE;
+        return;
     }
-    mParserRx.reserve(newCapacity);
 
-    for (uint32_t i = 0; i < len; ++i, ++chars)
+    if (item.isFrame)
     {
-        // Flag overflow - next command will be ignored
-        if (mParserRx.size() >= MAX_QUEUE_SIZE && *chars != 0x08)
-        {
-            mOverflowDetected = true;
-        }
+        processBinary(chars, item.len);
+    }
+    else
+    {
+        processText(chars, item.len);
+    }
 
-        if (mOverflowDetected)
+    // Release this item and its characters
+    mReceiver.release();
+}
+
+void UsbCdcTtyParser::processText(const char* chars, uint32_t len)
+{
+    // Move past whitespace characters
+    while (len > 0 && (*chars == ' ' || *chars == '\t'))
+    {
+        --len;
+        ++chars;
+    }
+
+    if (len > 0)
+    {
+        if (*chars == mHelpChar)
         {
-            if (strchr(INPUT_EOL_CHARS, *chars) != NULL)
+            printf("HELP\n"
+                   "Command structure: [whitespace]<command-char>[command]<\\n>\n"
+                   "\n"
+                   "COMMANDS:\n");
+            printf("%c: Prints this help\n", mHelpChar);
+            printf("%c%c: Switches to binary frames <length:16-bit LE><command-char>[data]\n",
+                   TtyReceiver::MODE_CHAR,
+                   TtyReceiver::BINARY_MODE_CHAR);
+            // Print help for all commands
+            for (std::vector<std::shared_ptr<CommandParser>>::iterator iter = mParsers.begin();
+                iter != mParsers.end();
+                ++iter)
             {
-                printf("Error: Command input overflow %lu\n", (long unsigned int)mParserRx.size());
-                // Remove only command that overflowed
-                std::vector<char>::reverse_iterator lastEnd =
-                    std::find(mParserRx.rbegin(), mParserRx.rend(), RX_EOL_CHAR);
-                if (lastEnd == mParserRx.rend())
-                {
-                    mParserRx.clear();
-                }
-                else
-                {
-                    // We still captured a full command, so at least leave that for processing
-                    mParserRx.erase((lastEnd + 1).base(), mParserRx.end());
-                }
-                mOverflowDetected = false;
-            }
-            else
-            {
-                mLastIsEol = false;
+                (*iter)->printHelp();
             }
         }
-        else if (strchr(BACKSPACE_CHARS, *chars) != NULL)
+        else
         {
-            // Can't backspace before EOL character or if list is empty
-            if (!mLastIsEol && !mParserRx.empty())
+            // Find command parser that can process this command
+            CommandParser* parser = mDispatch[static_cast<uint8_t>(*chars)];
+            if (parser != nullptr)
             {
-                // Backspace
-                mParserRx.pop_back();
+                parser->submit(chars, len);
             }
-        }
-        else if (strchr(INPUT_EOL_CHARS, *chars) != NULL)
-        {
-            if (!mLastIsEol)
+            else
             {
-                mCommandReady = true;
-                mParserRx.push_back(RX_EOL_CHAR);
-                mLastIsEol = true;
+                printf("Error: Invalid command\n");
             }
         }
-        else
-        {
-            mParserRx.push_back(*chars);
-            mLastIsEol = false;
-        }
     }
+    // Else: empty string - do nothing
 }
 
-void UsbCdcTtyParser::process()
+void UsbCdcTtyParser::processBinary(const char* chars, uint32_t len)
 {
-    // Only do something if a command is ready
-    if (mCommandReady)
-    {
-        // Begin lock guard context
-        LockGuard lockGuard(mParserMutex);
-
-        // End of command is at the new line character
-        std::vector<char>::iterator eol =
-            std::find(mParserRx.begin(), mParserRx.end(), RX_EOL_CHAR);
+    const char command = chars[0];
+    const uint8_t* data = reinterpret_cast<const uint8_t*>(chars + 1);
+    --len;
 
-        if (eol == mParserRx.end()
-            || std::find(eol + 1, mParserRx.end(), RX_EOL_CHAR) == mParserRx.end())
-        {
-            // No further commands found
-            mCommandReady = false;
-        }
-
-        if (eol != mParserRx.end())
+    if (command == TtyReceiver::MODE_CHAR)
+    {
+        // Generated on receive; let all parsers know about the change to the session
+        for (std::vector<std::shared_ptr<CommandParser>>::iterator iter = mParsers.begin();
+            iter != mParsers.end();
+            ++iter)
         {
-            // Just in case it gets parsed as a string, changed EOL to NULL
-            *eol = '\0';
-            // Move past whitespace characters
-            const char* ptr = &mParserRx[0];
-            uint32_t len = eol - mParserRx.begin();
-            while (len > 0 && strchr(WHITESPACE_CHARS, *ptr) != NULL)
+            if (len == 0)
             {
-                --len;
-                ++ptr;
+                (*iter)->setBinaryOutput(this);
             }
-
-            if (len > 0)
+            else if (data[0] == TtyReceiver::TEXT_MODE_CHAR)
             {
-                if (*ptr == mHelpChar)
-                {
-                    printf("HELP\n"
-                           "Command structure: [whitespace]<command-char>[command]<\\n>\n"
-                           "\n"
-                           "COMMANDS:\n");
-                    printf("%c: Prints this help\n", mHelpChar);
-                    // Print help for all commands
-                    for (std::vector<std::shared_ptr<CommandParser>>::iterator iter = mParsers.begin();
-                        iter != mParsers.end();
-                        ++iter)
-                    {
-                        (*iter)->printHelp();
-                    }
-                }
-                else
-                {
-                    // Find command parser that can process this command
-                    bool processed = false;
-                    for (std::vector<std::shared_ptr<CommandParser>>::iterator iter = mParsers.begin();
-                        iter != mParsers.end() && !processed;
-                        ++iter)
-                    {
-                        if (strchr((*iter)->getCommandChars(), *ptr) != NULL)
-                        {
-                            (*iter)->submit(ptr, len);
-                            processed = true;
-                        }
-                    }
-
-                    if (!processed)
-                    {
-                        printf("Error: Invalid command\n");
-                    }
-                }
+                (*iter)->setBinaryOutput(nullptr);
             }
-            // Else: empty string - do nothing
+            else if (data[0] == TtyReceiver::RESET_CHAR)
+            {
+                (*iter)->sessionReset();
+            }
+        }
 
-            mParserRx.erase(mParserRx.begin(), eol + 1);
+        if (len == 0)
+        {
+            // Acknowledge the switch to binary
+            writeFrame(command, data, len);
+        }
+    }
+    else if (command == TtyReceiver::BINARY_ERROR_CHAR)
+    {
+        // Generated on receive; pass along to the host as is
+        writeFrame(command, data, len);
+    }
+    else
+    {
+        // Find command parser that can process this command
+        CommandParser* parser = mDispatch[static_cast<uint8_t>(command)];
+        if (parser == nullptr || !parser->submitBinary(command, data, len, *this))
+        {
+            writeFrame(TtyReceiver::BINARY_ERROR_CHAR, reinterpret_cast<const uint8_t*>(&command), 1);
         }
-    } // End lock guard context
+    }
+}
+
+void UsbCdcTtyParser::writeFrame(char command, const uint8_t* data, uint32_t len)
+{
+    uint32_t frameLength = len + 1;
+    mTxFrame.clear();
+    mTxFrame.push_back(frameLength & 0xFF);
+    mTxFrame.push_back((frameLength >> 8) & 0xFF);
+    mTxFrame.push_back(command);
+    mTxFrame.insert(mTxFrame.end(), data, data + len);
+    cdc_write_raw(&mTxFrame[0], mTxFrame.size());
 }
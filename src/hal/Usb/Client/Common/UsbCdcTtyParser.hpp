@@ -26,16 +26,15 @@
 #include <stdint.h>
 #include <vector>
 #include <memory>
-#include <atomic>
 
 #include "hal/System/MutexInterface.hpp"
 #include "hal/Usb/TtyParser.hpp"
 #include "hal/Usb/CommandParser.hpp"
-
-// Command structure: [whitespace]<command-char>[command]<\n>
+#include "TtyReceiver.hpp"
 
 //! Command parser for processing commands from a TTY stream
-class UsbCdcTtyParser : public TtyParser
+//! Received commands are split out by a TtyReceiver and each is handed to its parser in place.
+class UsbCdcTtyParser : public TtyParser, public BinaryOutput
 {
 public:
     //! Constructor
@@ -43,33 +42,33 @@ public:
     //! Adds a command parser to my list of parsers - must be done before any other function called
     virtual void addCommandParser(std::shared_ptr<CommandParser> parser) final;
     //! Called from the process receiving characters on the TTY
+    //! Characters received as text are echoed back, before any response to them may be written
     void addChars(const char* chars, uint32_t len);
+    //! Called from the process receiving characters on the TTY when the host closes the session;
+    //! switches back to text mode and lets all command parsers know in order with commands
+    void resetMode();
     //! Called from the process handling maple bus execution
     virtual void process() final;
+    //! Writes a binary frame to the TTY
+    virtual void writeFrame(char command, const uint8_t* data, uint32_t len) final;
+
+private:
+    //! Processes a text command
+    void processText(const char* chars, uint32_t len);
+    //! Processes a binary frame
+    void processBinary(const char* chars, uint32_t len);
 
 private:
-    //! Max of 2 KB of memory to use for tty RX queue
-    static const uint32_t MAX_QUEUE_SIZE = 2048;
-    //! String of characters that are considered whitespace
-    static const char* WHITESPACE_CHARS;
-    //! String of characters that are considered end of line characters
-    static const char* INPUT_EOL_CHARS;
-    //! The singular character that is replaced in the RX list as the EOL char
-    static const char RX_EOL_CHAR;
-    //! String of characters that are treated as a backspace
-    static const char* BACKSPACE_CHARS;
-    //! Receive queue
-    std::vector<char> mParserRx;
-    //! Flag that is set to true if the last read character is an EOL (used to ignore further EOL)
-    bool mLastIsEol;
-    //! Mutex used to serialize addChars and process
+    //! Splits received characters into commands
+    TtyReceiver mReceiver;
+    //! Buffer used to build TX frames
+    std::vector<uint8_t> mTxFrame;
+    //! Mutex used to serialize the receiving side (addChars and resetMode)
     MutexInterface& mParserMutex;
-    //! Flag when end of line detected on add
-    std::atomic<bool> mCommandReady;
     //! The command character which prints help for all commands
     const char mHelpChar;
     //! Parsers that may handle data
     std::vector<std::shared_ptr<CommandParser>> mParsers;
-    //! true when overflow in mParserRx
-    bool mOverflowDetected;
+    //! Parser to dispatch to for each command character (first added parser takes precedence)
+    CommandParser* mDispatch[256];
 };
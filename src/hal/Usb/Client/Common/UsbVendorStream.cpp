@@ -0,0 +1,208 @@
+// MIT License
+//
+// Copyright (c) 2022-2025 James Smith of OrangeFox86
+// https://github.com/OrangeFox86/DreamcastControllerUsbPico
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "UsbVendorStream.hpp"
+#include "hal/System/LockGuard.hpp"
+
+#include <string.h>
+#include <stdio.h>
+
+UsbVendorStream::UsbVendorStream(MutexInterface& m) :
+    mRx(),
+    mTx(),
+    mMutex(m),
+    mFrameReady(false),
+    mSkipRemaining(0),
+    mHandler(),
+    mFrame()
+{}
+
+void UsbVendorStream::setRequestHandler(std::shared_ptr<VendorRequestHandler> handler)
+{
+    mHandler = handler;
+}
+
+bool UsbVendorStream::sendResponse(const uint8_t* data, uint32_t len)
+{
+    if (len > 0xFFFF)
+    {
+        return false;
+    }
+
+    // Small frames may use the reserved space so that a dropped response can still be reported
+    uint32_t maxSize = MAX_TX_QUEUE_SIZE;
+    if (len > MAX_RESERVED_FRAME_SIZE)
+    {
+        maxSize -= RESERVED_TX_SIZE;
+    }
+
+    LockGuard lockGuard(mMutex);
+    if (!lockGuard.isLocked() || mTx.size() + LENGTH_SIZE + len > maxSize)
+    {
+        return false;
+    }
+
+    mTx.push_back(len & 0xFF);
+    mTx.push_back((len >> 8) & 0xFF);
+    mTx.insert(mTx.end(), data, data + len);
+    return true;
+}
+
+uint32_t UsbVendorStream::completeFrameSize()
+{
+    if (mRx.size() < LENGTH_SIZE)
+    {
+        return 0;
+    }
+
+    uint32_t frameSize = LENGTH_SIZE + (mRx[0] | (mRx[1] << 8));
+    return (mRx.size() >= frameSize) ? frameSize : 0;
+}
+
+void UsbVendorStream::skipOversizeFrames()
+{
+    while (true)
+    {
+        if (mSkipRemaining > 0)
+        {
+            uint32_t len = (mRx.size() < mSkipRemaining) ? mRx.size() : mSkipRemaining;
+            mRx.erase(mRx.begin(), mRx.begin() + len);
+            mSkipRemaining -= len;
+            if (mSkipRemaining > 0)
+            {
+                // Wait for the rest of the frame
+                return;
+            }
+        }
+
+        if (mRx.size() < LENGTH_SIZE)
+        {
+            return;
+        }
+
+        uint32_t frameLen = mRx[0] | (mRx[1] << 8);
+        if (frameLen + LENGTH_SIZE <= MAX_RX_QUEUE_SIZE)
+        {
+            return;
+        }
+
+        // This frame can never fit in the queue - skip past it to stay in sync with the host
+        printf("Error: Vendor frame too large %lu\n", (long unsigned int)frameLen);
+        mRx.erase(mRx.begin(), mRx.begin() + LENGTH_SIZE);
+        mSkipRemaining = frameLen;
+    }
+}
+
+uint32_t UsbVendorStream::getRxSpace()
+{
+    LockGuard lockGuard(mMutex);
+    if (!lockGuard.isLocked())
+    {
+        return 0;
+    }
+
+    // Bytes of a frame being skipped never land in the queue
+    return MAX_RX_QUEUE_SIZE - mRx.size() + mSkipRemaining;
+}
+
+bool UsbVendorStream::addBytes(const uint8_t* bytes, uint32_t len)
+{
+    // Entire function is locked
+    LockGuard lockGuard(mMutex);
+
+    if (mSkipRemaining > 0)
+    {
+        uint32_t skipLen = (len < mSkipRemaining) ? len : mSkipRemaining;
+        bytes += skipLen;
+        len -= skipLen;
+        mSkipRemaining -= skipLen;
+    }
+
+    if (mRx.size() + len > MAX_RX_QUEUE_SIZE)
+    {
+        // Caller didn't check getRxSpace(); leave the queue intact so framing isn't lost
+        return false;
+    }
+
+    mRx.insert(mRx.end(), bytes, bytes + len);
+    skipOversizeFrames();
+
+    if (completeFrameSize() > 0)
+    {
+        mFrameReady = true;
+    }
+
+    return true;
+}
+
+void UsbVendorStream::process()
+{
+    // Only do something if a frame is ready
+    if (mFrameReady)
+    {
+        {
+            // Begin lock guard context
+            LockGuard lockGuard(mMutex);
+
+            uint32_t frameSize = completeFrameSize();
+            if (frameSize == 0)
+            {
+                mFrameReady = false;
+                return;
+            }
+
+            mFrame.assign(mRx.begin() + LENGTH_SIZE, mRx.begin() + frameSize);
+            mRx.erase(mRx.begin(), mRx.begin() + frameSize);
+            skipOversizeFrames();
+
+            if (completeFrameSize() == 0)
+            {
+                // No further frames found
+                mFrameReady = false;
+            }
+        } // End lock guard context
+
+        // Handled while unlocked so that the handler may send responses
+        if (mHandler)
+        {
+            mHandler->handleRequest(mFrame.data(), mFrame.size(), *this);
+        }
+    }
+}
+
+uint32_t UsbVendorStream::readTx(uint8_t* buffer, uint32_t maxLen)
+{
+    LockGuard lockGuard(mMutex);
+    if (!lockGuard.isLocked())
+    {
+        return 0;
+    }
+
+    uint32_t len = (mTx.size() < maxLen) ? mTx.size() : maxLen;
+    if (len > 0)
+    {
+        memcpy(buffer, mTx.data(), len);
+        mTx.erase(mTx.begin(), mTx.begin() + len);
+    }
+    return len;
+}
@@ -0,0 +1,98 @@
+// MIT License
+//
+// Copyright (c) 2022-2025 James Smith of OrangeFox86
+// https://github.com/OrangeFox86/DreamcastControllerUsbPico
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <stdint.h>
+#include <vector>
+#include <memory>
+#include <atomic>
+
+#include "hal/System/MutexInterface.hpp"
+#include "hal/Usb/VendorStream.hpp"
+
+// Frame structure: <length: 16-bit little endian><length bytes of data>
+
+//! Splits the vendor bulk stream into request frames and queues response frames
+class UsbVendorStream : public VendorStream
+{
+public:
+    //! Constructor
+    UsbVendorStream(MutexInterface& m);
+    //! Sets the request handler - must be done before any other function called
+    virtual void setRequestHandler(std::shared_ptr<VendorRequestHandler> handler) final;
+    //! Queues a response frame to be sent to the host (length prefix is added)
+    virtual bool sendResponse(const uint8_t* data, uint32_t len) final;
+    //! Called from the process handling maple bus execution
+    virtual void process() final;
+    //! Called from the process receiving bytes on the vendor interface
+    //! @returns the number of bytes which may be passed to addBytes() right now
+    uint32_t getRxSpace();
+    //! Called from the process receiving bytes on the vendor interface
+    //! @param[in] bytes  The received bytes
+    //! @param[in] len  Number of bytes received (must not be more than getRxSpace())
+    //! @returns false if the bytes didn't fit and were not added
+    bool addBytes(const uint8_t* bytes, uint32_t len);
+    //! Called from the process sending bytes on the vendor interface
+    //! @param[out] buffer  Where the next queued response bytes are written
+    //! @param[in] maxLen  Maximum number of bytes to write to buffer
+    //! @returns the number of bytes written to buffer
+    uint32_t readTx(uint8_t* buffer, uint32_t maxLen);
+
+private:
+    //! @returns the length of the first complete frame in mRx, including its length prefix, or 0
+    //!          if no complete frame has been received (must be called while locked)
+    uint32_t completeFrameSize();
+
+    //! Drops frames from the front of mRx whose length prefix is larger than the queue can ever
+    //! hold, including their bytes which haven't been received yet (must be called while locked)
+    void skipOversizeFrames();
+
+public:
+    //! Number of bytes in the length prefix of each frame
+    static const uint32_t LENGTH_SIZE = 2;
+
+private:
+    //! Max of 2 KB of memory to use for RX queue
+    static const uint32_t MAX_RX_QUEUE_SIZE = 2048;
+    //! Max of 4 KB of memory to use for TX queue
+    static const uint32_t MAX_TX_QUEUE_SIZE = 4096;
+    //! Space at the end of the TX queue only used by small frames, such as failure status
+    static const uint32_t RESERVED_TX_SIZE = 64;
+    //! Largest frame which may use the reserved TX space
+    static const uint32_t MAX_RESERVED_FRAME_SIZE = 8;
+    //! Receive queue
+    std::vector<uint8_t> mRx;
+    //! Transmit queue
+    std::vector<uint8_t> mTx;
+    //! Mutex used to serialize access to the queues
+    MutexInterface& mMutex;
+    //! Flag set when a complete frame is detected on add
+    std::atomic<bool> mFrameReady;
+    //! Number of bytes left to drop from a frame that was too large for the RX queue
+    uint32_t mSkipRemaining;
+    //! The handler of each received frame
+    std::shared_ptr<VendorRequestHandler> mHandler;
+    //! Holds the frame being handled so the queue may be unlocked while handling
+    std::vector<uint8_t> mFrame;
+};
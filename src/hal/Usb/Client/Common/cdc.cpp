@@ -40,6 +40,8 @@
 #include "class/cdc/cdc_device.h"
 
 #include "UsbCdcTtyParser.hpp"
+#include "OutputRing.hpp"
+#include "hal/Usb/LineOutput.hpp"
 
 
 UsbCdcTtyParser* ttyParser = nullptr;
@@ -56,73 +58,74 @@ TtyParser* usb_cdc_create_parser(MutexInterface* m, char helpChar)
 
 #if CFG_TUD_CDC
 
-static MutexInterface* stdioMutex = nullptr;
+//! Size of the output buffer, which holds everything written until core 0 can send it (large enough
+//! for a batch of several VMU block read responses on a single line)
+#define CDC_OUTPUT_BUFFER_SIZE 8192
+//! Free space needed to start a line of stdio output (longer lines may be cut short when full) -
+//! responses to maple packets don't go through stdio; they are written as whole lines instead
+#define CDC_LINE_RESERVE 256
+//! Space kept for short lines, so that a dropped response can still be answered
+#define CDC_RESERVED_SIZE 256
 
-// Can't use stdio_usb_init() because it checks tud_cdc_connected(), and that doesn't always return
-// true when a connection is made. Not all terminal client set this when making connection.
+#if PICO_STDIO_ENABLE_CRLF_SUPPORT
+// Matches the translation done for stdio
+#define CDC_LINE_END "\r\n"
+#else
+#define CDC_LINE_END "\n"
+#endif
 
-#include "pico/stdio.h"
-#include "pico/stdio/driver.h"
-extern "C" {
+static uint8_t cdcOutputBuffer[CDC_OUTPUT_BUFFER_SIZE];
+static OutputRing* cdcOutput = nullptr;
 
-static void stdio_usb_out_chars2(const char *buf, int length)
+//! Writes whole lines to the output buffer once it exists
+class CdcLineOutput : public LineOutput
 {
-    if (length <= 0) return;
-
-    static uint64_t last_avail_time;
+public:
+    bool writeLine(const char* text, uint32_t len) final
+    {
+        return (cdcOutput != nullptr) && cdcOutput->writeLine(text, len);
+    }
 
-    LockGuard lockGuard(*stdioMutex);
-    if (!lockGuard.isLocked())
+    uint32_t getMaxLineLength() const final
     {
-        return; // would deadlock otherwise
+        return CDC_OUTPUT_BUFFER_SIZE - CDC_RESERVED_SIZE - (sizeof(CDC_LINE_END) - 1);
     }
 
-    for (uint32_t i = 0; i < (uint32_t)length;)
+    uint32_t getDroppedCount() const final
     {
-        uint32_t n = length - i;
-        uint32_t avail = tud_cdc_write_available();
+        return (cdcOutput != nullptr) ? cdcOutput->getDroppedCount() : 0;
+    }
+};
 
-        if (n > avail)
-        {
-            n = (int)avail;
-        }
+LineOutput* usb_cdc_get_line_output()
+{
+    static CdcLineOutput lineOutput;
+    return &lineOutput;
+}
 
-        if (n)
-        {
-            uint32_t n2 = tud_cdc_write(buf + i, n);
-            tud_task();
-            tud_cdc_write_flush();
-            i += n2;
-            last_avail_time = time_us_64();
-        }
-        else
-        {
-            tud_task();
-            tud_cdc_write_flush();
-            if (!tud_cdc_connected() ||
-                (!tud_cdc_write_available() && time_us_64() > last_avail_time + 500000))
-            {
-                break;
-            }
-        }
-    }
+// Can't use stdio_usb_init() because it checks tud_cdc_connected(), and that doesn't always return
+// true when a connection is made. Not all terminal client set this when making connection.
+
+#include "pico/stdio.h"
+#include "pico/stdio/driver.h"
+extern "C" {
+
+// Output is only ever buffered here - it may be called from either core, including from maple bus
+// callbacks, so it must never wait on the host or call into TinyUSB. stdio calls this several times
+// for each line (around each CRLF, for example), so whole lines are kept together by the ring.
+static void stdio_usb_out_chars2(const char *buf, int length)
+{
+    if (length <= 0 || cdcOutput == nullptr) return;
+
+    cdcOutput->writeText(reinterpret_cast<const uint8_t*>(buf), (uint32_t)length);
 }
 
+// All input is consumed by cdc_task() for the TTY parser
 int stdio_usb_in_chars2(char *buf, int length)
 {
-    LockGuard lockGuard(*stdioMutex);
-    if (!lockGuard.isLocked())
-    {
-        return PICO_ERROR_NO_DATA; // would deadlock otherwise
-    }
-
-    int rc = PICO_ERROR_NO_DATA;
-    if (tud_cdc_connected() && tud_cdc_available())
-    {
-        int count = (int) tud_cdc_read(buf, (uint32_t) length);
-        rc =  count ? count : PICO_ERROR_NO_DATA;
-    }
-    return rc;
+    (void) buf;
+    (void) length;
+    return PICO_ERROR_NO_DATA;
 }
 
 
@@ -138,12 +141,32 @@ struct stdio_driver stdio_usb2 =
 
 } // extern "C"
 
+// Producers hold cdcStdioMutex only while copying into the buffer, but that is still a critical
+// section which a producer on the other core spins against (with interrupts disabled). The longest
+// copy is a whole line given to writeLine(): a response line of a single packet is at most about
+// 2.3 KB, and no line may be longer than the buffer (8 KB, roughly 60 us to copy at 133 MHz).
+// Everything else copies at most one stdio chunk.
 void cdc_init(MutexInterface* cdcStdioMutex)
 {
-    stdioMutex = cdcStdioMutex;
+    static OutputRing output(
+        cdcOutputBuffer,
+        sizeof(cdcOutputBuffer),
+        *cdcStdioMutex,
+        CDC_LINE_RESERVE,
+        CDC_RESERVED_SIZE,
+        CDC_LINE_END);
+    cdcOutput = &output;
     stdio_set_driver_enabled(&stdio_usb2, true);
 }
 
+void cdc_write_raw(const uint8_t* data, uint32_t len)
+{
+    if (len == 0 || cdcOutput == nullptr) return;
+
+    // Each call is written whole or not at all
+    cdcOutput->write(data, len);
+}
+
 void cdc_task()
 {
 #if USB_CDC_ENABLED
@@ -160,9 +183,7 @@ void cdc_task()
 
             if (count > 0)
             {
-                // Echo back (no crlf processing since calling directly)
-                stdio_usb_out_chars2(buf, count);
-                // Add to parser
+                // Add to parser, which echoes back what is received as text
                 ttyParser->addChars(buf, count);
             }
         }
@@ -173,6 +194,21 @@ void cdc_task()
         }
     }
 #endif
+
+    // Send buffered output one packet at a time, as the host reads it
+    uint32_t avail = tud_cdc_write_available();
+    if (avail > 0 && cdcOutput != nullptr && !cdcOutput->isEmpty())
+    {
+        uint8_t buf[CFG_TUD_CDC_EP_BUFSIZE];
+        if (avail > sizeof(buf))
+        {
+            avail = sizeof(buf);
+        }
+
+        uint32_t count = cdcOutput->read(buf, avail);
+        tud_cdc_write(buf, count);
+        tud_cdc_write_flush();
+    }
 }
 
 // Invoked when cdc when line state changed e.g connected/disconnected
@@ -180,6 +216,12 @@ void tud_cdc_line_state_cb(uint8_t itf, bool dtr, bool rts)
 {
   (void) itf;
   (void) rts;
+
+  // Terminal closed - the next one to open expects text
+  if (!dtr && ttyParser)
+  {
+    ttyParser->resetMode();
+  }
 }
 
 // Invoked when CDC interface received data from host
@@ -28,5 +28,9 @@
 
 // CDC is used to create a debug serial interface
 
+//! @param[in] cdcStdioMutex  Serializes writers of the output buffer (should be IRQ safe)
 void cdc_init(MutexInterface* cdcStdioMutex);
+//! Feeds received data to the TTY parser and sends buffered output (USB core only)
 void cdc_task();
+//! Buffers data as is, without any line ending translation (never blocks; dropped when full)
+void cdc_write_raw(const uint8_t* data, uint32_t len);
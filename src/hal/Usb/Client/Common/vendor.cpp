@@ -0,0 +1,99 @@
+// MIT License
+//
+// Copyright (c) 2022-2025 James Smith of OrangeFox86
+// https://github.com/OrangeFox86/DreamcastControllerUsbPico
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "vendor.hpp"
+
+#include "configuration.h"
+
+#include "tusb.h"
+#include "class/vendor/vendor_device.h"
+
+#include "UsbVendorStream.hpp"
+
+
+UsbVendorStream* vendorStream = nullptr;
+
+VendorStream* usb_vendor_create_stream(MutexInterface* m)
+{
+    if (vendorStream == nullptr)
+    {
+        vendorStream = new UsbVendorStream(*m);
+    }
+    return vendorStream;
+}
+
+
+#if CFG_TUD_VENDOR
+
+void vendor_task()
+{
+#if USB_VENDOR_ENABLED
+    uint8_t buf[64];
+
+    // connected and there are data available
+    if (tud_vendor_available())
+    {
+        if (vendorStream)
+        {
+            // Only read what the stream can take - anything left in the endpoint FIFO holds off the
+            // host until requests are processed
+            uint32_t space = vendorStream->getRxSpace();
+            if (space > sizeof(buf))
+            {
+                space = sizeof(buf);
+            }
+
+            // read data (no need to lock this - this is the only place where read is done)
+            uint32_t count = (space > 0) ? tud_vendor_read(buf, space) : 0;
+
+            if (count > 0)
+            {
+                vendorStream->addBytes(buf, count);
+            }
+        }
+        else
+        {
+            // Stream not created yet
+            tud_vendor_read_flush();
+        }
+    }
+
+    if (vendorStream)
+    {
+        uint32_t avail = tud_vendor_write_available();
+        if (avail > sizeof(buf))
+        {
+            avail = sizeof(buf);
+        }
+
+        uint32_t count = (avail > 0) ? vendorStream->readTx(buf, avail) : 0;
+        if (count > 0)
+        {
+            tud_vendor_write(buf, count);
+            tud_vendor_write_flush();
+        }
+    }
+#endif
+}
+
+#endif // #if CFG_TUD_VENDOR
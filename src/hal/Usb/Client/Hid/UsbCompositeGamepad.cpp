@@ -0,0 +1,129 @@
+// MIT License
+//
+// Copyright (c) 2022-2025 James Smith of OrangeFox86
+// https://github.com/OrangeFox86/DreamcastControllerUsbPico
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "UsbCompositeGamepad.h"
+#include <string.h>
+
+#include "tusb.h"
+#include "usb_descriptors.h"
+#include "class/hid/hid.h"
+#include "class/hid/hid_device.h"
+
+UsbCompositeGamepad::UsbCompositeGamepad(UsbGamepad* gamepads, uint8_t numGamepads) :
+  mGamepads(gamepads),
+  mNumGamepads((numGamepads <= MAX_NUMBER_OF_USB_GAMEPADS) ? numGamepads : MAX_NUMBER_OF_USB_GAMEPADS),
+  mUpdatedMask(0)
+{}
+
+bool UsbCompositeGamepad::isButtonPressed()
+{
+  for (uint8_t i = 0; i < mNumGamepads; ++i)
+  {
+    if (mGamepads[i].isButtonPressed())
+    {
+      return true;
+    }
+  }
+  return false;
+}
+
+void UsbCompositeGamepad::updateAllReleased()
+{
+  for (uint8_t i = 0; i < mNumGamepads; ++i)
+  {
+    mGamepads[i].updateAllReleased();
+  }
+}
+
+bool UsbCompositeGamepad::send(bool force)
+{
+  (void) force;
+  return true;
+}
+
+void UsbCompositeGamepad::usbTask()
+{
+  bool pending = mResendRequired;
+  for (uint8_t i = 0; i < mNumGamepads && !pending; ++i)
+  {
+    pending = mGamepads[i].isReportPending();
+  }
+
+  if (pending && isUsbConnected() && tud_hid_n_ready(ITF_NUM_GAMEPAD(0)))
+  {
+    // Reports are consumed by getReport() - flag resend if it doesn't make it into the endpoint
+    bool sent = sendReport(ITF_NUM_GAMEPAD(0), GAMEPAD_COMPOSITE_REPORT_ID);
+    mResendRequired = !sent;
+    if (sent)
+    {
+      for (uint8_t i = 0; i < mNumGamepads; ++i)
+      {
+        mGamepads[i].reportSent();
+      }
+    }
+  }
+}
+
+uint8_t UsbCompositeGamepad::getReportSize()
+{
+  return sizeof(hid_dc_composite_report_t);
+}
+
+uint16_t UsbCompositeGamepad::getReport(uint8_t *buffer, uint16_t reqlen)
+{
+  hid_dc_composite_report_t report;
+  memset(&report, 0, sizeof(report));
+
+  // Players flagged in a report which didn't make it to the host remain flagged
+  uint8_t updatedMask = mResendRequired ? mUpdatedMask : 0;
+  for (uint8_t i = 0; i < mNumGamepads; ++i)
+  {
+    if (mGamepads[i].isReportPending())
+    {
+      updatedMask |= (1 << i);
+    }
+    mGamepads[i].getReport(
+      reinterpret_cast<uint8_t*>(&report.players[i]), sizeof(report.players[i]));
+  }
+  for (uint8_t i = mNumGamepads; i < MAX_NUMBER_OF_USB_GAMEPADS; ++i)
+  {
+    // Unused players are neutral
+    report.players[i].z = MIN_TRIGGER_VALUE;
+    report.players[i].rz = MIN_TRIGGER_VALUE;
+    report.players[i].pad = i;
+  }
+  report.updated = updatedMask;
+  mUpdatedMask = updatedMask;
+
+  uint16_t setLen = (sizeof(report) <= reqlen) ? sizeof(report) : reqlen;
+  memcpy(buffer, &report, setLen);
+  return setLen;
+}
+
+void UsbCompositeGamepad::reportComplete(uint64_t timeUs)
+{
+  for (uint8_t i = 0; i < mNumGamepads; ++i)
+  {
+    mGamepads[i].reportComplete(timeUs);
+  }
+}
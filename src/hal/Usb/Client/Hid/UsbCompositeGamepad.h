@@ -0,0 +1,78 @@
+// MIT License
+//
+// Copyright (c) 2022-2025 James Smith of OrangeFox86
+// https://github.com/OrangeFox86/DreamcastControllerUsbPico
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef __USB_COMPOSITE_GAMEPAD_H__
+#define __USB_COMPOSITE_GAMEPAD_H__
+
+#include <stdint.h>
+#include "UsbControllerDevice.h"
+#include "UsbGamepad.h"
+#include "usb_descriptors.h"
+#include "tusb.h"
+
+typedef struct TU_ATTR_PACKED
+{
+  uint8_t updated;                                              ///< Bit n set when player n changed
+  hid_dc_gamepad_report_t players[MAX_NUMBER_OF_USB_GAMEPADS];  ///< State of each player
+}hid_dc_composite_report_t;
+
+//! Sends the state of all players in a single report over a single HID interface
+//! Each UsbGamepad still publishes its own report from the Maple Bus core. From the USB core, this
+//! collects every published report into one composite report, flagging which players changed since
+//! the previous one, so the host reads all players from the same instant in one transaction.
+class UsbCompositeGamepad : public UsbControllerDevice
+{
+  public:
+    //! Constructor
+    //! @param[in] gamepads  The gamepad of each player
+    //! @param[in] numGamepads  Number of players [1,MAX_NUMBER_OF_USB_GAMEPADS]
+    UsbCompositeGamepad(UsbGamepad* gamepads, uint8_t numGamepads);
+    //! @returns true iff any button is "pressed" on any player
+    bool isButtonPressed() final;
+    //! Release all currently pressed keys of all players
+    void updateAllReleased() final;
+    //! Players publish their own reports, so there is nothing to do here
+    //! @returns true
+    bool send(bool force = false) final;
+    //! Sends a composite report to the host when any player has published a new report
+    void usbTask() final;
+    //! @returns the size of the composite report
+    uint8_t getReportSize() final;
+    //! Gets the most recently published report of every player
+    //! @param[out] buffer  Where the report is written
+    //! @param[in] reqlen  The length of buffer
+    uint16_t getReport(uint8_t *buffer, uint16_t reqlen) final;
+    //! Records the input latency of each player included in the report which was just delivered
+    //! @param[in] timeUs  The time at which delivery completed
+    void reportComplete(uint64_t timeUs) final;
+
+  private:
+    //! The gamepad of each player
+    UsbGamepad* const mGamepads;
+    //! Number of players
+    const uint8_t mNumGamepads;
+    //! Players which changed in the report most recently retrieved through getReport()
+    uint8_t mUpdatedMask;
+};
+
+#endif // __USB_COMPOSITE_GAMEPAD_H__
@@ -25,12 +25,17 @@
 #include <stdint.h>
 #include "class/hid/hid_device.h"
 
-UsbControllerDevice::UsbControllerDevice() : mIsUsbConnected(false), mIsControllerConnected(false) {}
+UsbControllerDevice::UsbControllerDevice() :
+  mIsUsbConnected(false),
+  mIsControllerConnected(false),
+  mResendRequired(false)
+{}
 UsbControllerDevice::~UsbControllerDevice() {}
 
 void UsbControllerDevice::updateUsbConnected(bool connected)
 {
   mIsUsbConnected = connected;
+  mResendRequired = connected;
 }
 
 bool UsbControllerDevice::isUsbConnected()
@@ -52,6 +57,11 @@ bool UsbControllerDevice::isControllerConnected()
   return mIsControllerConnected;
 }
 
+void UsbControllerDevice::reportComplete(uint64_t timeUs)
+{
+  (void) timeUs;
+}
+
 bool UsbControllerDevice::sendReport(uint8_t instance, uint8_t report_id)
 {
   bool sent = false;
@@ -48,6 +48,9 @@ class UsbControllerDevice
     //! @returns true if data has been successfully sent or if buttons didn't need to be updated
     virtual bool send(bool force = false) = 0;
 
+    //! Called periodically from the USB context to pass any pending report on to the host
+    virtual void usbTask() = 0;
+
     //! @returns the size of the report for this device
     virtual uint8_t getReportSize() = 0;
 
@@ -57,7 +60,12 @@ class UsbControllerDevice
     //! @returns the number of bytes set in buffer
     virtual uint16_t getReport(uint8_t *buffer, uint16_t reqlen) = 0;
 
+    //! Called from the USB context once a report sent through sendReport() has been delivered
+    //! @param[in] timeUs  The time at which delivery completed
+    virtual void reportComplete(uint64_t timeUs);
+
     //! Called only from callbacks to update USB connected state
+    //! The current report is resent on the next call to usbTask() when connected
     //! @param[in] connected  true iff USB connected
     virtual void updateUsbConnected(bool connected);
 
@@ -83,6 +91,9 @@ class UsbControllerDevice
 
     //! True when this controller is connected
     bool mIsControllerConnected;
+
+    //! True when the current report needs to be sent to the host again (USB context only)
+    bool mResendRequired;
 };
 
 #endif // __USB_CONTROLLER_DEVICE_H__
@@ -33,16 +33,49 @@
 
 #include "utils.h"
 
+// The report builder's hat values are used directly in reports
+static_assert(DreamcastGamepadReportBuilder::HAT_CENTERED == GAMEPAD_HAT_CENTERED, "hat mismatch");
+static_assert(DreamcastGamepadReportBuilder::HAT_UP == GAMEPAD_HAT_UP, "hat mismatch");
+static_assert(DreamcastGamepadReportBuilder::HAT_UP_RIGHT == GAMEPAD_HAT_UP_RIGHT, "hat mismatch");
+static_assert(DreamcastGamepadReportBuilder::HAT_RIGHT == GAMEPAD_HAT_RIGHT, "hat mismatch");
+static_assert(DreamcastGamepadReportBuilder::HAT_DOWN_RIGHT == GAMEPAD_HAT_DOWN_RIGHT, "hat mismatch");
+static_assert(DreamcastGamepadReportBuilder::HAT_DOWN == GAMEPAD_HAT_DOWN, "hat mismatch");
+static_assert(DreamcastGamepadReportBuilder::HAT_DOWN_LEFT == GAMEPAD_HAT_DOWN_LEFT, "hat mismatch");
+static_assert(DreamcastGamepadReportBuilder::HAT_LEFT == GAMEPAD_HAT_LEFT, "hat mismatch");
+static_assert(DreamcastGamepadReportBuilder::HAT_UP_LEFT == GAMEPAD_HAT_UP_LEFT, "hat mismatch");
+
 UsbGamepad::UsbGamepad(uint8_t playerIdx) :
   playerIdx(playerIdx),
   currentDpad(),
   currentButtons(0),
-  buttonsUpdated(true)
+  buttonsUpdated(true),
+  mInputTimeUs(0),
+  mReports(),
+  mReadGeneration(0),
+  mReadInputTimeUs(0),
+  mInFlightInputTimeUs(0),
+  mInputLatency()
 {
   updateAllReleased();
+  send(true);
 }
 
 bool UsbGamepad::isButtonPressed()
+{
+  const hid_dc_gamepad_report_t& report = mReports.read().report;
+  return (
+    report.hat != GAMEPAD_HAT_CENTERED
+    || report.buttons != 0
+    || isAnalogPressed(report.x)
+    || isAnalogPressed(report.y)
+    || isTriggerPressed(report.z)
+    || isAnalogPressed(report.rx)
+    || isAnalogPressed(report.ry)
+    || isTriggerPressed(report.rz)
+  );
+}
+
+bool UsbGamepad::isCurrentStatePressed()
 {
   return (
     currentDpad[DPAD_UP]
@@ -175,9 +208,25 @@ void UsbGamepad::setButton(uint8_t button, bool isPressed)
   setButtonMask(1 << button, isPressed);
 }
 
+void UsbGamepad::setState(const hid_dc_gamepad_report_t& state, uint8_t dpadMask, uint32_t buttonMask)
+{
+  currentLeftAnalog[0] = state.x;
+  currentLeftAnalog[1] = state.y;
+  currentLeftAnalog[2] = state.z;
+  currentRightAnalog[0] = state.rx;
+  currentRightAnalog[1] = state.ry;
+  currentRightAnalog[2] = state.rz;
+  for (uint32_t i = 0; i < DPAD_COUNT; ++i)
+  {
+    currentDpad[i] = (((dpadMask >> i) & 0x01) != 0);
+  }
+  currentButtons = (currentButtons & ~buttonMask) | (state.buttons & buttonMask);
+  buttonsUpdated = true;
+}
+
 void UsbGamepad::updateAllReleased()
 {
-  if (isButtonPressed())
+  if (isCurrentStatePressed())
   {
     currentLeftAnalog[0] = 0;
     currentLeftAnalog[1] = 0;
@@ -196,79 +245,66 @@ void UsbGamepad::updateAllReleased()
 
 uint8_t UsbGamepad::getHatValue()
 {
-  if (currentDpad[DPAD_UP])
-  {
-    if (currentDpad[DPAD_LEFT])
-    {
-      return GAMEPAD_HAT_UP_LEFT;
-    }
-    else if (currentDpad[DPAD_RIGHT])
-    {
-      return GAMEPAD_HAT_UP_RIGHT;
-    }
-    else
-    {
-      return GAMEPAD_HAT_UP;
-    }
-  }
-  else if (currentDpad[DPAD_DOWN])
-  {
-    if (currentDpad[DPAD_LEFT])
-    {
-      return GAMEPAD_HAT_DOWN_LEFT;
-    }
-    else if (currentDpad[DPAD_RIGHT])
-    {
-      return GAMEPAD_HAT_DOWN_RIGHT;
-    }
-    else
-    {
-      return GAMEPAD_HAT_DOWN;
-    }
-  }
-  else if (currentDpad[DPAD_LEFT])
+  uint8_t dpadMask = 0;
+  for (uint32_t i = 0; i < DPAD_COUNT; ++i)
   {
-    return GAMEPAD_HAT_LEFT;
-  }
-  else if (currentDpad[DPAD_RIGHT])
-  {
-    return GAMEPAD_HAT_RIGHT;
-  }
-  else
-  {
-    return GAMEPAD_HAT_CENTERED;
+    dpadMask |= (currentDpad[i] ? 1 : 0) << i;
   }
+  return DreamcastGamepadReportBuilder::toHat(dpadMask);
 }
 
 bool UsbGamepad::send(bool force)
 {
   if (buttonsUpdated || force)
   {
-    bool sent = sendReport(ITF_NUM_GAMEPAD(playerIdx), GAMEPAD_MAIN_REPORT_ID);
-    if (sent)
-    {
-      buttonsUpdated = false;
-    }
-    return sent;
+    // Build the complete report then hand it off in one step
+    PublishedReport& published = mReports.getWriteBuffer();
+    published.inputTimeUs = mInputTimeUs;
+    hid_dc_gamepad_report_t& report = published.report;
+    report.x = currentLeftAnalog[0];
+    report.y = currentLeftAnalog[1];
+    report.z = currentLeftAnalog[2];
+    report.rz = currentRightAnalog[2];
+    report.rx = currentRightAnalog[0];
+    report.ry = currentRightAnalog[1];
+    report.hat = getHatValue();
+    report.buttons = currentButtons;
+    report.pad = playerIdx; // Just put player index in this padding
+    mReports.publish();
+    buttonsUpdated = false;
   }
-  else
+  // An input which didn't change the report is never delivered, so it isn't measured
+  mInputTimeUs = 0;
+  return true;
+}
+
+void UsbGamepad::usbTask()
+{
+  if (
+    (isReportPending() || mResendRequired)
+    && isUsbConnected()
+    && tud_hid_n_ready(ITF_NUM_GAMEPAD(playerIdx))
+  )
   {
-    return true;
+    // Report is consumed by getReport() - flag resend if it doesn't make it into the endpoint
+    mResendRequired = !sendReport(ITF_NUM_GAMEPAD(playerIdx), GAMEPAD_MAIN_REPORT_ID);
+    if (!mResendRequired)
+    {
+      reportSent();
+    }
   }
 }
 
-typedef struct TU_ATTR_PACKED
+bool UsbGamepad::isReportPending()
 {
-  int8_t  x;         ///< Delta x  movement of left analog-stick
-  int8_t  y;         ///< Delta y  movement of left analog-stick
-  int8_t  z;         ///< Delta z  movement of right analog-joystick
-  int8_t  rz;        ///< Delta Rz movement of right analog-joystick
-  int8_t  rx;        ///< Delta Rx movement of analog left trigger
-  int8_t  ry;        ///< Delta Ry movement of analog right trigger
-  uint8_t hat;       ///< Buttons mask for currently pressed buttons in the DPad/hat
-  uint32_t buttons;  ///< Buttons mask for currently pressed buttons
-  uint8_t pad;       ///< Vendor data (padding)
-}hid_dc_gamepad_report_t;
+  // Generation is compared rather than checking for new data since isButtonPressed() also reads
+  return (mReports.getLatestGeneration() != mReadGeneration);
+}
+
+void UsbGamepad::reportSent()
+{
+  mInFlightInputTimeUs = mReadInputTimeUs;
+}
 
 uint8_t UsbGamepad::getReportSize()
 {
@@ -277,19 +313,31 @@ uint8_t UsbGamepad::getReportSize()
 
 uint16_t UsbGamepad::getReport(uint8_t *buffer, uint16_t reqlen)
 {
-  // Build the report
-  hid_dc_gamepad_report_t report;
-  report.x = currentLeftAnalog[0];
-  report.y = currentLeftAnalog[1];
-  report.z = currentLeftAnalog[2];
-  report.rz = currentRightAnalog[2];
-  report.rx = currentRightAnalog[0];
-  report.ry = currentRightAnalog[1];
-  report.hat = getHatValue();
-  report.buttons = currentButtons;
-  report.pad = playerIdx; // Just put player index in this padding
+  const PublishedReport& published = mReports.read();
+  const hid_dc_gamepad_report_t& report = published.report;
+  // Only the first delivery of each published report is measured
+  uint32_t generation = mReports.getReadGeneration();
+  mReadInputTimeUs = (generation != mReadGeneration) ? published.inputTimeUs : 0;
+  mReadGeneration = generation;
   // Copy report into buffer
   uint16_t setLen = (sizeof(report) <= reqlen) ? sizeof(report) : reqlen;
   memcpy(buffer, &report, setLen);
   return setLen;
 }
+
+void UsbGamepad::reportComplete(uint64_t timeUs)
+{
+  if (mInFlightInputTimeUs != 0)
+  {
+    if (timeUs >= mInFlightInputTimeUs)
+    {
+      mInputLatency.add(static_cast<uint32_t>(timeUs - mInFlightInputTimeUs));
+    }
+    mInFlightInputTimeUs = 0;
+  }
+}
+
+LatencyHistogram& UsbGamepad::getInputLatencyHistogram()
+{
+  return mInputLatency;
+}
@@ -27,8 +27,16 @@
 #include <stdint.h>
 #include "UsbControllerDevice.h"
 #include "usb_descriptors.h"
+#include "TripleBuffer.hpp"
+#include "LatencyHistogram.hpp"
+#include "hal/Usb/DreamcastGamepadReport.hpp"
+#include "tusb.h"
 
 //! This class is designed to work with the setup code in usb_descriptors.c
+//! Setters and send() are meant to be called from a single context (the Maple Bus core) while
+//! isButtonPressed(), getReport() and usbTask() are meant to be called from the USB core. A complete
+//! report is handed from one to the other through a triple buffer so that neither side blocks and
+//! the host never receives a partially updated report.
 class UsbGamepad : public UsbControllerDevice
 {
   public:
@@ -80,7 +88,7 @@ class UsbGamepad : public UsbControllerDevice
   public:
     //! UsbKeyboard constructor
     UsbGamepad(uint8_t playerIdx);
-    //! @returns true iff any button is currently "pressed"
+    //! @returns true iff any button is "pressed" in the most recently published report
     bool isButtonPressed() final;
     //! Sets the analog stick for the X direction
     //! @param[in] isLeft true for left, false for right
@@ -115,23 +123,45 @@ class UsbGamepad : public UsbControllerDevice
     //! @param[in] button Button value [0,15]
     //! @param[in] isPressed The state of @p button
     void setButton(uint8_t button, bool isPressed);
+    //! Sets all analogs, the d-pad and the given buttons in one step
+    //! The result is published on the next call to send() without checking for changes
+    //! @param[in] state  The analog, hat and button values to set (pad is ignored)
+    //! @param[in] dpadMask  Pressed d-pad buttons (bit index of each is its DpadButtons value)
+    //! @param[in] buttonMask  The buttons to take from state; all others are left unchanged
+    void setState(const hid_dc_gamepad_report_t& state, uint8_t dpadMask, uint32_t buttonMask);
     //! Release all currently pressed keys
     void updateAllReleased() final;
-    //! Updates the host with any newly pressed keys
-    //! @param[in] force  Set to true to update host regardless if key state has changed since last
+    //! Sets the time at which the input for the next published report was received
+    //! @param[in] timeUs  The input time or 0 if unknown (the report isn't measured)
+    void setInputTimeUs(uint64_t timeUs);
+    //! Publishes a complete report of the current state for the USB core to send to the host
+    //! @param[in] force  Set to true to publish regardless if key state has changed since last
     //!                   update
-    //! @returns true if data has been successfully sent or if keys didn't need to be updated
+    //! @returns true (publishing never fails or blocks)
     bool send(bool force = false) final;
+    //! Sends the most recently published report to the host if it hasn't been sent yet
+    void usbTask() final;
     //! @returns the size of the report for this device
     virtual uint8_t getReportSize();
-    //! Gets the report for the currently pressed keys
+    //! Gets the most recently published report
     //! @param[out] buffer  Where the report is written
     //! @param[in] reqlen  The length of buffer
     uint16_t getReport(uint8_t *buffer, uint16_t reqlen) final;
+    //! @returns true iff a report was published which hasn't been passed to getReport() yet
+    bool isReportPending();
+    //! Called once the report from the last call to getReport() has been put into an endpoint
+    void reportSent();
+    //! Records the input latency of the report which was just delivered
+    //! @param[in] timeUs  The time at which delivery completed
+    void reportComplete(uint64_t timeUs) final;
+    //! @returns the histogram of latencies from input received to report delivered
+    LatencyHistogram& getInputLatencyHistogram();
 
   protected:
     //! @returns the hat value based on current dpad state
     uint8_t getHatValue();
+    //! @returns true iff any button is currently "pressed" in the state being built
+    bool isCurrentStatePressed();
 
   private:
     //! @param[in] analog  The analog value to check
@@ -151,6 +181,15 @@ class UsbGamepad : public UsbControllerDevice
     static const int8_t ANALOG_PRESSED_TOL = 5;
 
   private:
+    //! A complete report along with the time its input was received
+    struct PublishedReport
+    {
+      //! The report to send to the host
+      hid_dc_gamepad_report_t report;
+      //! Time at which the input for this report was received or 0 if unknown
+      uint64_t inputTimeUs;
+    };
+
     const uint8_t playerIdx;
     //! Current left analog states (x,y,z)
     int8_t currentLeftAnalog[3];
@@ -160,8 +199,20 @@ class UsbGamepad : public UsbControllerDevice
     bool currentDpad[DPAD_COUNT];
     //! Current button states
     uint32_t currentButtons;
-    //! True when something has been updated since the last successful send
+    //! True when something has been updated since the last publish
     bool buttonsUpdated;
+    //! Input time to attach to the next published report (setter context only)
+    uint64_t mInputTimeUs;
+    //! Complete reports handed from the setter context to the USB context
+    TripleBuffer<PublishedReport> mReports;
+    //! Generation of the report most recently passed to the host through getReport()
+    uint32_t mReadGeneration;
+    //! Input time of the report most recently passed to the host through getReport() (USB context)
+    uint64_t mReadInputTimeUs;
+    //! Input time of the report currently in the endpoint or 0 if none (USB context only)
+    uint64_t mInFlightInputTimeUs;
+    //! Latencies from input received to report delivered (written in USB context only)
+    LatencyHistogram mInputLatency;
 };
 
 #endif // __USB_CONTROLLER_H__
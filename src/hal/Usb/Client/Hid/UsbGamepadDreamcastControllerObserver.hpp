@@ -25,6 +25,7 @@
 #define __USB_CONTROLLER_DREAMCAST_CONTROLLER_OBSERVER_H__
 
 #include "hal/Usb/DreamcastControllerObserver.hpp"
+#include "hal/Usb/DreamcastGamepadReport.hpp"
 #include "UsbGamepad.h"
 
 //! Yes, I know this name is ridiculous, but at least it's descriptive!
@@ -38,7 +39,10 @@ class UsbGamepadDreamcastControllerObserver : public DreamcastControllerObserver
 
         //! Sets the current Dreamcast controller condition
         //! @param[in] controllerCondition  The current condition of the Dreamcast controller
-        virtual void setControllerCondition(const ControllerCondition& controllerCondition) final;
+        //! @param[in] receivedTimeUs  The time at which the condition was received from the Maple
+        //!                            Bus or 0 if unknown
+        virtual void setControllerCondition(const ControllerCondition& controllerCondition,
+                                            uint64_t receivedTimeUs) final;
 
         //! Sets the current Dreamcast secondary controller condition
         //! @param[in] secondaryControllerCondition  The current secondary condition of the
@@ -52,9 +56,14 @@ class UsbGamepadDreamcastControllerObserver : public DreamcastControllerObserver
         //! Called when controller disconnected
         virtual void controllerDisconnected() final;
 
+        //! @returns the histogram of latencies from condition received to report delivered
+        virtual LatencyHistogram* getInputLatencyHistogram() final;
+
     private:
         //! The USB controller I update
         UsbGamepad& mUsbController;
+        //! Converts conditions into reports and skips unchanged ones
+        DreamcastGamepadReportBuilder mReportBuilder;
 };
 
 #endif // __USB_CONTROLLER_DREAMCAST_CONTROLLER_OBSERVER_H__
@@ -47,72 +47,124 @@ uint8_t get_usb_descriptor_number_of_gamepads()
     return numberOfGamepads;
 }
 
+static bool compositeGamepad = false;
+
+void set_usb_descriptor_composite_gamepad(bool composite)
+{
+    compositeGamepad = composite;
+}
+
+bool get_usb_descriptor_composite_gamepad()
+{
+    return compositeGamepad;
+}
+
+//! @returns the number of HID interfaces presented to the host
+static uint8_t get_number_of_hid_interfaces()
+{
+    return compositeGamepad ? 1 : numberOfGamepads;
+}
+
 #undef TUD_HID_REPORT_DESC_GAMEPAD
 
 #define GET_NUM_BUTTONS(numPlayers, playerIdx) ((numPlayers == 1) ? 32 : (31 - playerIdx))
 
+// Input fields of a single gamepad in a report (12 bytes; see hid_dc_gamepad_report_t)
+#define GAMEPAD_REPORT_FIELDS(numButtons) \
+  /* 8 bit X, Y */ \
+  HID_USAGE_PAGE     ( HID_USAGE_PAGE_DESKTOP                 ) ,\
+  HID_USAGE          ( HID_USAGE_DESKTOP_X                    ) ,\
+  HID_USAGE          ( HID_USAGE_DESKTOP_Y                    ) ,\
+  HID_LOGICAL_MIN    ( MIN_ANALOG_VALUE                       ) ,\
+  HID_LOGICAL_MAX    ( MAX_ANALOG_VALUE                       ) ,\
+  HID_REPORT_COUNT   ( 2                                      ) ,\
+  HID_REPORT_SIZE    ( 8                                      ) ,\
+  HID_INPUT          ( HID_DATA | HID_VARIABLE | HID_ABSOLUTE ) ,\
+  /* 8 bit Z, Rz */ \
+  HID_USAGE_PAGE     ( HID_USAGE_PAGE_DESKTOP                 ) ,\
+  HID_USAGE          ( HID_USAGE_DESKTOP_Z                    ) ,\
+  HID_USAGE          ( HID_USAGE_DESKTOP_RZ                   ) ,\
+  HID_LOGICAL_MIN    ( MIN_TRIGGER_VALUE                      ) ,\
+  HID_LOGICAL_MAX    ( MAX_TRIGGER_VALUE                      ) ,\
+  HID_REPORT_COUNT   ( 2                                      ) ,\
+  HID_REPORT_SIZE    ( 8                                      ) ,\
+  HID_INPUT          ( HID_DATA | HID_VARIABLE | HID_ABSOLUTE ) ,\
+  /* 8 bit Rx, Ry */ \
+  HID_USAGE_PAGE     ( HID_USAGE_PAGE_DESKTOP                 ) ,\
+  HID_USAGE          ( HID_USAGE_DESKTOP_RX                   ) ,\
+  HID_USAGE          ( HID_USAGE_DESKTOP_RY                   ) ,\
+  HID_LOGICAL_MIN    ( MIN_ANALOG_VALUE                       ) ,\
+  HID_LOGICAL_MAX    ( MAX_ANALOG_VALUE                       ) ,\
+  HID_REPORT_COUNT   ( 2                                      ) ,\
+  HID_REPORT_SIZE    ( 8                                      ) ,\
+  HID_INPUT          ( HID_DATA | HID_VARIABLE | HID_ABSOLUTE ) ,\
+  /* 8 bit DPad/Hat Button Map  */ \
+  HID_USAGE_PAGE     ( HID_USAGE_PAGE_DESKTOP                 ) ,\
+  HID_USAGE          ( HID_USAGE_DESKTOP_HAT_SWITCH           ) ,\
+  HID_LOGICAL_MIN    ( 1                                      ) ,\
+  HID_LOGICAL_MAX    ( 8                                      ) ,\
+  HID_PHYSICAL_MIN   ( 0                                      ) ,\
+  HID_PHYSICAL_MAX_N ( 315, 2                                 ) ,\
+  HID_REPORT_COUNT   ( 1                                      ) ,\
+  HID_REPORT_SIZE    ( 8                                      ) ,\
+  HID_INPUT          ( HID_DATA | HID_VARIABLE | HID_ABSOLUTE ) ,\
+  /* Up to 32 bit Button Map (less than 32 to index players on some systems) */ \
+  HID_USAGE_PAGE     ( HID_USAGE_PAGE_BUTTON                  ) ,\
+  HID_USAGE_MIN      ( 1                                      ) ,\
+  HID_USAGE_MAX      ( numButtons                             ) ,\
+  HID_LOGICAL_MIN    ( 0                                      ) ,\
+  HID_LOGICAL_MAX    ( 1                                      ) ,\
+  HID_REPORT_COUNT   ( numButtons                             ) ,\
+  HID_REPORT_SIZE    ( 1                                      ) ,\
+  HID_INPUT          ( HID_DATA | HID_VARIABLE | HID_ABSOLUTE ) ,\
+  /* To pad things out to exactly 12 bytes */ \
+  HID_USAGE_PAGE_N   ( HID_USAGE_PAGE_VENDOR, 2               ) ,\
+  HID_USAGE          ( 0x01                                   ) ,\
+  HID_USAGE_MIN      ( 1                                      ) ,\
+  HID_USAGE_MAX      ( 8 + (32 - numButtons)                 ) ,\
+  HID_LOGICAL_MIN    ( 0                                      ) ,\
+  HID_LOGICAL_MAX    ( 1                                      ) ,\
+  HID_REPORT_COUNT   ( 8 + (32 - numButtons)                 ) ,\
+  HID_REPORT_SIZE    ( 1                                      ) ,\
+  HID_INPUT          ( HID_DATA | HID_VARIABLE | HID_ABSOLUTE ) ,\
+
 // Tweak the gamepad descriptor so that the minimum value on analog controls is -128 instead of -127
 #define TUD_HID_REPORT_DESC_GAMEPAD(numPlayers, playerIdx) \
   HID_USAGE_PAGE ( HID_USAGE_PAGE_DESKTOP     )                 ,\
   HID_USAGE      ( HID_USAGE_DESKTOP_GAMEPAD  )                 ,\
   HID_COLLECTION ( HID_COLLECTION_APPLICATION )                 ,\
     HID_REPORT_ID( GAMEPAD_MAIN_REPORT_ID )                     \
-    /* 8 bit X, Y */ \
-    HID_USAGE_PAGE     ( HID_USAGE_PAGE_DESKTOP                 ) ,\
-    HID_USAGE          ( HID_USAGE_DESKTOP_X                    ) ,\
-    HID_USAGE          ( HID_USAGE_DESKTOP_Y                    ) ,\
-    HID_LOGICAL_MIN    ( MIN_ANALOG_VALUE                       ) ,\
-    HID_LOGICAL_MAX    ( MAX_ANALOG_VALUE                       ) ,\
-    HID_REPORT_COUNT   ( 2                                      ) ,\
-    HID_REPORT_SIZE    ( 8                                      ) ,\
-    HID_INPUT          ( HID_DATA | HID_VARIABLE | HID_ABSOLUTE ) ,\
-    /* 8 bit Z, Rz */ \
-    HID_USAGE_PAGE     ( HID_USAGE_PAGE_DESKTOP                 ) ,\
-    HID_USAGE          ( HID_USAGE_DESKTOP_Z                    ) ,\
-    HID_USAGE          ( HID_USAGE_DESKTOP_RZ                   ) ,\
-    HID_LOGICAL_MIN    ( MIN_TRIGGER_VALUE                      ) ,\
-    HID_LOGICAL_MAX    ( MAX_TRIGGER_VALUE                      ) ,\
-    HID_REPORT_COUNT   ( 2                                      ) ,\
-    HID_REPORT_SIZE    ( 8                                      ) ,\
-    HID_INPUT          ( HID_DATA | HID_VARIABLE | HID_ABSOLUTE ) ,\
-    /* 8 bit Rx, Ry */ \
-    HID_USAGE_PAGE     ( HID_USAGE_PAGE_DESKTOP                 ) ,\
-    HID_USAGE          ( HID_USAGE_DESKTOP_RX                   ) ,\
-    HID_USAGE          ( HID_USAGE_DESKTOP_RY                   ) ,\
-    HID_LOGICAL_MIN    ( MIN_ANALOG_VALUE                       ) ,\
-    HID_LOGICAL_MAX    ( MAX_ANALOG_VALUE                       ) ,\
-    HID_REPORT_COUNT   ( 2                                      ) ,\
-    HID_REPORT_SIZE    ( 8                                      ) ,\
-    HID_INPUT          ( HID_DATA | HID_VARIABLE | HID_ABSOLUTE ) ,\
-    /* 8 bit DPad/Hat Button Map  */ \
+    GAMEPAD_REPORT_FIELDS(GET_NUM_BUTTONS(numPlayers, playerIdx)) \
+  HID_COLLECTION_END \
+
+// One player within the composite report
+#define COMPOSITE_GAMEPAD_PLAYER \
     HID_USAGE_PAGE     ( HID_USAGE_PAGE_DESKTOP                 ) ,\
-    HID_USAGE          ( HID_USAGE_DESKTOP_HAT_SWITCH           ) ,\
-    HID_LOGICAL_MIN    ( 1                                      ) ,\
-    HID_LOGICAL_MAX    ( 8                                      ) ,\
-    HID_PHYSICAL_MIN   ( 0                                      ) ,\
-    HID_PHYSICAL_MAX_N ( 315, 2                                 ) ,\
-    HID_REPORT_COUNT   ( 1                                      ) ,\
-    HID_REPORT_SIZE    ( 8                                      ) ,\
-    HID_INPUT          ( HID_DATA | HID_VARIABLE | HID_ABSOLUTE ) ,\
-    /* Up to 32 bit Button Map (less than 32 to index players on some systems) */ \
-    HID_USAGE_PAGE     ( HID_USAGE_PAGE_BUTTON                  ) ,\
-    HID_USAGE_MIN      ( 1                                      ) ,\
-    HID_USAGE_MAX      ( GET_NUM_BUTTONS(numPlayers, playerIdx) ) ,\
-    HID_LOGICAL_MIN    ( 0                                      ) ,\
-    HID_LOGICAL_MAX    ( 1                                      ) ,\
-    HID_REPORT_COUNT   ( GET_NUM_BUTTONS(numPlayers, playerIdx) ) ,\
-    HID_REPORT_SIZE    ( 1                                      ) ,\
-    HID_INPUT          ( HID_DATA | HID_VARIABLE | HID_ABSOLUTE ) ,\
-    /* To pad things out to exactly 12 bytes */ \
+    HID_USAGE          ( HID_USAGE_DESKTOP_GAMEPAD              ) ,\
+    HID_COLLECTION     ( HID_COLLECTION_LOGICAL                 ) ,\
+      GAMEPAD_REPORT_FIELDS(32) \
+    HID_COLLECTION_END ,\
+
+// All players in a single report (see hid_dc_composite_report_t)
+#define TUD_HID_REPORT_DESC_COMPOSITE_GAMEPAD() \
+  HID_USAGE_PAGE ( HID_USAGE_PAGE_DESKTOP     )                 ,\
+  HID_USAGE      ( HID_USAGE_DESKTOP_GAMEPAD  )                 ,\
+  HID_COLLECTION ( HID_COLLECTION_APPLICATION )                 ,\
+    HID_REPORT_ID( GAMEPAD_COMPOSITE_REPORT_ID )                \
+    /* 1 bit per player, set when that player changed since the previous report */ \
     HID_USAGE_PAGE_N   ( HID_USAGE_PAGE_VENDOR, 2               ) ,\
-    HID_USAGE          ( 0x01                                   ) ,\
+    HID_USAGE          ( 0x02                                   ) ,\
     HID_USAGE_MIN      ( 1                                      ) ,\
-    HID_USAGE_MAX      ( 8 + (32 - GET_NUM_BUTTONS(numPlayers, playerIdx))) ,\
+    HID_USAGE_MAX      ( 8                                      ) ,\
     HID_LOGICAL_MIN    ( 0                                      ) ,\
     HID_LOGICAL_MAX    ( 1                                      ) ,\
-    HID_REPORT_COUNT   ( 8 + (32 - GET_NUM_BUTTONS(numPlayers, playerIdx))) ,\
+    HID_REPORT_COUNT   ( 8                                      ) ,\
     HID_REPORT_SIZE    ( 1                                      ) ,\
     HID_INPUT          ( HID_DATA | HID_VARIABLE | HID_ABSOLUTE ) ,\
+    COMPOSITE_GAMEPAD_PLAYER \
+    COMPOSITE_GAMEPAD_PLAYER \
+    COMPOSITE_GAMEPAD_PLAYER \
+    COMPOSITE_GAMEPAD_PLAYER \
   HID_COLLECTION_END \
 
 //--------------------------------------------------------------------+
@@ -122,7 +174,12 @@ tusb_desc_device_t const desc_device =
 {
     .bLength            = sizeof(tusb_desc_device_t),
     .bDescriptorType    = TUSB_DESC_DEVICE,
+#if USB_VENDOR_ENABLED
+    // 2.1 so that the host asks for the BOS descriptor (see tud_descriptor_bos_cb)
+    .bcdUSB             = 0x0210,
+#else
     .bcdUSB             = 0x0200,
+#endif
     .bDeviceClass       = 0x00,
     .bDeviceSubClass    = 0x00,
     .bDeviceProtocol    = 0x00,
@@ -149,6 +206,94 @@ uint8_t const *tud_descriptor_device_cb(void) {
     return (uint8_t const *) &desc_device;
 }
 
+#if USB_VENDOR_ENABLED
+
+//--------------------------------------------------------------------+
+// BOS Descriptor
+//--------------------------------------------------------------------+
+
+// Vendor request code the host uses to fetch the MS OS 2.0 descriptor set
+#define VENDOR_REQUEST_MICROSOFT (1)
+
+// wIndex of the vendor request which asks for the MS OS 2.0 descriptor set
+#define MS_OS_20_DESCRIPTOR_INDEX (7)
+
+#define BOS_TOTAL_LEN (TUD_BOS_DESC_LEN + TUD_BOS_MICROSOFT_OS_DESC_LEN)
+
+#define MS_OS_20_DESC_LEN (0xB2)
+
+uint8_t const desc_bos[] =
+{
+    TUD_BOS_DESCRIPTOR(BOS_TOTAL_LEN, 1),
+    TUD_BOS_MS_OS_20_DESCRIPTOR(MS_OS_20_DESC_LEN, VENDOR_REQUEST_MICROSOFT)
+};
+
+// Invoked when received GET BOS DESCRIPTOR
+// Application return pointer to descriptor
+uint8_t const *tud_descriptor_bos_cb(void) {
+    return desc_bos;
+}
+
+// MS OS 2.0 descriptor set which tells Windows to bind WinUSB to the vendor interface, without any
+// driver install, and which GUID applications use to find it
+uint8_t const desc_ms_os_20[] =
+{
+    // Set header: length, type, windows version, total length
+    U16_TO_U8S_LE(0x000A), U16_TO_U8S_LE(MS_OS_20_SET_HEADER_DESCRIPTOR), U32_TO_U8S_LE(0x06030000),
+    U16_TO_U8S_LE(MS_OS_20_DESC_LEN),
+
+    // Configuration subset header: length, type, configuration index, reserved, configuration total length
+    U16_TO_U8S_LE(0x0008), U16_TO_U8S_LE(MS_OS_20_SUBSET_HEADER_CONFIGURATION), 0, 0,
+    U16_TO_U8S_LE(MS_OS_20_DESC_LEN - 0x0A),
+
+    // Function subset header: length, type, first interface, reserved, subset length
+    U16_TO_U8S_LE(0x0008), U16_TO_U8S_LE(MS_OS_20_SUBSET_HEADER_FUNCTION), ITF_NUM_VENDOR, 0,
+    U16_TO_U8S_LE(MS_OS_20_DESC_LEN - 0x0A - 0x08),
+
+    // Compatible ID: length, type, compatible ID, sub compatible ID
+    U16_TO_U8S_LE(0x0014), U16_TO_U8S_LE(MS_OS_20_FEATURE_COMPATBLE_ID), 'W', 'I', 'N', 'U', 'S', 'B', 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+
+    // Registry property: length, type, data type (REG_MULTI_SZ), name length, name, data length, data
+    U16_TO_U8S_LE(MS_OS_20_DESC_LEN - 0x0A - 0x08 - 0x08 - 0x14), U16_TO_U8S_LE(MS_OS_20_FEATURE_REG_PROPERTY),
+    U16_TO_U8S_LE(0x0007), U16_TO_U8S_LE(0x002A),
+    'D', 0x00, 'e', 0x00, 'v', 0x00, 'i', 0x00, 'c', 0x00, 'e', 0x00, 'I', 0x00, 'n', 0x00,
+    't', 0x00, 'e', 0x00, 'r', 0x00, 'f', 0x00, 'a', 0x00, 'c', 0x00, 'e', 0x00, 'G', 0x00,
+    'U', 0x00, 'I', 0x00, 'D', 0x00, 's', 0x00, 0x00, 0x00,
+    U16_TO_U8S_LE(0x0050),
+    '{', 0x00, '0', 0x00, '7', 0x00, '4', 0x00, 'D', 0x00, 'A', 0x00, '4', 0x00, '0', 0x00,
+    'A', 0x00, '-', 0x00, 'A', 0x00, '3', 0x00, '4', 0x00, '1', 0x00, '-', 0x00, '4', 0x00,
+    '3', 0x00, '7', 0x00, '4', 0x00, '-', 0x00, 'A', 0x00, 'F', 0x00, '0', 0x00, '0', 0x00,
+    '-', 0x00, '3', 0x00, '0', 0x00, 'F', 0x00, 'D', 0x00, '1', 0x00, 'A', 0x00, '6', 0x00,
+    '8', 0x00, 'C', 0x00, '3', 0x00, '6', 0x00, '3', 0x00, '}', 0x00, 0x00, 0x00, 0x00, 0x00
+};
+
+TU_VERIFY_STATIC(sizeof(desc_ms_os_20) == MS_OS_20_DESC_LEN, "Incorrect MS OS 2.0 descriptor size");
+
+// Invoked when a control transfer occurred on an interface of this class
+// Returns false to stall the control endpoint (unsupported request)
+bool tud_vendor_control_xfer_cb(uint8_t rhport, uint8_t stage, tusb_control_request_t const* request)
+{
+    // Nothing to do for the DATA and ACK stages
+    if (stage != CONTROL_STAGE_SETUP)
+    {
+        return true;
+    }
+
+    if (
+        request->bmRequestType_bit.type == TUSB_REQ_TYPE_VENDOR
+        && request->bRequest == VENDOR_REQUEST_MICROSOFT
+        && request->wIndex == MS_OS_20_DESCRIPTOR_INDEX
+    )
+    {
+        return tud_control_xfer(rhport, request, (void*)(uintptr_t)desc_ms_os_20, sizeof(desc_ms_os_20));
+    }
+
+    return false;
+}
+
+#endif // USB_VENDOR_ENABLED
+
 //--------------------------------------------------------------------+
 // HID Report Descriptor
 //--------------------------------------------------------------------+
@@ -158,12 +303,23 @@ uint8_t desc_hid_report[] =
     TUD_HID_REPORT_DESC_GAMEPAD(MAX_NUMBER_OF_USB_GAMEPADS, 0)
 };
 
+uint8_t const desc_hid_composite_report[] =
+{
+    TUD_HID_REPORT_DESC_COMPOSITE_GAMEPAD()
+};
+
+_Static_assert(MAX_NUMBER_OF_USB_GAMEPADS == 4, "composite report descriptor has 4 players");
+
 // Invoked when received GET HID REPORT DESCRIPTOR
 // Application return pointer to descriptor
 // Descriptor contents must exist long enough for transfer to complete
 uint8_t const *tud_hid_descriptor_report_cb(uint8_t instance)
 {
-    if (instance < numberOfGamepads)
+    if (compositeGamepad)
+    {
+        return (instance == 0) ? desc_hid_composite_report : NULL;
+    }
+    else if (instance < numberOfGamepads)
     {
         uint8_t buff[] = {TUD_HID_REPORT_DESC_GAMEPAD(numberOfGamepads, instance)};
         memcpy(desc_hid_report, buff, sizeof(desc_hid_report));
@@ -183,7 +339,13 @@ uint8_t const *tud_hid_descriptor_report_cb(uint8_t instance)
     #define DEBUG_CONFIG_LEN 0
 #endif
 
-#define GET_CONFIG_LEN(numGamepads) (TUD_CONFIG_DESC_LEN + (numGamepads * TUD_HID_DESC_LEN) + DEBUG_CONFIG_LEN + TUD_MSC_DESC_LEN)
+#if USB_VENDOR_ENABLED
+    #define VENDOR_CONFIG_LEN TUD_VENDOR_DESC_LEN
+#else
+    #define VENDOR_CONFIG_LEN 0
+#endif
+
+#define GET_CONFIG_LEN(numGamepads) (TUD_CONFIG_DESC_LEN + (numGamepads * TUD_HID_DESC_LEN) + DEBUG_CONFIG_LEN + TUD_MSC_DESC_LEN + VENDOR_CONFIG_LEN)
 
 // Endpoint definitions (must all be unique)
 #define EPIN_GAMEPAD1   (0x84)
@@ -195,6 +357,8 @@ uint8_t const *tud_hid_descriptor_report_cb(uint8_t instance)
 #define EPIN_CDC_NOTIF  (0x86)
 #define EPOUT_CDC       (0x07)
 #define EPIN_CDC        (0x87)
+#define EPOUT_VENDOR    (0x08)
+#define EPIN_VENDOR     (0x88)
 
 #define PLAYER_TO_STR_IDX(player) (player + 4)
 
@@ -213,14 +377,16 @@ uint8_t player_to_epin(uint8_t player)
 #define CONFIG_HEADER(numGamepads) \
     TUD_CONFIG_DESCRIPTOR(1, ITF_COUNT(numGamepads), 0, GET_CONFIG_LEN(numGamepads), TUSB_DESC_CONFIG_ATT_REMOTE_WAKEUP, 400)
 
-#define GAMEPAD_CONFIG_DESC(itfNum, strIdx, endpt) \
-    TUD_HID_DESCRIPTOR(itfNum, strIdx, HID_ITF_PROTOCOL_NONE, sizeof(desc_hid_report), endpt, GAMEPAD_REPORT_SIZE, 1)
+#define GAMEPAD_CONFIG_DESC(itfNum, strIdx, endpt, reportDescLen) \
+    TUD_HID_DESCRIPTOR(itfNum, strIdx, HID_ITF_PROTOCOL_NONE, reportDescLen, endpt, GAMEPAD_REPORT_SIZE, 1)
 
 // Only doing transfer at full speed since each file will only be about 128KB, max of 8 files
 #define MSC_DESCRIPTOR(numGamepads) TUD_MSC_DESCRIPTOR(ITF_NUM_MSC, 8, EPOUT_MSC, EPIN_MSC, 64)
 
 #define CDC_DESCRIPTOR(numGamepads) TUD_CDC_DESCRIPTOR(ITF_NUM_CDC, 9, EPIN_CDC_NOTIF, 8, EPOUT_CDC, EPIN_CDC, 64)
 
+#define VENDOR_DESCRIPTOR(numGamepads) TUD_VENDOR_DESCRIPTOR(ITF_NUM_VENDOR, 10, EPOUT_VENDOR, EPIN_VENDOR, 64)
+
 // This is setup with the maximum amount of data needed for the description, and it is updated in
 // tud_descriptor_configuration_cb() before being sent to the USB host
 uint8_t desc_configuration[] =
@@ -231,10 +397,10 @@ uint8_t desc_configuration[] =
     // * Gamepad Descriptors                                                   *
     // *************************************************************************
 
-    GAMEPAD_CONFIG_DESC(0, PLAYER_TO_STR_IDX(0), EPIN_GAMEPAD1),
-    GAMEPAD_CONFIG_DESC(1, PLAYER_TO_STR_IDX(1), EPIN_GAMEPAD2),
-    GAMEPAD_CONFIG_DESC(2, PLAYER_TO_STR_IDX(2), EPIN_GAMEPAD3),
-    GAMEPAD_CONFIG_DESC(3, PLAYER_TO_STR_IDX(3), EPIN_GAMEPAD4),
+    GAMEPAD_CONFIG_DESC(0, PLAYER_TO_STR_IDX(0), EPIN_GAMEPAD1, sizeof(desc_hid_report)),
+    GAMEPAD_CONFIG_DESC(1, PLAYER_TO_STR_IDX(1), EPIN_GAMEPAD2, sizeof(desc_hid_report)),
+    GAMEPAD_CONFIG_DESC(2, PLAYER_TO_STR_IDX(2), EPIN_GAMEPAD3, sizeof(desc_hid_report)),
+    GAMEPAD_CONFIG_DESC(3, PLAYER_TO_STR_IDX(3), EPIN_GAMEPAD4, sizeof(desc_hid_report)),
 
     // *************************************************************************
     // * Storage Device Descriptor                                             *
@@ -249,6 +415,14 @@ uint8_t desc_configuration[] =
 #if USB_CDC_ENABLED
     CDC_DESCRIPTOR(MAX_NUMBER_OF_USB_GAMEPADS),
 #endif
+
+    // *************************************************************************
+    // * Vendor Descriptor  (for binary maple bus passthrough)                 *
+    // *************************************************************************
+
+#if USB_VENDOR_ENABLED
+    VENDOR_DESCRIPTOR(MAX_NUMBER_OF_USB_GAMEPADS),
+#endif
 };
 
 // Invoked when received GET CONFIGURATION DESCRIPTOR
@@ -259,36 +433,46 @@ uint8_t const *tud_descriptor_configuration_cb(uint8_t index) {
 
     // Build the config based on number of players
     uint32_t offset = 0;
+    uint8_t numHidInterfaces = get_number_of_hid_interfaces();
+    uint16_t reportDescLen = compositeGamepad ? sizeof(desc_hid_composite_report) : sizeof(desc_hid_report);
 
     uint8_t header[] = {
-        CONFIG_HEADER(numberOfGamepads)
+        CONFIG_HEADER(numHidInterfaces)
     };
     memcpy(&desc_configuration[offset], header, sizeof(header));
     offset += sizeof(header);
 
-    for (uint8_t i = 0; i < numberOfGamepads; ++i)
+    for (uint8_t i = 0; i < numHidInterfaces; ++i)
     {
         uint8_t gpConfig[] = {
-            GAMEPAD_CONFIG_DESC(i, PLAYER_TO_STR_IDX(i), player_to_epin(i))
+            GAMEPAD_CONFIG_DESC(i, PLAYER_TO_STR_IDX(i), player_to_epin(i), reportDescLen)
         };
         memcpy(&desc_configuration[offset], gpConfig, sizeof(gpConfig));
         offset += sizeof(gpConfig);
     }
 
     uint8_t mscConfig[] = {
-        MSC_DESCRIPTOR(numberOfGamepads)
+        MSC_DESCRIPTOR(numHidInterfaces)
     };
     memcpy(&desc_configuration[offset], mscConfig, sizeof(mscConfig));
     offset += sizeof(mscConfig);
 
 #if USB_CDC_ENABLED
     uint8_t cdcConfig[] = {
-        CDC_DESCRIPTOR(numberOfGamepads)
+        CDC_DESCRIPTOR(numHidInterfaces)
     };
     memcpy(&desc_configuration[offset], cdcConfig, sizeof(cdcConfig));
     offset += sizeof(cdcConfig);
 #endif
 
+#if USB_VENDOR_ENABLED
+    uint8_t vendorConfig[] = {
+        VENDOR_DESCRIPTOR(numHidInterfaces)
+    };
+    memcpy(&desc_configuration[offset], vendorConfig, sizeof(vendorConfig));
+    offset += sizeof(vendorConfig);
+#endif
+
     return desc_configuration;
 }
 
@@ -309,6 +493,7 @@ char const *string_desc_arr[] =
     "DreamPicoPort D",               // 7: Gamepad 4
     "MSC",                       // 8: Mass Storage Class
     "CDC",                       // 9: Communication Device Class
+    "Maple Passthrough",         // 10: Vendor (binary maple bus frames)
 };
 
 static uint16_t _desc_str[32];
@@ -331,9 +516,9 @@ uint16_t const *tud_descriptor_string_cb(uint8_t index, uint16_t langid) {
 
         const char *str = string_desc_arr[index];
 
-        if (index == PLAYER_TO_STR_IDX(0) && numberOfGamepads == 1)
+        if (index == PLAYER_TO_STR_IDX(0) && get_number_of_hid_interfaces() == 1)
         {
-            // Special case - if there is only 1 controller, change the label
+            // Special case - if there is only 1 controller interface, change the label
             str = "DreamPicoPort";
         }
         else if (str == NULL)
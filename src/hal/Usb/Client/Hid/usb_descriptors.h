@@ -29,6 +29,7 @@
 
 #define GAMEPAD_MAIN_REPORT_ID 1
 #define REPORT_ID_DC_RAW_DATA 2
+#define GAMEPAD_COMPOSITE_REPORT_ID 3
 #define GAMEPAD_REPORT_SIZE 64
 
 #define ITF_NUM_GAMEPAD(idx) (idx)
@@ -40,7 +41,15 @@
 
 #define ITF_NUM_CDC (5)
 #define ITF_NUM_CDC_DATA (6)
-#define ITF_COUNT(numGamepads) (numGamepads + 3)
+
+// For binary maple bus passthrough
+#define ITF_NUM_VENDOR (7)
+
+#if USB_VENDOR_ENABLED
+    #define ITF_COUNT(numGamepads) (numGamepads + 4)
+#else
+    #define ITF_COUNT(numGamepads) (numGamepads + 3)
+#endif
 
 //! Minumum analog value defined in USB HID descriptors
 static const int8_t MIN_ANALOG_VALUE = -127;
@@ -24,8 +24,10 @@
 #include "UsbControllerDevice.h"
 #include "UsbGamepadDreamcastControllerObserver.hpp"
 #include "UsbGamepad.h"
+#include "UsbCompositeGamepad.h"
 #include "configuration.h"
 #include "hal/Usb/client_usb_interface.hpp"
+#include "hal/Usb/usb_interface.hpp"
 #include <stdlib.h>
 #include <stdio.h>
 #include <string.h>
@@ -38,6 +40,7 @@
 #include "class/hid/hid_device.h"
 #include "msc_disk.hpp"
 #include "cdc.hpp"
+#include "vendor.hpp"
 
 UsbGamepad usbGamepads[MAX_NUMBER_OF_USB_GAMEPADS] = {
   UsbGamepad(0),
@@ -60,6 +63,12 @@ UsbControllerDevice* devices[MAX_NUMBER_OF_USB_GAMEPADS] = {
   &usbGamepads[3]
 };
 
+UsbCompositeGamepad usbCompositeGamepad(usbGamepads, MAX_NUMBER_OF_USB_GAMEPADS);
+
+UsbControllerDevice* compositeDevices[1] = {
+  &usbCompositeGamepad
+};
+
 DreamcastControllerObserver* observers[MAX_NUMBER_OF_USB_GAMEPADS] = {
   &usbGamepadDreamcastControllerObservers[0],
   &usbGamepadDreamcastControllerObservers[1],
@@ -86,6 +95,13 @@ uint32_t get_num_usb_controllers()
   }
 }
 
+UsbFrameTiming usbFrameTiming;
+
+const UsbFrameTiming& usb_get_frame_timing()
+{
+  return usbFrameTiming;
+}
+
 bool usbEnabled = false;
 
 UsbControllerDevice** pAllUsbDevices = nullptr;
@@ -162,17 +178,30 @@ void usb_init(
   MutexInterface* mscMutex,
   MutexInterface* cdcStdioMutex)
 {
-  uint32_t numDevices = get_num_usb_controllers();
-
-  uint32_t max = sizeof(devices) / sizeof(devices[1]);
-  if (numDevices > max)
+  if (get_usb_descriptor_composite_gamepad())
+  {
+    // All players are sent through the one composite device
+    set_usb_devices(compositeDevices, 1);
+  }
+  else
   {
-    numDevices = max;
+    uint32_t numDevices = get_num_usb_controllers();
+
+    uint32_t max = sizeof(devices) / sizeof(devices[1]);
+    if (numDevices > max)
+    {
+      numDevices = max;
+    }
+    set_usb_devices(devices, numDevices);
   }
-  set_usb_devices(devices, numDevices);
 
   board_init();
   tusb_init();
+#if (TUSB_VERSION_MAJOR > 0) || (TUSB_VERSION_MINOR >= 16)
+  // Start of frame is used to phase align controller polls with the host's interrupt IN polls
+  // (with older TinyUSB, aligned polling just falls back to free running)
+  tud_sof_cb_enable(true);
+#endif
   msc_init(mscMutex);
   cdc_init(cdcStdioMutex);
 
@@ -190,8 +219,14 @@ void usb_init(
 void usb_task()
 {
   tud_task(); // tinyusb device task
+  UsbControllerDevice** pdevs = pAllUsbDevices;
+  for (uint32_t i = numUsbDevices; i > 0; --i, ++pdevs)
+  {
+    (*pdevs)->usbTask();
+  }
   led_task();
   cdc_task();
+  vendor_task();
 }
 
 //--------------------------------------------------------------------+
@@ -205,7 +240,6 @@ void tud_mount_cb(void)
   for (uint32_t i = numUsbDevices; i > 0; --i, ++pdevs)
   {
     (*pdevs)->updateUsbConnected(true);
-    (*pdevs)->send(true);
   }
   gIsConnected = true;
 }
@@ -221,6 +255,13 @@ void tud_umount_cb(void)
   gIsConnected = false;
 }
 
+// Invoked on every start of frame once enabled by tud_sof_cb_enable()
+void tud_sof_cb(uint32_t frame_count)
+{
+  (void) frame_count;
+  usbFrameTiming.startOfFrame(time_us_64());
+}
+
 // Invoked when usb bus is suspended
 // remote_wakeup_en : if host allow us  to perform remote wakeup
 // Within 7ms, device must draw an average of current less than 2.5 mA from bus
@@ -242,7 +283,6 @@ void tud_resume_cb(void)
   for (uint32_t i = numUsbDevices; i > 0; --i, ++pdevs)
   {
     (*pdevs)->updateUsbConnected(true);
-    (*pdevs)->send(true);
   }
   gIsConnected = true;
 }
@@ -269,6 +309,18 @@ uint16_t tud_hid_get_report_cb(uint8_t instance, uint8_t report_id, hid_report_t
   }
 }
 
+// Invoked when a report sent with tud_hid_n_report() has been delivered to the host
+void tud_hid_report_complete_cb(uint8_t instance, uint8_t const* report, uint16_t len)
+{
+  (void) report;
+  (void) len;
+  if (instance < numUsbDevices)
+  {
+    // End of the input latency measurement
+    pAllUsbDevices[instance]->reportComplete(time_us_64());
+  }
+}
+
 // Invoked when received SET_REPORT control request or
 // received data on OUT endpoint ( Report ID = 0, Type = 0 )
 void tud_hid_set_report_cb(uint8_t instance,
@@ -0,0 +1,65 @@
+// MIT License
+//
+// Copyright (c) 2022-2025 James Smith of OrangeFox86
+// https://github.com/OrangeFox86/DreamcastControllerUsbPico
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include "ProbePolicyInterface.hpp"
+
+//! Probes quickly for a number of probes after reset then backs off exponentially up to a ceiling
+//! (setting maxIntervalUs equal to initialBackoffUs yields a fixed interval after the fast probes)
+class BackoffProbePolicy : public ProbePolicyInterface
+{
+public:
+    //! Constructor
+    //! @param[in] fastIntervalUs  Probe interval right after reset
+    //! @param[in] numFastProbes  Number of probes sent at fastIntervalUs before backing off
+    //! @param[in] initialBackoffUs  First interval after the fast probes
+    //! @param[in] maxIntervalUs  The interval doubles on each probe until reaching this ceiling
+    BackoffProbePolicy(uint32_t fastIntervalUs,
+                       uint32_t numFastProbes,
+                       uint32_t initialBackoffUs,
+                       uint32_t maxIntervalUs);
+
+    //! Virtual destructor
+    virtual ~BackoffProbePolicy();
+
+    //! Inherited from ProbePolicyInterface
+    virtual void reset() final;
+
+    //! Inherited from ProbePolicyInterface
+    virtual uint32_t nextProbeIntervalUs() final;
+
+private:
+    //! Probe interval right after reset
+    const uint32_t mFastIntervalUs;
+    //! Number of probes sent at mFastIntervalUs before backing off
+    const uint32_t mNumFastProbes;
+    //! First interval after the fast probes
+    const uint32_t mInitialBackoffUs;
+    //! Interval ceiling
+    const uint32_t mMaxIntervalUs;
+    //! Number of fast probes remaining until backing off
+    uint32_t mFastProbesRemaining;
+    //! The interval which will be returned on next call once fast probes are exhausted
+    uint32_t mBackoffUs;
+};
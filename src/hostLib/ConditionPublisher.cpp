@@ -0,0 +1,156 @@
+// MIT License
+//
+// Copyright (c) 2022-2025 James Smith of OrangeFox86
+// https://github.com/OrangeFox86/DreamcastControllerUsbPico
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "ConditionPublisher.hpp"
+#include "MapleHexEncoder.hpp"
+
+#include <stdio.h>
+#include <string.h>
+
+static_assert(sizeof(DreamcastControllerObserver::ControllerCondition) == 2 * sizeof(uint32_t),
+              "A controller condition must be exactly 2 words");
+
+ConditionPublisher::ConditionPublisher(uint32_t playerIndex, DreamcastControllerObserver& observer) :
+    mPlayerIndex(playerIndex),
+    mObserver(observer),
+    mBinaryOutput(nullptr),
+    mSubscribed(false),
+    mConnected(false),
+    mLastValid(false),
+    mLastWords()
+{}
+
+void ConditionPublisher::setSubscribed(bool subscribed)
+{
+    mSubscribed = subscribed;
+    // Forces the next condition to be written
+    mLastValid = false;
+
+    if (mSubscribed && !mConnected)
+    {
+        writeDisconnected();
+    }
+}
+
+bool ConditionPublisher::isSubscribed() const
+{
+    return mSubscribed;
+}
+
+void ConditionPublisher::setBinaryOutput(BinaryOutput* binaryOutput)
+{
+    mBinaryOutput = binaryOutput;
+}
+
+void ConditionPublisher::setControllerCondition(const ControllerCondition& controllerCondition,
+                                                uint64_t receivedTimeUs)
+{
+    mObserver.setControllerCondition(controllerCondition, receivedTimeUs);
+
+    if (!mSubscribed)
+    {
+        return;
+    }
+
+    uint32_t words[2];
+    memcpy(words, &controllerCondition, sizeof(words));
+    if (mLastValid && words[0] == mLastWords[0] && words[1] == mLastWords[1])
+    {
+        return;
+    }
+
+    mLastWords[0] = words[0];
+    mLastWords[1] = words[1];
+    mLastValid = true;
+
+    if (mBinaryOutput != nullptr)
+    {
+        // <index><word LE><word LE>
+        uint8_t data[1 + sizeof(words)];
+        data[0] = static_cast<uint8_t>(mPlayerIndex);
+        for (uint32_t i = 0; i < 2; ++i)
+        {
+            for (uint32_t j = 0; j < 4; ++j)
+            {
+                data[1 + (i * 4) + j] = static_cast<uint8_t>(words[i] >> (j * 8));
+            }
+        }
+        mBinaryOutput->writeFrame(COMMAND_CHAR, data, sizeof(data));
+        return;
+    }
+
+    // $<index> <word> <word>\n
+    char text[1 + MapleHexEncoder::MAX_DECIMAL_LEN + 18 + 1];
+    char* end = text;
+    *end++ = '$';
+    end = MapleHexEncoder::encodeDecimal(mPlayerIndex, end);
+    *end++ = ' ';
+    end = MapleHexEncoder::encodeWord(words[0], end);
+    *end++ = ' ';
+    end = MapleHexEncoder::encodeWord(words[1], end);
+    *end++ = '\n';
+    fwrite(text, 1, end - text, stdout);
+}
+
+void ConditionPublisher::setSecondaryControllerCondition(
+    const SecondaryControllerCondition& secondaryControllerCondition)
+{
+    mObserver.setSecondaryControllerCondition(secondaryControllerCondition);
+}
+
+void ConditionPublisher::controllerConnected()
+{
+    mObserver.controllerConnected();
+    mConnected = true;
+    mLastValid = false;
+}
+
+void ConditionPublisher::controllerDisconnected()
+{
+    mObserver.controllerDisconnected();
+    mConnected = false;
+    mLastValid = false;
+
+    if (mSubscribed)
+    {
+        writeDisconnected();
+    }
+}
+
+LatencyHistogram* ConditionPublisher::getInputLatencyHistogram()
+{
+    return mObserver.getInputLatencyHistogram();
+}
+
+void ConditionPublisher::writeDisconnected()
+{
+    if (mBinaryOutput != nullptr)
+    {
+        uint8_t index = static_cast<uint8_t>(mPlayerIndex);
+        mBinaryOutput->writeFrame(COMMAND_CHAR, &index, 1);
+    }
+    else
+    {
+        printf("$%lu -\n", (long unsigned int)mPlayerIndex);
+    }
+}
@@ -0,0 +1,94 @@
+// MIT License
+//
+// Copyright (c) 2022-2025 James Smith of OrangeFox86
+// https://github.com/OrangeFox86/DreamcastControllerUsbPico
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include "hal/Usb/DreamcastControllerObserver.hpp"
+#include "hal/Usb/CommandParser.hpp"
+
+#include <stdint.h>
+
+//! Passes everything through to a player's USB controller observer, and when subscribed, also
+//! writes a condition record each time the controller condition changes
+//!
+//! This lets an emulator receive input from the polling which is already done for USB instead of
+//! sending its own condition requests. In text mode, records are single lines written to stdout:
+//!   $<player index> <word 1> <word 2>   - the 2 condition words of a GET_CONDITION response
+//!   $<player index> -                   - the controller was disconnected
+//! In binary mode, records are '$' frames written to the binary output instead:
+//!   <player index:8><word 1:32 LE><word 2:32 LE>
+//!   <player index:8>                    - the controller was disconnected
+//! When a subscription starts, the next condition received is always written, or the disconnected
+//! record is written right away if no controller is connected.
+class ConditionPublisher : public DreamcastControllerObserver
+{
+    public:
+        //! Constructor
+        //! @param[in] playerIndex  Index of the player written in each record
+        //! @param[in] observer  The observer to pass everything through to
+        ConditionPublisher(uint32_t playerIndex, DreamcastControllerObserver& observer);
+
+        //! Starts or stops writing condition records
+        //! @param[in] subscribed  true to write a record on each change
+        void setSubscribed(bool subscribed);
+
+        //! @returns true iff condition records are being written
+        bool isSubscribed() const;
+
+        //! Sets where records are framed while the stream is in binary mode
+        //! @param[in] binaryOutput  The binary output, or nullptr to write text lines to stdout
+        void setBinaryOutput(BinaryOutput* binaryOutput);
+
+        //! DreamcastControllerObserver overrides
+        void setControllerCondition(const ControllerCondition& controllerCondition,
+                                    uint64_t receivedTimeUs) final;
+        void setSecondaryControllerCondition(
+            const SecondaryControllerCondition& secondaryControllerCondition) final;
+        void controllerConnected() final;
+        void controllerDisconnected() final;
+        LatencyHistogram* getInputLatencyHistogram() final;
+
+    private:
+        //! Writes the record which indicates that no controller is connected
+        void writeDisconnected();
+
+    public:
+        //! The command character of binary condition frames
+        static const char COMMAND_CHAR = '$';
+
+    private:
+        //! Index of the player written in each record
+        const uint32_t mPlayerIndex;
+        //! The observer which everything is passed through to
+        DreamcastControllerObserver& mObserver;
+        //! Where records are framed in binary mode, or nullptr in text mode
+        BinaryOutput* mBinaryOutput;
+        //! true when records are written
+        bool mSubscribed;
+        //! true while a controller is connected
+        bool mConnected;
+        //! true when mLastWords holds the last condition written
+        bool mLastValid;
+        //! The condition words of the last record written
+        uint32_t mLastWords[2];
+};
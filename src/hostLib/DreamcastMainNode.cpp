@@ -26,10 +26,14 @@
 #include "dreamcast_constants.h"
 #include "DreamcastController.hpp"
 #include "EndpointTxScheduler.hpp"
+#include "HeapStats.hpp"
+#include "BackoffProbePolicy.hpp"
+#include "configuration.h"
 
 DreamcastMainNode::DreamcastMainNode(MapleBusInterface& bus,
                                      PlayerData playerData,
-                                     std::shared_ptr<PrioritizedTxScheduler> prioritizedTxScheduler) :
+                                     std::shared_ptr<PrioritizedTxScheduler> prioritizedTxScheduler,
+                                     std::shared_ptr<ProbePolicyInterface> probePolicy) :
     DreamcastNode(DreamcastPeripheral::MAIN_PERIPHERAL_ADDR_MASK,
                   std::make_shared<EndpointTxScheduler>(
                     prioritizedTxScheduler,
@@ -42,9 +46,26 @@ DreamcastMainNode::DreamcastMainNode(MapleBusInterface& bus,
     mTransmissionTimeliner(bus, prioritizedTxScheduler),
     mScheduleId(-1),
     mCommFailCount(0),
-    mPrintSummary(false)
+    mPrintSummary(false),
+    mLastTaskAllocationCount(0),
+    mMaxTaskAllocationCount(0),
+    mLastResponseTimeUs(0),
+    mEnumerationPending(true),
+    mEnumerationStartUs(0),
+    mReady(false),
+    mTimeToReadyUs(0),
+    mProbePolicy(probePolicy)
 {
-    addInfoRequestToSchedule();
+    if (!mProbePolicy)
+    {
+        // (casts keep the class constants from being bound to references)
+        mProbePolicy = std::make_shared<BackoffProbePolicy>(
+            (uint32_t)FAST_ENUMERATION_US_PER_CHECK,
+            (uint32_t)(FAST_ENUMERATION_DURATION_US / FAST_ENUMERATION_US_PER_CHECK),
+            (uint32_t)US_PER_CHECK,
+            (uint32_t)EMPTY_PORT_PROBE_MAX_INTERVAL_US);
+    }
+
     mSubNodes.reserve(DreamcastPeripheral::MAX_SUB_PERIPHERALS);
     for (uint32_t i = 0; i < DreamcastPeripheral::MAX_SUB_PERIPHERALS; ++i)
     {
@@ -62,8 +83,8 @@ DreamcastMainNode::DreamcastMainNode(MapleBusInterface& bus,
 DreamcastMainNode::~DreamcastMainNode()
 {}
 
-void DreamcastMainNode::txComplete(std::shared_ptr<const MaplePacket> packet,
-                                   std::shared_ptr<const Transmission> tx)
+void DreamcastMainNode::txComplete(const std::shared_ptr<const MaplePacket>& packet,
+                                   const std::shared_ptr<const Transmission>& tx)
 {
     // Handle device info from main peripheral
     if (packet != nullptr && packet->frame.command == COMMAND_RESPONSE_DEVICE_INFO)
@@ -107,7 +128,9 @@ void DreamcastMainNode::disconnectMainPeripheral(uint64_t currentTimeUs)
     {
         (*iter)->mainPeripheralDisconnected();
     }
-    addInfoRequestToSchedule(currentTimeUs);
+    startEnumeration(currentTimeUs);
+    // Time to ready after hot plug is measured from when the main peripheral is detected
+    mEnumerationStartUs = 0;
     DEBUG_PRINT("P%lu disconnected\n", mPlayerData.playerIndex + 1);
 }
 
@@ -139,6 +162,9 @@ void DreamcastMainNode::readTask(uint64_t currentTimeUs)
             if (sendAddr & mAddr)
             {
                 // This was meant for the main node or one of the main node's peripherals
+                // Any response from the main peripheral serves as its heartbeat
+                mLastResponseTimeUs = currentTimeUs;
+
                 // Use the sender address to determine what sub peripherals are connected
                 for (std::vector<std::shared_ptr<DreamcastSubNode>>::iterator iter = mSubNodes.begin();
                      iter != mSubNodes.end();
@@ -157,7 +183,9 @@ void DreamcastMainNode::readTask(uint64_t currentTimeUs)
         Transmitter* transmitter = readStatus.transmission->transmitter;
         if (transmitter != nullptr)
         {
-            transmitter->txComplete(readStatus.received, readStatus.transmission);
+            uint64_t receivedTimeUs =
+                (readStatus.receivedTimeUs != 0) ? readStatus.receivedTimeUs : currentTimeUs;
+            transmitter->txCompleteAt(readStatus.received, readStatus.transmission, receivedTimeUs);
         }
     }
     else if (readStatus.busPhase == MapleBusInterface::Phase::WRITE_COMPLETE)
@@ -181,6 +209,14 @@ void DreamcastMainNode::readTask(uint64_t currentTimeUs)
                                     readStatus.transmission);
         }
 
+        if (readStatus.busPhase == MapleBusInterface::Phase::READ_FAILED
+            && readStatus.failureReason != MapleBusInterface::FailureReason::TIMEOUT
+            && mPeripherals.empty())
+        {
+            // Something drove the line on an empty port - something may be getting plugged in
+            lineActivityOnEmptyPort();
+        }
+
         uint8_t recipientAddr = readStatus.transmission->packet->frame.recipientAddr;
         if ((recipientAddr & mAddr) && ++mCommFailCount >= MAX_FAILURE_DISCONNECT_COUNT)
         {
@@ -199,6 +235,27 @@ void DreamcastMainNode::readTask(uint64_t currentTimeUs)
 
 void DreamcastMainNode::runDependentTasks(uint64_t currentTimeUs)
 {
+    // Controller polling must leave enough room between polls for the longest transaction that any
+    // other peripheral on this bus may schedule, including identification of a newly inserted one
+    const uint32_t deviceInfoRequestUs =
+        PrioritizedTxScheduler::computeTxDurationUs(0, true, EXPECTED_DEVICE_INFO_PAYLOAD_WORDS);
+    uint32_t reservedUs = getLongestPeripheralTransactionUs();
+    for (std::vector<std::shared_ptr<DreamcastSubNode>>::iterator iter = mSubNodes.begin();
+            iter != mSubNodes.end();
+            ++iter)
+    {
+        uint32_t durationUs = (*iter)->getLongestPeripheralTransactionUs();
+        if ((*iter)->isEnumerating() && durationUs < deviceInfoRequestUs)
+        {
+            durationUs = deviceInfoRequestUs;
+        }
+        if (durationUs > reservedUs)
+        {
+            reservedUs = durationUs;
+        }
+    }
+    mPlayerData.pollSettings.setReservedBusTimeUs(reservedUs);
+
     // Have the connected main peripheral and sub nodes handle their tasks
     handlePeripherals(currentTimeUs);
 
@@ -209,10 +266,21 @@ void DreamcastMainNode::runDependentTasks(uint64_t currentTimeUs)
         (*iter)->task(currentTimeUs);
     }
 
+    if (mEnumerationPending)
+    {
+        mEnumerationPending = false;
+        startEnumeration(currentTimeUs);
+    }
+
     if (mPeripherals.size() > 0)
     {
-        // The main node peripheral MUST have a recurring transmission in order to test for heartbeat
-        if (mEndpointTxScheduler->countRecipients(getRecipientAddress()) == 0)
+        checkReady(currentTimeUs);
+
+        // Responses to regular traffic (ex: controller condition) serve as heartbeat; only explicitly
+        // check for the main peripheral once it's been quiet for a while (this also keeps the sub
+        // peripheral connection states fresh)
+        if (currentTimeUs - mLastResponseTimeUs >= HEARTBEAT_SILENCE_US
+            && mEndpointTxScheduler->countRecipients(getRecipientAddress()) == 0)
         {
             uint64_t txTime = PrioritizedTxScheduler::computeNextTimeCadence(currentTimeUs, US_PER_CHECK);
             mEndpointTxScheduler->add(
@@ -225,6 +293,21 @@ void DreamcastMainNode::runDependentTasks(uint64_t currentTimeUs)
                 EXPECTED_DEVICE_INFO_PAYLOAD_WORDS);
         }
     }
+    else
+    {
+        if (mEnumerationStartUs != 0
+            && currentTimeUs - mEnumerationStartUs >= FAST_ENUMERATION_DURATION_US)
+        {
+            // Nothing found right away - measure time to ready from detection instead
+            mEnumerationStartUs = 0;
+        }
+
+        if (mEndpointTxScheduler->countRecipients(getRecipientAddress()) == 0)
+        {
+            // Last probe went out - the policy decides when the next one goes out
+            addInfoRequestToSchedule(currentTimeUs + mProbePolicy->nextProbeIntervalUs());
+        }
+    }
 
     // Summary is printed here for safety
     if (mPrintSummary)
@@ -263,18 +346,21 @@ void DreamcastMainNode::writeTask(uint64_t currentTimeUs)
 
 void DreamcastMainNode::task(uint64_t currentTimeUs)
 {
+    uint32_t startAllocationCount = heap_stats_total_allocations();
+
     readTask(currentTimeUs);
     runDependentTasks(currentTimeUs);
     writeTask(currentTimeUs);
-}
 
-void DreamcastMainNode::addInfoRequestToSchedule(uint64_t currentTimeUs)
-{
-    uint64_t txTime = PrioritizedTxScheduler::TX_TIME_ASAP;
-    if (currentTimeUs > 0)
+    mLastTaskAllocationCount = heap_stats_total_allocations() - startAllocationCount;
+    if (mLastTaskAllocationCount > mMaxTaskAllocationCount)
     {
-        txTime = PrioritizedTxScheduler::computeNextTimeCadence(currentTimeUs, US_PER_CHECK);
+        mMaxTaskAllocationCount = mLastTaskAllocationCount;
     }
+}
+
+void DreamcastMainNode::addInfoRequestToSchedule(uint64_t txTime)
+{
     mScheduleId = mEndpointTxScheduler->add(
         txTime,
         this,
@@ -282,6 +368,53 @@ void DreamcastMainNode::addInfoRequestToSchedule(uint64_t currentTimeUs)
         nullptr,
         0,
         true,
-        EXPECTED_DEVICE_INFO_PAYLOAD_WORDS,
-        US_PER_CHECK);
+        EXPECTED_DEVICE_INFO_PAYLOAD_WORDS);
+}
+
+void DreamcastMainNode::startEnumeration(uint64_t currentTimeUs)
+{
+    mEnumerationStartUs = currentTimeUs;
+    mReady = false;
+    mProbePolicy->reset();
+    addInfoRequestToSchedule(PrioritizedTxScheduler::TX_TIME_ASAP);
+}
+
+void DreamcastMainNode::lineActivityOnEmptyPort()
+{
+    mProbePolicy->reset();
+    if (mScheduleId >= 0)
+    {
+        mEndpointTxScheduler->cancelById(mScheduleId);
+    }
+    addInfoRequestToSchedule(PrioritizedTxScheduler::TX_TIME_ASAP);
+}
+
+void DreamcastMainNode::checkReady(uint64_t currentTimeUs)
+{
+    if (mReady)
+    {
+        return;
+    }
+
+    if (mEnumerationStartUs == 0)
+    {
+        // Hot plug - the main peripheral was just detected
+        mEnumerationStartUs = currentTimeUs;
+    }
+
+    for (std::vector<std::shared_ptr<DreamcastSubNode>>::iterator iter = mSubNodes.begin();
+         iter != mSubNodes.end();
+         ++iter)
+    {
+        if ((*iter)->isEnumerating())
+        {
+            return;
+        }
+    }
+
+    mReady = true;
+    mTimeToReadyUs = currentTimeUs - mEnumerationStartUs;
+    DEBUG_PRINT("P%lu ready in %lu us\n",
+                mPlayerData.playerIndex + 1,
+                (long unsigned int)mTimeToReadyUs);
 }
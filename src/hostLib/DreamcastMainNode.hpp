@@ -28,6 +28,7 @@
 #include "hal/MapleBus/MapleBusInterface.hpp"
 #include "DreamcastPeripheral.hpp"
 #include "TransmissionTimeliner.hpp"
+#include "ProbePolicyInterface.hpp"
 
 #include <memory>
 #include <vector>
@@ -41,9 +42,13 @@ class DreamcastMainNode : public DreamcastNode
         //! Constructor
         //! @param[in] bus  The bus on which this node communicates
         //! @param[in] playerData  The player data passed to any connected peripheral
+        //! @param[in] prioritizedTxScheduler  The schedule which feeds the bus
+        //! @param[in] probePolicy  Decides how often to probe while nothing is connected (nullptr
+        //!                         selects BackoffProbePolicy using EMPTY_PORT_PROBE_MAX_INTERVAL_US)
         DreamcastMainNode(MapleBusInterface& bus,
                           PlayerData playerData,
-                          std::shared_ptr<PrioritizedTxScheduler> prioritizedTxScheduler);
+                          std::shared_ptr<PrioritizedTxScheduler> prioritizedTxScheduler,
+                          std::shared_ptr<ProbePolicyInterface> probePolicy = nullptr);
 
         //! Virtual destructor
         virtual ~DreamcastMainNode();
@@ -52,18 +57,18 @@ class DreamcastMainNode : public DreamcastNode
         virtual void task(uint64_t currentTimeUs) final;
 
         //! Inherited from DreamcastNode
-        virtual inline void txStarted(std::shared_ptr<const Transmission> tx) final
+        virtual inline void txStarted(const std::shared_ptr<const Transmission>& tx) final
         {}
 
         //! Inherited from DreamcastNode
         virtual inline void txFailed(bool writeFailed,
                                      bool readFailed,
-                                     std::shared_ptr<const Transmission> tx) final
+                                     const std::shared_ptr<const Transmission>& tx) final
         {}
 
         //! Inherited from DreamcastNode
-        virtual void txComplete(std::shared_ptr<const MaplePacket> packet,
-                                std::shared_ptr<const Transmission> tx) final;
+        virtual void txComplete(const std::shared_ptr<const MaplePacket>& packet,
+                                const std::shared_ptr<const Transmission>& tx) final;
 
         //! Called when the main peripheral needs to be disconnected
         //! @param[in] currentTimeUs  The current time as number of microseconds
@@ -72,6 +77,33 @@ class DreamcastMainNode : public DreamcastNode
         //! Prints summary of all devices
         void printSummary();
 
+        //! @returns true iff a main peripheral is currently connected
+        inline bool isMainPeripheralConnected() const
+        {
+            return !mPeripherals.empty();
+        }
+
+        //! @returns the number of heap allocations made during the last call to task()
+        //!          (always 0 unless heap stats are enabled)
+        inline uint32_t getLastTaskAllocationCount() const
+        {
+            return mLastTaskAllocationCount;
+        }
+
+        //! @returns the highest number of heap allocations made during a single call to task()
+        inline uint32_t getMaxTaskAllocationCount() const
+        {
+            return mMaxTaskAllocationCount;
+        }
+
+        //! @returns the number of microseconds it took from the start of the last enumeration until
+        //!          the main peripheral and all of its sub peripherals were identified or 0 if
+        //!          enumeration hasn't completed yet
+        inline uint64_t getTimeToReadyUs() const
+        {
+            return mTimeToReadyUs;
+        }
+
     private:
         //! Execute and process read task from the timeliner
         //! @param[in] currentTimeUs  The current time in microseconds
@@ -85,14 +117,33 @@ class DreamcastMainNode : public DreamcastNode
         //! @param[in] currentTimeUs  The current time in microseconds
         void writeTask(uint64_t currentTimeUs);
 
-        //! Adds an auto reload info request to the transmission schedule
-        void addInfoRequestToSchedule(uint64_t currentTimeUs = 0);
+        //! Adds a single info request (probe) to the transmission schedule
+        //! @param[in] txTime  Time at which the probe should transmit
+        void addInfoRequestToSchedule(uint64_t txTime);
+
+        //! Begins quickly probing for the main peripheral and starts the time to ready measurement
+        //! @param[in] currentTimeUs  The current time in microseconds
+        void startEnumeration(uint64_t currentTimeUs);
+
+        //! Restarts the probe policy and probes right away
+        void lineActivityOnEmptyPort();
+
+        //! Records time to ready once the main peripheral and all sub peripherals are identified
+        //! @param[in] currentTimeUs  The current time in microseconds
+        void checkReady(uint64_t currentTimeUs);
 
     public:
         //! Number of microseconds in between each info request when no peripheral is detected
         static const uint32_t US_PER_CHECK = 16000;
         //! Number of communication failures before main peripheral is disconnected
         static const uint32_t MAX_FAILURE_DISCONNECT_COUNT = 3;
+        //! Number of microseconds without any response from the main peripheral before a device info
+        //! request is sent to check that it's still there
+        static const uint32_t HEARTBEAT_SILENCE_US = 50000;
+        //! Number of microseconds in between each info request right after boot or disconnect
+        static const uint32_t FAST_ENUMERATION_US_PER_CHECK = 2000;
+        //! Number of microseconds to probe at the fast rate before backing off
+        static const uint32_t FAST_ENUMERATION_DURATION_US = 250000;
 
     protected:
         //! The sub nodes under this node
@@ -105,4 +156,20 @@ class DreamcastMainNode : public DreamcastNode
         uint32_t mCommFailCount;
         //! Print summary on next cycle when true
         bool mPrintSummary;
+        //! Number of heap allocations made during the last call to task()
+        uint32_t mLastTaskAllocationCount;
+        //! Highest number of heap allocations made during a single call to task()
+        uint32_t mMaxTaskAllocationCount;
+        //! Time of the last response received from the main peripheral
+        uint64_t mLastResponseTimeUs;
+        //! Set until the first call to task() which then starts enumeration
+        bool mEnumerationPending;
+        //! Time at which enumeration started or 0 when it starts at next main peripheral detection
+        uint64_t mEnumerationStartUs;
+        //! true once the main peripheral and all sub peripherals have been identified
+        bool mReady;
+        //! Duration of the last enumeration in microseconds (0 if not yet complete)
+        uint64_t mTimeToReadyUs;
+        //! Decides how often to probe while nothing is connected
+        std::shared_ptr<ProbePolicyInterface> mProbePolicy;
 };
\ No newline at end of file
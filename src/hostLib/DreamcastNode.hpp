@@ -88,6 +88,22 @@ class DreamcastNode : public Transmitter
             printf("}");
         }
 
+        //! @returns estimated bus time of the longest transaction any of this node's peripherals
+        //!          may schedule in microseconds
+        uint32_t getLongestPeripheralTransactionUs()
+        {
+            uint32_t longestUs = 0;
+            for (const std::shared_ptr<DreamcastPeripheral>& periph : mPeripherals)
+            {
+                uint32_t durationUs = periph->getLongestTransactionUs();
+                if (durationUs > longestUs)
+                {
+                    longestUs = durationUs;
+                }
+            }
+            return longestUs;
+        }
+
     protected:
         //! Main constructor with scheduler
         DreamcastNode(uint8_t addr,
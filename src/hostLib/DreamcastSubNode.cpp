@@ -41,8 +41,8 @@ DreamcastSubNode::DreamcastSubNode(const DreamcastSubNode& rhs) :
 {
 }
 
-void DreamcastSubNode::txComplete(std::shared_ptr<const MaplePacket> packet,
-                                  std::shared_ptr<const Transmission> tx)
+void DreamcastSubNode::txComplete(const std::shared_ptr<const MaplePacket>& packet,
+                                  const std::shared_ptr<const Transmission>& tx)
 {
     // If device info received, add the sub peripheral
     if (packet->frame.command == COMMAND_RESPONSE_DEVICE_INFO)
@@ -82,6 +82,20 @@ void DreamcastSubNode::task(uint64_t currentTimeUs)
 {
     if (mConnected)
     {
+        if (mScheduleId >= 0 && mEndpointTxScheduler->countRecipients(getRecipientAddress()) == 0)
+        {
+            // Fast enumeration period elapsed without identification - fall back to normal cadence
+            mScheduleId = mEndpointTxScheduler->add(
+                PrioritizedTxScheduler::computeNextTimeCadence(currentTimeUs, US_PER_CHECK),
+                this,
+                COMMAND_DEVICE_INFO_REQUEST,
+                nullptr,
+                0,
+                true,
+                EXPECTED_DEVICE_INFO_PAYLOAD_WORDS,
+                US_PER_CHECK);
+        }
+
         // Handle operations for peripherals (run task() of all peripherals)
         if (mPeripherals.size() > 0)
         {
@@ -105,24 +119,29 @@ void DreamcastSubNode::setConnected(bool connected, uint64_t currentTimeUs)
         mEndpointTxScheduler->cancelByRecipient(getRecipientAddress());
         if (mConnected)
         {
-            // Keep asking for info until valid response is heard
-            uint64_t txTime = PrioritizedTxScheduler::TX_TIME_ASAP;
+            // Ask right away, in the same burst as any other newly detected slot, and keep asking
+            // quickly for a while until valid response is heard
+            uint32_t autoRepeatUs = US_PER_CHECK;
+            uint64_t autoRepeatEndTimeUs = 0;
             if (currentTimeUs > 0)
             {
-                txTime = PrioritizedTxScheduler::computeNextTimeCadence(currentTimeUs, US_PER_CHECK);
+                autoRepeatUs = FAST_ENUMERATION_US_PER_CHECK;
+                autoRepeatEndTimeUs = currentTimeUs + FAST_ENUMERATION_DURATION_US;
             }
             mScheduleId = mEndpointTxScheduler->add(
-                txTime,
+                PrioritizedTxScheduler::TX_TIME_ASAP,
                 this,
                 COMMAND_DEVICE_INFO_REQUEST,
                 nullptr,
                 0,
                 true,
                 EXPECTED_DEVICE_INFO_PAYLOAD_WORDS,
-                US_PER_CHECK);
+                autoRepeatUs,
+                autoRepeatEndTimeUs);
         }
         else
         {
+            mScheduleId = -1;
             DEBUG_PRINT("P%lu-%li disconnected\n",
                         mPlayerData.playerIndex + 1,
                         DreamcastPeripheral::subPeripheralIndex(mAddr) + 1);
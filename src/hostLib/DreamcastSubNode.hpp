@@ -41,18 +41,18 @@ class DreamcastSubNode : public DreamcastNode
         DreamcastSubNode(const DreamcastSubNode& rhs);
 
         //! Inherited from DreamcastNode
-        virtual inline void txStarted(std::shared_ptr<const Transmission> tx)
+        virtual inline void txStarted(const std::shared_ptr<const Transmission>& tx)
         {}
 
         //! Inherited from DreamcastNode
         virtual inline void txFailed(bool writeFailed,
                                      bool readFailed,
-                                     std::shared_ptr<const Transmission> tx)
+                                     const std::shared_ptr<const Transmission>& tx)
         {}
 
         //! Inherited from DreamcastNode
-        virtual void txComplete(std::shared_ptr<const MaplePacket> packet,
-                                std::shared_ptr<const Transmission> tx);
+        virtual void txComplete(const std::shared_ptr<const MaplePacket>& packet,
+                                const std::shared_ptr<const Transmission>& tx);
 
         //! Inherited from DreamcastNode
         virtual void task(uint64_t currentTimeUs);
@@ -64,9 +64,19 @@ class DreamcastSubNode : public DreamcastNode
         //! Called from the main node to update the connection state of peripherals on this sub node
         virtual void setConnected(bool connected, uint64_t currentTimeUs = 0);
 
+        //! @returns true iff a sub peripheral is connected but hasn't been identified yet
+        inline bool isEnumerating() const
+        {
+            return (mConnected && mScheduleId >= 0);
+        }
+
     protected:
         //! Number of microseconds in between each info request when no peripheral is detected
         static const uint32_t US_PER_CHECK = 16000;
+        //! Number of microseconds in between each info request right after connection
+        static const uint32_t FAST_ENUMERATION_US_PER_CHECK = 2000;
+        //! Number of microseconds to probe at the fast rate before falling back to US_PER_CHECK
+        static const uint32_t FAST_ENUMERATION_DURATION_US = 250000;
         //! Detected peripheral connection state
         bool mConnected;
         //! ID of the device info request auto reload transmission this object added to the schedule
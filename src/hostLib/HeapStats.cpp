@@ -0,0 +1,184 @@
+// MIT License
+//
+// Copyright (c) 2022-2025 James Smith of OrangeFox86
+// https://github.com/OrangeFox86/DreamcastControllerUsbPico
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "HeapStats.hpp"
+#include "hal/System/LockGuard.hpp"
+#include "configuration.h"
+
+#include <stdlib.h>
+#include <new>
+
+#if HEAP_STATS_ENABLED && !defined(UNITTEST) && !PICO_CXX_DISABLE_ALLOCATION_OVERRIDES
+#error "HEAP_STATS_ENABLED requires PICO_CXX_DISABLE_ALLOCATION_OVERRIDES; configure with -DHEAP_STATS_ENABLED=ON"
+#endif
+
+#if HEAP_STATS_ENABLED || defined(UNITTEST)
+
+// Each allocation is prefixed with a header which holds its size; this keeps 8-byte alignment
+static const size_t HEADER_SIZE = 8;
+
+static HeapStats heapStats = {};
+static MutexInterface* heapStatsMutex = nullptr;
+
+static void* counted_alloc(size_t size)
+{
+    uint8_t* block = static_cast<uint8_t*>(malloc(size + HEADER_SIZE));
+    if (block == nullptr)
+    {
+        abort();
+    }
+    *reinterpret_cast<size_t*>(block) = size;
+
+    if (heapStatsMutex != nullptr)
+    {
+        LockGuard lock(*heapStatsMutex);
+        heapStats.liveBytes += size;
+        ++heapStats.liveAllocations;
+        ++heapStats.totalAllocations;
+        if (heapStats.liveBytes > heapStats.peakBytes)
+        {
+            heapStats.peakBytes = heapStats.liveBytes;
+        }
+    }
+    else
+    {
+        heapStats.liveBytes += size;
+        ++heapStats.liveAllocations;
+        ++heapStats.totalAllocations;
+        if (heapStats.liveBytes > heapStats.peakBytes)
+        {
+            heapStats.peakBytes = heapStats.liveBytes;
+        }
+    }
+
+    return block + HEADER_SIZE;
+}
+
+static void counted_free(void* ptr)
+{
+    if (ptr == nullptr)
+    {
+        return;
+    }
+
+    uint8_t* block = static_cast<uint8_t*>(ptr) - HEADER_SIZE;
+    size_t size = *reinterpret_cast<size_t*>(block);
+
+    if (heapStatsMutex != nullptr)
+    {
+        LockGuard lock(*heapStatsMutex);
+        heapStats.liveBytes -= size;
+        --heapStats.liveAllocations;
+    }
+    else
+    {
+        heapStats.liveBytes -= size;
+        --heapStats.liveAllocations;
+    }
+
+    free(block);
+}
+
+void* operator new(size_t size)
+{
+    return counted_alloc(size);
+}
+
+void* operator new[](size_t size)
+{
+    return counted_alloc(size);
+}
+
+void operator delete(void* ptr) noexcept
+{
+    counted_free(ptr);
+}
+
+void operator delete[](void* ptr) noexcept
+{
+    counted_free(ptr);
+}
+
+void operator delete(void* ptr, size_t size) noexcept
+{
+    counted_free(ptr);
+}
+
+void operator delete[](void* ptr, size_t size) noexcept
+{
+    counted_free(ptr);
+}
+
+HeapStats heap_stats_get()
+{
+    if (heapStatsMutex != nullptr)
+    {
+        LockGuard lock(*heapStatsMutex);
+        return heapStats;
+    }
+    return heapStats;
+}
+
+uint32_t heap_stats_total_allocations()
+{
+    // Single word read - no need to lock
+    return heapStats.totalAllocations;
+}
+
+void heap_stats_reset_peak()
+{
+    if (heapStatsMutex != nullptr)
+    {
+        LockGuard lock(*heapStatsMutex);
+        heapStats.peakBytes = heapStats.liveBytes;
+    }
+    else
+    {
+        heapStats.peakBytes = heapStats.liveBytes;
+    }
+}
+
+void heap_stats_set_mutex(MutexInterface* mutex)
+{
+    heapStatsMutex = mutex;
+}
+
+#else
+
+HeapStats heap_stats_get()
+{
+    return HeapStats{};
+}
+
+uint32_t heap_stats_total_allocations()
+{
+    return 0;
+}
+
+void heap_stats_reset_peak()
+{}
+
+void heap_stats_set_mutex(MutexInterface* mutex)
+{}
+
+#endif
@@ -27,6 +27,8 @@
 #include "hal/System/ClockInterface.hpp"
 #include "ScreenData.hpp"
 #include "hal/Usb/UsbFileSystem.hpp"
+#include "PollSettings.hpp"
+#include "ConditionPublisher.hpp"
 
 //! Contains data that is tied to a specific player
 struct PlayerData
@@ -36,16 +38,23 @@ struct PlayerData
     ScreenData& screenData;
     ClockInterface& clock;
     UsbFileSystem& fileSystem;
+    PollSettings& pollSettings;
+    //! Publisher of condition changes (also set as gamepad) or nullptr if not available
+    ConditionPublisher* const conditionPublisher;
 
     PlayerData(uint32_t playerIndex,
                DreamcastControllerObserver& gamepad,
                ScreenData& screenData,
                ClockInterface& clock,
-               UsbFileSystem& fileSystem) :
+               UsbFileSystem& fileSystem,
+               PollSettings& pollSettings,
+               ConditionPublisher* conditionPublisher = nullptr) :
         playerIndex(playerIndex),
         gamepad(gamepad),
         screenData(screenData),
         clock(clock),
-        fileSystem(fileSystem)
+        fileSystem(fileSystem),
+        pollSettings(pollSettings),
+        conditionPublisher(conditionPublisher)
     {}
 };
\ No newline at end of file
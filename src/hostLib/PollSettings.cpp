@@ -0,0 +1,198 @@
+// MIT License
+//
+// Copyright (c) 2022-2025 James Smith of OrangeFox86
+// https://github.com/OrangeFox86/DreamcastControllerUsbPico
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "PollSettings.hpp"
+#include "PrioritizedTxScheduler.hpp"
+#include "utils.h"
+
+PollSettings::PollSettings(const UsbFrameTiming* frameTiming) :
+    mFrameTiming(frameTiming),
+    mFrameAligned(false),
+    mRequestedControllerPeriodUs(DEFAULT_CONTROLLER_PERIOD_US),
+    mReservedBusTimeUs(0),
+    mMeasuredControllerPeriodUs(0),
+    mEmulatorFramePeriodUs(0),
+    mEmulatorReadPhaseUs(0),
+    mEmulatorFrameReportedUs(0),
+    mMeanAlignmentErrorUs(0),
+    mMaxAlignmentErrorUs(0)
+{}
+
+bool PollSettings::requestControllerPeriodUs(uint32_t periodUs)
+{
+    if (periodUs > MAX_CONTROLLER_PERIOD_US || periodUs < getMinControllerPeriodUs())
+    {
+        return false;
+    }
+
+    mRequestedControllerPeriodUs = periodUs;
+    return true;
+}
+
+uint32_t PollSettings::getRequestedControllerPeriodUs() const
+{
+    return mRequestedControllerPeriodUs;
+}
+
+uint32_t PollSettings::getMinControllerPeriodUs() const
+{
+    // The scheduler only lets a lower priority transmission through when it completes before the
+    // next poll is due, so the gap between polls must fit the longest of those transmissions
+    uint32_t minPeriodUs = getControllerPollDurationUs() + mReservedBusTimeUs;
+    if (minPeriodUs < MIN_CONTROLLER_PERIOD_US)
+    {
+        minPeriodUs = MIN_CONTROLLER_PERIOD_US;
+    }
+    return minPeriodUs;
+}
+
+uint32_t PollSettings::getEffectiveControllerPeriodUs() const
+{
+    uint32_t periodUs = mRequestedControllerPeriodUs;
+    uint32_t minPeriodUs = getMinControllerPeriodUs();
+    if (periodUs < minPeriodUs)
+    {
+        periodUs = minPeriodUs;
+    }
+
+    if (mFrameAligned)
+    {
+        // Keep every poll on the same point of a frame
+        periodUs = INT_DIVIDE_CEILING(periodUs, UsbFrameTiming::FRAME_PERIOD_US)
+                   * UsbFrameTiming::FRAME_PERIOD_US;
+    }
+
+    return periodUs;
+}
+
+void PollSettings::setReservedBusTimeUs(uint32_t reservedUs)
+{
+    mReservedBusTimeUs = reservedUs;
+}
+
+uint32_t PollSettings::getMeasuredControllerPeriodUs() const
+{
+    return mMeasuredControllerPeriodUs;
+}
+
+void PollSettings::setMeasuredControllerPeriodUs(uint32_t periodUs)
+{
+    mMeasuredControllerPeriodUs = periodUs;
+}
+
+bool PollSettings::setFrameAligned(bool aligned)
+{
+    if (aligned && mFrameTiming == nullptr)
+    {
+        return false;
+    }
+
+    mFrameAligned = aligned;
+    return true;
+}
+
+bool PollSettings::isFrameAligned() const
+{
+    return mFrameAligned;
+}
+
+const UsbFrameTiming* PollSettings::getFrameTiming() const
+{
+    return mFrameTiming;
+}
+
+bool PollSettings::setEmulatorFrame(uint32_t periodUs, uint64_t readTimeUs, uint64_t currentTimeUs)
+{
+    if (periodUs > MAX_CONTROLLER_PERIOD_US || periodUs < getMinControllerPeriodUs())
+    {
+        return false;
+    }
+
+    // Period is stored last so that a set period is never seen with the phase of another period
+    mEmulatorFramePeriodUs = 0;
+    mEmulatorReadPhaseUs = readTimeUs % periodUs;
+    mEmulatorFrameReportedUs = static_cast<uint32_t>(currentTimeUs);
+    mEmulatorFramePeriodUs = periodUs;
+    return true;
+}
+
+void PollSettings::clearEmulatorFrame()
+{
+    mEmulatorFramePeriodUs = 0;
+}
+
+bool PollSettings::getEmulatorFrame(uint64_t currentTimeUs, uint32_t& periodUs, uint32_t& readPhaseUs)
+{
+    periodUs = mEmulatorFramePeriodUs;
+    if (periodUs == 0)
+    {
+        return false;
+    }
+
+    // Cleared here (before the 32-bit report time can wrap) when the emulator stops reporting
+    uint32_t sinceReportUs = static_cast<uint32_t>(currentTimeUs) - mEmulatorFrameReportedUs;
+    if (sinceReportUs > EMULATOR_FRAME_STALE_US)
+    {
+        mEmulatorFramePeriodUs = 0;
+        periodUs = 0;
+        return false;
+    }
+
+    readPhaseUs = mEmulatorReadPhaseUs;
+    return true;
+}
+
+void PollSettings::setAlignmentErrorUs(int32_t meanUs, uint32_t maxUs)
+{
+    mMeanAlignmentErrorUs = meanUs;
+    mMaxAlignmentErrorUs = maxUs;
+}
+
+int32_t PollSettings::getMeanAlignmentErrorUs() const
+{
+    return mMeanAlignmentErrorUs;
+}
+
+uint32_t PollSettings::getMaxAlignmentErrorUs() const
+{
+    return mMaxAlignmentErrorUs;
+}
+
+int32_t PollSettings::phaseDeltaUs(uint32_t a, uint32_t b, uint32_t periodUs)
+{
+    int32_t deltaUs = static_cast<int32_t>(a) - static_cast<int32_t>(b);
+    if (deltaUs >= static_cast<int32_t>(periodUs / 2))
+    {
+        deltaUs -= periodUs;
+    }
+    else if (deltaUs < -static_cast<int32_t>(periodUs / 2))
+    {
+        deltaUs += periodUs;
+    }
+    return deltaUs;
+}
+
+uint32_t PollSettings::getControllerPollDurationUs()
+{
+    return PrioritizedTxScheduler::computeTxDurationUs(1, true, CONTROLLER_CONDITION_PAYLOAD_WORDS);
+}
@@ -0,0 +1,161 @@
+// MIT License
+//
+// Copyright (c) 2022-2025 James Smith of OrangeFox86
+// https://github.com/OrangeFox86/DreamcastControllerUsbPico
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include "hal/Usb/UsbFrameTiming.hpp"
+
+#include <stdint.h>
+#include <atomic>
+
+//! Run-time controller polling settings for a single player
+//! requestControllerPeriodUs() and the getters may be called from any context (normally the USB
+//! core); setReservedBusTimeUs() and setMeasuredControllerPeriodUs() must be called from the context
+//! which runs the player's node, as must the emulator frame and alignment error methods. Every value
+//! is a single word so that only atomic loads and stores are needed.
+class PollSettings
+{
+public:
+    //! Constructor
+    //! @param[in] frameTiming  USB start of frame timing to align polls with or nullptr if none
+    PollSettings(const UsbFrameTiming* frameTiming = nullptr);
+
+    //! Requests a new controller poll period
+    //! The request is refused if it is outside of [MIN_CONTROLLER_PERIOD_US, MAX_CONTROLLER_PERIOD_US]
+    //! or if the gap left between polls couldn't fit the longest transaction of the other connected
+    //! peripherals (the scheduler would never be able to fit that transaction in, starving it).
+    //! @param[in] periodUs  The requested poll period in microseconds
+    //! @returns true iff the request was accepted
+    bool requestControllerPeriodUs(uint32_t periodUs);
+
+    //! @returns the most recently accepted controller poll period in microseconds
+    uint32_t getRequestedControllerPeriodUs() const;
+
+    //! @returns the smallest controller poll period which currently won't starve other traffic
+    uint32_t getMinControllerPeriodUs() const;
+
+    //! If a peripheral with longer transactions was connected after a fast period was accepted, the
+    //! requested period is stretched here until that peripheral is removed. When aligned to USB
+    //! frames, the period is rounded up to a whole number of frames.
+    //! @returns the controller poll period that should be scheduled in microseconds
+    uint32_t getEffectiveControllerPeriodUs() const;
+
+    //! Sets the bus time which must be left free between controller polls
+    //! @param[in] reservedUs  Duration of the longest transaction of other connected peripherals
+    void setReservedBusTimeUs(uint32_t reservedUs);
+
+    //! @returns the measured average time between received controller conditions in microseconds
+    //!          or 0 if no measurement is available
+    uint32_t getMeasuredControllerPeriodUs() const;
+
+    //! Sets the measured average time between received controller conditions
+    //! @param[in] periodUs  The measured period or 0 to flag no measurement available
+    void setMeasuredControllerPeriodUs(uint32_t periodUs);
+
+    //! Enables or disables alignment of controller polls to USB start of frame
+    //! @param[in] aligned  true to have each condition land just before a USB frame begins
+    //! @returns false iff alignment was requested but no frame timing is available
+    bool setFrameAligned(bool aligned);
+
+    //! @returns true iff controller polls are to be aligned to USB start of frame
+    bool isFrameAligned() const;
+
+    //! @returns the USB start of frame timing or nullptr if none is available
+    const UsbFrameTiming* getFrameTiming() const;
+
+    //! Sets the frame cadence of an emulator reading this player's input
+    //! While set, one poll is made per emulated frame so that each condition lands just before the
+    //! emulator reads its input; this takes precedence over the requested period and USB frame
+    //! alignment. The emulator must report again within EMULATOR_FRAME_STALE_US to keep it set.
+    //! @param[in] periodUs  Time between emulated frames in microseconds
+    //! @param[in] readTimeUs  Local time of any one input read by the emulator
+    //! @param[in] currentTimeUs  The current time
+    //! @returns false iff periodUs is outside of [getMinControllerPeriodUs(), MAX_CONTROLLER_PERIOD_US]
+    bool setEmulatorFrame(uint32_t periodUs, uint64_t readTimeUs, uint64_t currentTimeUs);
+
+    //! Stops aligning polls to emulated frames
+    void clearEmulatorFrame();
+
+    //! Gets the emulator frame cadence, clearing it once the emulator stops reporting
+    //! @param[in] currentTimeUs  The current time
+    //! @param[out] periodUs  Time between emulated frames in microseconds
+    //! @param[out] readPhaseUs  Time of the emulator's input reads modulo periodUs
+    //! @returns true iff an emulator frame cadence is set and hasn't gone stale
+    bool getEmulatorFrame(uint64_t currentTimeUs, uint32_t& periodUs, uint32_t& readPhaseUs);
+
+    //! Sets the measured error of condition arrival against the aligned target
+    //! @param[in] meanUs  Average signed error (positive when late) or 0 if no measurement
+    //! @param[in] maxUs  Largest absolute error or 0 if no measurement
+    void setAlignmentErrorUs(int32_t meanUs, uint32_t maxUs);
+
+    //! @returns the measured average signed error of condition arrival against the aligned target
+    //!          (positive when late) or 0 if no measurement is available
+    int32_t getMeanAlignmentErrorUs() const;
+
+    //! @returns the measured largest absolute error of condition arrival against the aligned target
+    //!          or 0 if no measurement is available
+    uint32_t getMaxAlignmentErrorUs() const;
+
+    //! @param[in] a  A phase in [0, periodUs)
+    //! @param[in] b  A phase in [0, periodUs)
+    //! @param[in] periodUs  The period which the phases are taken modulo of
+    //! @returns signed distance from b to a, wrapped into [-periodUs/2, periodUs/2)
+    static int32_t phaseDeltaUs(uint32_t a, uint32_t b, uint32_t periodUs);
+
+    //! @returns estimated bus time of a single controller poll in microseconds
+    static uint32_t getControllerPollDurationUs();
+
+public:
+    //! Default time between each controller state poll (in microseconds)
+    static const uint32_t DEFAULT_CONTROLLER_PERIOD_US = 16000;
+    //! Shortest accepted controller poll period (1 kHz)
+    static const uint32_t MIN_CONTROLLER_PERIOD_US = 1000;
+    //! Longest accepted controller poll period
+    static const uint32_t MAX_CONTROLLER_PERIOD_US = 100000;
+    //! Number of payload words in a controller condition response
+    static const uint32_t CONTROLLER_CONDITION_PAYLOAD_WORDS = 3;
+    //! Emulator frame cadence is dropped when not reported again for this long (in microseconds)
+    static const uint32_t EMULATOR_FRAME_STALE_US = 2000000;
+
+private:
+    //! USB start of frame timing or nullptr if none is available
+    const UsbFrameTiming* const mFrameTiming;
+    //! true iff controller polls are to be aligned to USB start of frame
+    std::atomic<bool> mFrameAligned;
+    //! The most recently accepted controller poll period
+    std::atomic<uint32_t> mRequestedControllerPeriodUs;
+    //! Bus time which must be left free between controller polls
+    std::atomic<uint32_t> mReservedBusTimeUs;
+    //! Measured average time between received controller conditions
+    std::atomic<uint32_t> mMeasuredControllerPeriodUs;
+    //! Time between emulated frames or 0 when not aligning to an emulator
+    std::atomic<uint32_t> mEmulatorFramePeriodUs;
+    //! Time of the emulator's input reads modulo mEmulatorFramePeriodUs
+    std::atomic<uint32_t> mEmulatorReadPhaseUs;
+    //! Lower 32 bits of the time at which the emulator frame cadence was last reported
+    std::atomic<uint32_t> mEmulatorFrameReportedUs;
+    //! Measured average signed error of condition arrival against the aligned target
+    std::atomic<int32_t> mMeanAlignmentErrorUs;
+    //! Measured largest absolute error of condition arrival against the aligned target
+    std::atomic<uint32_t> mMaxAlignmentErrorUs;
+};
@@ -40,9 +40,11 @@ PrioritizedTxScheduler::PrioritizedTxScheduler(MutexInterface& m, uint8_t sender
     mSchedule.resize(max + 1);
 }
 
+const std::shared_ptr<Transmission> PrioritizedTxScheduler::ScheduleItem::NULL_TX = nullptr;
+
 PrioritizedTxScheduler::~PrioritizedTxScheduler() {}
 
-uint32_t PrioritizedTxScheduler::add(std::shared_ptr<Transmission> tx)
+uint32_t PrioritizedTxScheduler::add(const std::shared_ptr<Transmission>& tx)
 {
     assert(tx->priority < mSchedule.size());
 
@@ -69,15 +71,9 @@ uint32_t PrioritizedTxScheduler::add(uint8_t priority,
                                     uint32_t autoRepeatUs,
                                     uint64_t autoRepeatEndTimeUs)
 {
-    uint32_t pktDurationNs = MAPLE_OPEN_LINE_CHECK_TIME_US + packet.getTxTimeNs();
-
-    if (expectResponse)
-    {
-        uint32_t expectedReadDurationUs = MaplePacket::getTxTimeNs(expectedResponseNumPayloadWords, MAPLE_RESPONSE_NS_PER_BIT);
-        pktDurationNs += MAPLE_RESPONSE_DELAY_NS + expectedReadDurationUs;
-    }
-
-    uint32_t pktDurationUs = INT_DIVIDE_CEILING(pktDurationNs, 1000);
+    uint32_t pktDurationUs = computeTxDurationUs(packet.payload.size(),
+                                                 expectResponse,
+                                                 expectedResponseNumPayloadWords);
 
     // This will happen if minimal communication is made constantly for 20 days
     assert(mNextId != INVALID_TX_ID);
@@ -99,6 +95,21 @@ uint32_t PrioritizedTxScheduler::add(uint8_t priority,
     return add(tx);
 }
 
+uint32_t PrioritizedTxScheduler::computeTxDurationUs(uint32_t numPayloadWords,
+                                                     bool expectResponse,
+                                                     uint32_t expectedResponseNumPayloadWords)
+{
+    uint32_t pktDurationNs = MAPLE_OPEN_LINE_CHECK_TIME_US + MaplePacket::getTxTimeNs(numPayloadWords, MAPLE_NS_PER_BIT);
+
+    if (expectResponse)
+    {
+        uint32_t expectedReadDurationUs = MaplePacket::getTxTimeNs(expectedResponseNumPayloadWords, MAPLE_RESPONSE_NS_PER_BIT);
+        pktDurationNs += MAPLE_RESPONSE_DELAY_NS + expectedReadDurationUs;
+    }
+
+    return INT_DIVIDE_CEILING(pktDurationNs, 1000);
+}
+
 uint64_t PrioritizedTxScheduler::computeNextTimeCadence(uint64_t currentTime,
                                                         uint64_t period,
                                                         uint64_t offset)
@@ -199,8 +210,8 @@ std::shared_ptr<Transmission> PrioritizedTxScheduler::popItem(ScheduleItem& sche
     {
         LockGuard lock(mScheduleMutex);
 
-        // Save the transmission
-        item = scheduleItem.getTx();
+        // Save the transmission (moved since the list entry is erased next)
+        item = std::move(*scheduleItem.mItemIter);
 
         // Pop it!
         scheduleItem.mScheduleIter->erase(scheduleItem.mItemIter);
@@ -249,26 +260,31 @@ uint32_t PrioritizedTxScheduler::cancelById(uint32_t transmissionId)
 
 uint32_t PrioritizedTxScheduler::cancelByRecipient(uint8_t recipientAddr)
 {
-    LockGuard lock(mScheduleMutex);
+    std::vector<std::shared_ptr<Transmission>> externalTxs;
     uint32_t n = 0;
-    for (std::vector<std::list<std::shared_ptr<Transmission>>>::iterator scheduleIter = mSchedule.begin();
-         scheduleIter != mSchedule.end();
-         ++scheduleIter)
     {
-        std::list<std::shared_ptr<Transmission>>::iterator iter = scheduleIter->begin();
-        while (iter != scheduleIter->end())
+        LockGuard lock(mScheduleMutex);
+        for (std::vector<std::list<std::shared_ptr<Transmission>>>::iterator scheduleIter = mSchedule.begin();
+            scheduleIter != mSchedule.end();
+            ++scheduleIter)
         {
-            if ((*iter)->packet->frame.recipientAddr == recipientAddr)
-            {
-                iter = scheduleIter->erase(iter);
-                ++n;
-            }
-            else
+            std::list<std::shared_ptr<Transmission>>::iterator iter = scheduleIter->begin();
+            while (iter != scheduleIter->end())
             {
-                ++iter;
+                if ((*iter)->packet->frame.recipientAddr == recipientAddr)
+                {
+                    takeExternal(*iter, externalTxs);
+                    iter = scheduleIter->erase(iter);
+                    ++n;
+                }
+                else
+                {
+                    ++iter;
+                }
             }
         }
     }
+    notifyCanceled(externalTxs);
     return n;
 }
 
@@ -295,15 +311,46 @@ uint32_t PrioritizedTxScheduler::countRecipients(uint8_t recipientAddr)
 
 uint32_t PrioritizedTxScheduler::cancelAll()
 {
-    LockGuard lock(mScheduleMutex);
+    std::vector<std::shared_ptr<Transmission>> externalTxs;
     uint32_t n = 0;
-    for (std::vector<std::list<std::shared_ptr<Transmission>>>::iterator scheduleIter = mSchedule.begin();
-         scheduleIter != mSchedule.end();
-         ++scheduleIter)
     {
+        LockGuard lock(mScheduleMutex);
+        for (std::vector<std::list<std::shared_ptr<Transmission>>>::iterator scheduleIter = mSchedule.begin();
+            scheduleIter != mSchedule.end();
+            ++scheduleIter)
+        {
+            for (std::list<std::shared_ptr<Transmission>>::iterator iter = scheduleIter->begin();
+                iter != scheduleIter->end();
+                ++iter)
+            {
+                takeExternal(*iter, externalTxs);
+            }
 
-        n += scheduleIter->size();
-        scheduleIter->clear();
+            n += scheduleIter->size();
+            scheduleIter->clear();
+        }
     }
+    notifyCanceled(externalTxs);
     return n;
 }
+
+void PrioritizedTxScheduler::takeExternal(const std::shared_ptr<Transmission>& tx,
+                                          std::vector<std::shared_ptr<Transmission>>& externalTxs)
+{
+    if (tx->priority == EXTERNAL_TRANSMISSION_PRIORITY && tx->transmitter != nullptr)
+    {
+        externalTxs.push_back(tx);
+    }
+}
+
+void PrioritizedTxScheduler::notifyCanceled(const std::vector<std::shared_ptr<Transmission>>& externalTxs)
+{
+    // Called outside of the lock so that the transmitter may schedule something else in response
+    for (std::vector<std::shared_ptr<Transmission>>::const_iterator iter = externalTxs.begin();
+         iter != externalTxs.end();
+         ++iter)
+    {
+        // Never written to the bus
+        (*iter)->transmitter->txFailed(true, false, *iter);
+    }
+}
@@ -57,8 +57,13 @@ public:
             //! Constructor
             ScheduleItem() : mIsValid(false), mTime(0) {}
 
-            //! @returns the transmission for this schedule item
-            std::shared_ptr<Transmission> getTx() {return mIsValid ? *mItemIter : nullptr;}
+            //! @returns the transmission for this schedule item (reference is valid until the item
+            //!          is popped or the schedule is otherwise modified)
+            const std::shared_ptr<Transmission>& getTx() {return mIsValid ? *mItemIter : NULL_TX;}
+
+        private:
+            //! Returned from getTx() when this item is not valid
+            static const std::shared_ptr<Transmission> NULL_TX;
 
         private:
             //! Set to true iff iterators are valid
@@ -115,6 +120,9 @@ public:
     uint32_t cancelById(uint32_t transmissionId);
 
     //! Cancels scheduled transmission by recipient address
+    //! Transmitters of canceled external transmissions are notified through txFailed() since they
+    //! didn't cancel the transmission themselves. Peripheral transmitters are not notified because
+    //! they are deleted along with the device that they were talking to.
     //! @param[in] recipientAddr  The recipient address of the transmissions to cancel
     //! @returns number of transmissions successfully canceled
     uint32_t cancelByRecipient(uint8_t recipientAddr);
@@ -125,6 +133,7 @@ public:
     uint32_t countRecipients(uint8_t recipientAddr);
 
     //! Cancels all items in the schedule
+    //! Transmitters of canceled external transmissions are notified like in cancelByRecipient()
     //! @returns number of transmissions successfully canceled
     uint32_t cancelAll();
 
@@ -137,11 +146,31 @@ public:
                                            uint64_t period,
                                            uint64_t offset = 0);
 
+    //! Estimates how long the bus is occupied by a transmission
+    //! @param[in] numPayloadWords  Number of payload words in the transmitted packet
+    //! @param[in] expectResponse  true iff a response is expected after transmission
+    //! @param[in] expectedResponseNumPayloadWords  Number of payload words to expect in response
+    //! @returns estimated duration of the transmission and its response in microseconds
+    static uint32_t computeTxDurationUs(uint32_t numPayloadWords,
+                                        bool expectResponse,
+                                        uint32_t expectedResponseNumPayloadWords = 0);
+
 protected:
     //! Add a transmission to the schedule
     //! @param[in] tx  The transmission to add
     //! @returns transmission ID
-    uint32_t add(std::shared_ptr<Transmission> tx);
+    uint32_t add(const std::shared_ptr<Transmission>& tx);
+
+private:
+    //! Saves the given transmission to externalTxs if its transmitter needs cancel notification
+    //! @param[in] tx  The transmission being canceled
+    //! @param[in,out] externalTxs  The list of transmissions to notify
+    static void takeExternal(const std::shared_ptr<Transmission>& tx,
+                             std::vector<std::shared_ptr<Transmission>>& externalTxs);
+
+    //! Notifies transmitters that their external transmissions were canceled
+    //! @param[in] externalTxs  The canceled transmissions
+    static void notifyCanceled(const std::vector<std::shared_ptr<Transmission>>& externalTxs);
 
 public:
     //! Use this for txTime if the packet needs to be sent ASAP
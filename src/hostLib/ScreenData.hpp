@@ -23,17 +23,20 @@
 
 #pragma once
 
-#include "hal/System/MutexInterface.hpp"
+#include "TripleBuffer.hpp"
 #include <stdint.h>
 
 //! Contains monochrome screen data
 //! A screen is 48 bits wide and 32 bits tall
+//! The set functions must all be called from a single context, and isNewDataAvailable() and
+//! readData() must be called from a single context (may be the same or different). Complete screens
+//! are handed off through a triple buffer, so neither side locks or masks interrupts.
 class ScreenData
 {
     public:
         //! Constructor
-        //! @param[in] mutex  Reference to the mutex to use (critical section mutex recommended)
-        ScreenData(MutexInterface& mutex, uint32_t defaultScreenNum=0);
+        //! @param[in] defaultScreenNum  The default screen to initialize to and reset to
+        ScreenData(uint32_t defaultScreenNum=0);
 
         //! Set the screen bits
         //! @param[in] data  Screen words to set
@@ -51,9 +54,10 @@ class ScreenData
         //! @returns true if new data is available since last call to readData
         bool isNewDataAvailable() const;
 
-        //! Copies screen data to the given array
+        //! Copies the most recently set screen data to the given array
         //! @param[out] out  The array to write to (must be at least 48 words in length)
-        void readData(uint32_t* out);
+        //! @returns the generation of the data copied (increments with each change)
+        uint32_t readData(uint32_t* out);
 
     public:
         //! Number of words in a screen
@@ -61,15 +65,23 @@ class ScreenData
         //! Number of default screens
         static const uint32_t NUM_DEFAULT_SCREENS = 4;
 
+    private:
+        //! A single, complete screen
+        struct Screen
+        {
+            uint32_t words[NUM_SCREEN_WORDS];
+        };
+
+        //! Publishes the current screen data to the reader
+        void publish();
+
     private:
         //! The default screen data on initialization and resetToDefault()
         static const uint32_t DEFAULT_SCREENS[NUM_DEFAULT_SCREENS][NUM_SCREEN_WORDS];
-        //! Mutex used to ensure integrity of data between multiple cores
-        MutexInterface& mMutex;
         //! Default screen to revert to on resetToDefault()
         uint32_t mDefaultScreen[NUM_SCREEN_WORDS];
-        //! The current screen data
-        uint32_t mScreenData[NUM_SCREEN_WORDS];
-        //! Flag set to true in setData and set to false in readData
-        bool mNewDataAvailable;
+        //! The current screen data (setter context only)
+        Screen mScreenData;
+        //! Screens handed off from the setter context to the reader context
+        TripleBuffer<Screen> mScreenBuffer;
 };
@@ -35,19 +35,20 @@ TransmissionTimeliner::ReadStatus TransmissionTimeliner::readTask(uint64_t curre
     // Process bus events and get any data received
     MapleBusInterface::Status busStatus = mBus.processEvents(currentTimeUs);
     status.busPhase = busStatus.phase;
+    status.failureReason = busStatus.failureReason;
     if (status.busPhase == MapleBusInterface::Phase::READ_COMPLETE)
     {
         status.received = std::make_shared<MaplePacket>(busStatus.readBuffer,
                                                         busStatus.readBufferLen);
-        status.transmission = mCurrentTx;
-        mCurrentTx = nullptr;
+        status.receivedTimeUs = busStatus.readCompleteTimeUs;
+        // Hand ownership over to status without touching the reference count
+        status.transmission = std::move(mCurrentTx);
     }
     else if (status.busPhase == MapleBusInterface::Phase::WRITE_COMPLETE
              || status.busPhase == MapleBusInterface::Phase::READ_FAILED
              || status.busPhase == MapleBusInterface::Phase::WRITE_FAILED)
     {
-        status.transmission = mCurrentTx;
-        mCurrentTx = nullptr;
+        status.transmission = std::move(mCurrentTx);
     }
 
     return status;
@@ -55,25 +56,17 @@ TransmissionTimeliner::ReadStatus TransmissionTimeliner::readTask(uint64_t curre
 
 std::shared_ptr<const Transmission> TransmissionTimeliner::writeTask(uint64_t currentTimeUs)
 {
-    std::shared_ptr<const Transmission> txSent = nullptr;
-
     if (!mBus.isBusy())
     {
         PrioritizedTxScheduler::ScheduleItem item = mSchedule->peekNext(currentTimeUs);
-        txSent = item.getTx();
-        if (txSent != nullptr)
+        const std::shared_ptr<Transmission>& txSent = item.getTx();
+        if (txSent != nullptr && mBus.write(*txSent->packet, txSent->expectResponse))
         {
-            if (mBus.write(*txSent->packet, txSent->expectResponse))
-            {
-                mCurrentTx = txSent;
-                mSchedule->popItem(item);
-            }
-            else
-            {
-                txSent = nullptr;
-            }
+            mCurrentTx = txSent;
+            mSchedule->popItem(item);
+            return mCurrentTx;
         }
     }
 
-    return txSent;
+    return nullptr;
 }
\ No newline at end of file
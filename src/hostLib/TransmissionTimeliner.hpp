@@ -39,11 +39,17 @@ public:
         std::shared_ptr<const MaplePacket> received;
         //! The phase of the maple bus
         MapleBusInterface::Phase busPhase;
+        //! Set to failure reason when busPhase is WRITE_FAILED or READ_FAILED
+        MapleBusInterface::FailureReason failureReason;
+        //! Time at which the received packet finished arriving or 0 if unknown
+        uint64_t receivedTimeUs;
 
         ReadStatus() :
             transmission(nullptr),
             received(nullptr),
-            busPhase(MapleBusInterface::Phase::INVALID)
+            busPhase(MapleBusInterface::Phase::INVALID),
+            failureReason(MapleBusInterface::FailureReason::NONE),
+            receivedTimeUs(0)
         {}
     };
 
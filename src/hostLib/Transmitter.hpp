@@ -29,6 +29,10 @@
 struct Transmission;
 struct MaplePacket;
 
+//! Interface for anything which schedules transmissions and wants to be notified of their status
+//! Ownership: shared pointers are passed by reference and are only guaranteed to be valid for the
+//! duration of each callback. The caller retains ownership; a callee which needs to hold on to a
+//! transmission or packet beyond the callback must copy the shared pointer.
 class Transmitter
 {
 public:
@@ -37,7 +41,7 @@ public:
 
     //! Called when transmission has started to be sent
     //! @param[in] tx  The transmission that was sent
-    virtual void txStarted(std::shared_ptr<const Transmission> tx) = 0;
+    virtual void txStarted(const std::shared_ptr<const Transmission>& tx) = 0;
 
     //! Called when transmission failed
     //! @param[in] writeFailed  Set to true iff TX failed because write failed
@@ -45,11 +49,23 @@ public:
     //! @param[in] tx  The transmission that failed
     virtual void txFailed(bool writeFailed,
                           bool readFailed,
-                          std::shared_ptr<const Transmission> tx) = 0;
+                          const std::shared_ptr<const Transmission>& tx) = 0;
 
     //! Called when a transmission is complete
     //! @param[in] packet  The packet received or nullptr if this was write only transmission
     //! @param[in] tx  The transmission that triggered this data
-    virtual void txComplete(std::shared_ptr<const MaplePacket> packet,
-                            std::shared_ptr<const Transmission> tx) = 0;
+    virtual void txComplete(const std::shared_ptr<const MaplePacket>& packet,
+                            const std::shared_ptr<const Transmission>& tx) = 0;
+
+    //! Called instead of txComplete() when a response was received at a known time
+    //! The default implementation discards the time
+    //! @param[in] packet  The packet received
+    //! @param[in] tx  The transmission that triggered this data
+    //! @param[in] receivedTimeUs  The time at which the end of the response was received
+    virtual void txCompleteAt(const std::shared_ptr<const MaplePacket>& packet,
+                              const std::shared_ptr<const Transmission>& tx,
+                              uint64_t receivedTimeUs)
+    {
+        txComplete(packet, tx);
+    }
 };
@@ -1,7 +1,12 @@
 #include "FlycastCommandParser.hpp"
 #include "hal/MapleBus/MaplePacket.hpp"
+#include "MapleBinaryFrame.hpp"
+#include "MapleHexEncoder.hpp"
+#include "MapleHexDecoder.hpp"
+#include "TransmissionTags.hpp"
 
 #include <stdio.h>
+#include <algorithm>
 #include <cctype>
 #include <cstring>
 #include <string>
@@ -9,62 +14,487 @@
 
 // Format: X[modifier-char]<cmd-data>\n
 // This parser must always return a single line of data
+// Maple packets may be tagged as X@<tag> <packet>, where tag is a decimal value in [0,65535]. The
+// response line is then prefixed with "@<tag> " and is written as soon as its bus completes, which
+// may be before responses to earlier requests on other buses.
+// Once enabled with XK 1, every response of a packet which reached the bus is first prefixed with
+// "^<time> ", where time is 16 hex characters of device time in microseconds at bus completion. In
+// binary mode, the time is instead appended to the response frame as 64 bits, little endian.
+// Time stamps are disabled again, and pending tags and batches forgotten, when the session resets.
+// Responses to packets are written as whole lines, which are dropped instead of cut short when the
+// output is full; XO prints the number of bytes dropped so far. A dropped response is still answered
+// with a short "*failed dropped" line (with the same time stamp and tag), which may use space the
+// output reserves for short lines.
+
+//! Where responses to packets are written
+class FlycastResponses
+{
+public:
+    //! Writes a whole response line
+    //! @param[in] text  The line, including its end of line
+    //! @param[in] len  Number of characters in text
+    //! @returns false if the line was dropped because there was no room
+    bool write(const char* text, uint32_t len) const
+    {
+        if (output == nullptr)
+        {
+            fwrite(text, 1, len, stdout);
+            return true;
+        }
+        return output->writeLine(text, len - 1);
+    }
+
+    //! Writes a whole response line, or a short line in its place which says that it was dropped
+    //! @param[in] text  The line, including its end of line
+    //! @param[in] len  Number of characters in text
+    //! @param[in] prefixLen  Number of leading characters of text (time stamp and tag) which are
+    //!                       repeated in the line which says that it was dropped
+    void writeOrReportDropped(const char* text, uint32_t len, uint32_t prefixLen) const
+    {
+        if (!write(text, len) && prefixLen <= MAX_PREFIX_LEN)
+        {
+            static const char DROPPED[] = "*failed dropped\n";
+            char dropped[MAX_PREFIX_LEN + sizeof(DROPPED)];
+            memcpy(dropped, text, prefixLen);
+            memcpy(dropped + prefixLen, DROPPED, sizeof(DROPPED) - 1);
+            write(dropped, prefixLen + sizeof(DROPPED) - 1);
+        }
+    }
+
+    //! @returns the length of the longest line which may ever be written, with its end of line
+    uint32_t getMaxLineLength() const
+    {
+        return (output != nullptr) ? (output->getMaxLineLength() + 1) : 0xFFFFFFFF;
+    }
+
+    //! @returns the number of bytes dropped so far because the output was full
+    uint32_t getDroppedCount() const
+    {
+        return (output != nullptr) ? output->getDroppedCount() : 0;
+    }
+
+    //! Longest time stamp and tag prefix repeated by writeOrReportDropped()
+    static const uint32_t MAX_PREFIX_LEN = 32;
+
+    //! Where whole lines are written, or nullptr to write to stdout
+    LineOutput* output = nullptr;
+} flycastResponses;
+
+//! Device time stamps of flycast responses, which the emulator uses to compensate for queueing and
+//! USB delay (off until enabled by the emulator)
+class FlycastTimestamps
+{
+public:
+    //! Length of encode() output
+    static const uint32_t LEN = 1 + 16 + 1;
+
+    //! @returns the current time if enabled or 0 otherwise
+    uint64_t now() const
+    {
+        return (enabled && clock != nullptr) ? clock->getTimeUs() : 0;
+    }
+
+    //! Writes a time stamp as '^', 16 hex characters of time in microseconds, then a space
+    //! @param[in] timeUs  The time to write
+    //! @param[out] out  Where characters are written (must hold at least LEN)
+    //! @returns pointer to the character after the last one written
+    static char* encode(uint64_t timeUs, char* out)
+    {
+        *out++ = '^';
+        out = MapleHexEncoder::encodeWord(timeUs >> 32, out);
+        out = MapleHexEncoder::encodeWord(timeUs, out);
+        *out++ = ' ';
+        return out;
+    }
+
+    //! Writes a time stamp if enabled and a time is known
+    //! @param[in] timeUs  The time to write or 0 if unknown
+    //! @param[out] out  Where characters are written (must hold at least LEN)
+    //! @returns pointer to the character after the last one written
+    char* prefix(uint64_t timeUs, char* out) const
+    {
+        return (enabled && timeUs != 0) ? encode(timeUs, out) : out;
+    }
+
+    //! Appends a binary time stamp (64 bits, little endian) if enabled and a time is known
+    //! @param[in] timeUs  The time to append or 0 if unknown
+    //! @param[out] out  Where bytes are appended
+    void append(uint64_t timeUs, std::vector<uint8_t>& out) const
+    {
+        if (enabled && timeUs != 0)
+        {
+            MapleBinaryFrame::appendU32(out, timeUs);
+            MapleBinaryFrame::appendU32(out, timeUs >> 32);
+        }
+    }
+
+    //! True iff responses which reached the bus are prefixed with the time the bus completed
+    bool enabled = false;
+    //! Clock used for completions which carry no time
+    ClockInterface* clock = nullptr;
+} flycastTimestamps;
 
 // Simple definition of a transmitter which just echos status and received data
 class FlycastEchoTransmitter : public Transmitter
 {
 public:
-    virtual void txStarted(std::shared_ptr<const Transmission> tx) final
+    virtual void txStarted(const std::shared_ptr<const Transmission>& tx) final
     {}
 
     virtual void txFailed(bool writeFailed,
                           bool readFailed,
-                          std::shared_ptr<const Transmission> tx) final
+                          const std::shared_ptr<const Transmission>& tx) final
+    {
+        char text[FlycastTimestamps::LEN + 16];
+        char* end = flycastTimestamps.prefix(flycastTimestamps.now(), text);
+        const char* failure = writeFailed ? "*failed write\n" : "*failed read\n";
+        const uint32_t failureLen = strlen(failure);
+        memcpy(end, failure, failureLen);
+        flycastResponses.write(text, end + failureLen - text);
+    }
+
+    virtual void txComplete(const std::shared_ptr<const MaplePacket>& packet,
+                            const std::shared_ptr<const Transmission>& tx) final
     {
-        if (writeFailed)
+        txCompleteAt(packet, tx, flycastTimestamps.now());
+    }
+
+    virtual void txCompleteAt(const std::shared_ptr<const MaplePacket>& packet,
+                              const std::shared_ptr<const Transmission>& tx,
+                              uint64_t receivedTimeUs) final
+    {
+        char* end = flycastTimestamps.prefix(receivedTimeUs, mText);
+        const uint32_t prefixLen = end - mText;
+        end = MapleHexEncoder::encodeFlycast(*packet, end);
+        flycastResponses.writeOrReportDropped(mText, end - mText, prefixLen);
+    }
+
+private:
+    //! Holds the response text (too large for the stack of the Maple Bus core)
+    char mText[FlycastTimestamps::LEN + MapleHexEncoder::MAX_FLYCAST_LEN];
+} flycastEchoTransmitter;
+
+// Transmitter which echos status and received data, prefixed with the tag of the request
+class FlycastTaggedTransmitter : public Transmitter
+{
+public:
+    virtual void txStarted(const std::shared_ptr<const Transmission>& tx) final
+    {}
+
+    virtual void txFailed(bool writeFailed,
+                          bool readFailed,
+                          const std::shared_ptr<const Transmission>& tx) final
+    {
+        uint16_t tag;
+        if (tags.take(*tx, tag))
         {
-            printf("*failed write\n");
+            char timestamp[FlycastTimestamps::LEN + 1];
+            *flycastTimestamps.prefix(flycastTimestamps.now(), timestamp) = '\0';
+            char text[sizeof(timestamp) + 32];
+            int len = snprintf(text,
+                               sizeof(text),
+                               "%s@%u *failed %s\n",
+                               timestamp,
+                               (unsigned int)tag,
+                               writeFailed ? "write" : "read");
+            flycastResponses.write(text, len);
         }
-        else
+    }
+
+    virtual void txComplete(const std::shared_ptr<const MaplePacket>& packet,
+                            const std::shared_ptr<const Transmission>& tx) final
+    {
+        txCompleteAt(packet, tx, flycastTimestamps.now());
+    }
+
+    virtual void txCompleteAt(const std::shared_ptr<const MaplePacket>& packet,
+                              const std::shared_ptr<const Transmission>& tx,
+                              uint64_t receivedTimeUs) final
+    {
+        uint16_t tag;
+        if (tags.take(*tx, tag))
+        {
+            char* end = flycastTimestamps.prefix(receivedTimeUs, mText);
+            *end++ = '@';
+            end = MapleHexEncoder::encodeDecimal(tag, end);
+            *end++ = ' ';
+            const uint32_t prefixLen = end - mText;
+            end = MapleHexEncoder::encodeFlycast(*packet, end);
+            // The tag is answered no matter what, since the emulator waits on it
+            flycastResponses.writeOrReportDropped(mText, end - mText, prefixLen);
+        }
+    }
+
+    //! Tag of each request waiting on a response
+    TransmissionTags tags;
+
+private:
+    //! Holds the response text (too large for the stack of the Maple Bus core)
+    char mText[FlycastTimestamps::LEN
+               + 1 + MapleHexEncoder::MAX_DECIMAL_LEN + 1
+               + MapleHexEncoder::MAX_FLYCAST_LEN];
+} flycastTaggedTransmitter;
+
+// Transmitter which collects the results of a batch of packets and echos them all on one line, in
+// the order they were requested, once every packet of the batch has completed or failed
+// The whole line is written at once; a line which can never fit in the output is answered with
+// "*failed too large" instead, and one which doesn't fit right now with "*failed dropped".
+class FlycastBatchTransmitter : public Transmitter
+{
+public:
+    //! Maximum number of packets in a single batch
+    static const uint32_t MAX_PACKETS = 8;
+    //! Maximum number of batches waiting on responses at once
+    static const uint32_t MAX_BATCHES = 4;
+    //! Longest batch response line, with its end of line (enough for several VMU block reads)
+    static const uint32_t MAX_LINE_LEN = 8 * 1024;
+
+    virtual void txStarted(const std::shared_ptr<const Transmission>& tx) final
+    {}
+
+    virtual void txFailed(bool writeFailed,
+                          bool readFailed,
+                          const std::shared_ptr<const Transmission>& tx) final
+    {
+        uint16_t tag;
+        if (mTags.take(*tx, tag))
         {
-            printf("*failed read\n");
+            setResult(tag / MAX_PACKETS,
+                      tag % MAX_PACKETS,
+                      nullptr,
+                      writeFailed ? "write" : "read",
+                      flycastTimestamps.now());
         }
     }
 
-    virtual void txComplete(std::shared_ptr<const MaplePacket> packet,
-                            std::shared_ptr<const Transmission> tx) final
+    virtual void txComplete(const std::shared_ptr<const MaplePacket>& packet,
+                            const std::shared_ptr<const Transmission>& tx) final
     {
-        printf(
-            "%02hhX %02hhX %02hhX %02hhX",
-            packet->frame.command,
-            packet->frame.recipientAddr,
-            packet->frame.senderAddr,
-            packet->frame.length);
+        txCompleteAt(packet, tx, flycastTimestamps.now());
+    }
 
-        for (uint32_t p : packet->payload)
+    virtual void txCompleteAt(const std::shared_ptr<const MaplePacket>& packet,
+                              const std::shared_ptr<const Transmission>& tx,
+                              uint64_t receivedTimeUs) final
+    {
+        uint16_t tag;
+        if (mTags.take(*tx, tag))
         {
-            printf(" %08lX", p);
+            setResult(tag / MAX_PACKETS, tag % MAX_PACKETS, packet, nullptr, receivedTimeUs);
         }
+    }
 
-        printf("\n");
+    //! Reserves a batch
+    //! @param[in] numPackets  Number of packets in the batch [1,MAX_PACKETS]
+    //! @returns index of the reserved batch or -1 if all batches are waiting on responses
+    int32_t start(uint32_t numPackets)
+    {
+        for (uint32_t i = 0; i < MAX_BATCHES; ++i)
+        {
+            if (mBatches[i].numRemaining == 0)
+            {
+                mBatches[i].numPackets = numPackets;
+                mBatches[i].numRemaining = numPackets;
+                mBatches[i].completeTimeUs = 0;
+                return i;
+            }
+        }
+        return -1;
+    }
+
+    //! Associates a scheduled transmission with a packet of a batch
+    void add(uint32_t batchIdx, uint32_t packetIdx, uint8_t senderAddr, uint32_t transmissionId)
+    {
+        mTags.add(senderAddr, transmissionId, batchIdx * MAX_PACKETS + packetIdx);
     }
-} flycastEchoTransmitter;
+
+    //! Sets the result of a packet of a batch which failed before being scheduled
+    void setFailed(uint32_t batchIdx, uint32_t packetIdx, const char* reason)
+    {
+        setResult(batchIdx, packetIdx, nullptr, reason, 0);
+    }
+
+    //! Frees all batches, ignoring results of packets which are still pending
+    void reset()
+    {
+        mTags.clear();
+        for (uint32_t i = 0; i < MAX_BATCHES; ++i)
+        {
+            mBatches[i].numRemaining = 0;
+            for (uint32_t j = 0; j < MAX_PACKETS; ++j)
+            {
+                mBatches[i].responses[j].reset();
+            }
+        }
+    }
+
+private:
+    //! Sets the result of a packet, writing the response line once the batch is complete
+    //! @param[in] timeUs  Time at which the bus completed or 0 if the packet never reached the bus
+    void setResult(uint32_t batchIdx,
+                   uint32_t packetIdx,
+                   const std::shared_ptr<const MaplePacket>& packet,
+                   const char* failure,
+                   uint64_t timeUs)
+    {
+        Batch& batch = mBatches[batchIdx];
+        batch.responses[packetIdx] = packet;
+        batch.failures[packetIdx] = failure;
+        if (timeUs != 0)
+        {
+            batch.completeTimeUs = timeUs;
+        }
+
+        if (--batch.numRemaining == 0)
+        {
+            // The line is stamped with the time of the last bus completion
+            char* end = flycastTimestamps.prefix(batch.completeTimeUs, mText);
+            const uint32_t prefixLen = end - mText;
+
+            // Each result is followed by a separator or the end of line
+            uint32_t lineLen = prefixLen;
+            for (uint32_t i = 0; i < batch.numPackets; ++i)
+            {
+                if (batch.responses[i] != nullptr)
+                {
+                    lineLen += MapleHexEncoder::getFlycastLen(*batch.responses[i]);
+                }
+                else
+                {
+                    lineLen += strlen(FAILED) + strlen(batch.failures[i]) + 1;
+                }
+            }
+
+            if (lineLen > sizeof(mText) || lineLen > flycastResponses.getMaxLineLength())
+            {
+                const uint32_t tooLargeLen = strlen(TOO_LARGE);
+                memcpy(end, TOO_LARGE, tooLargeLen);
+                end += tooLargeLen;
+                flycastResponses.write(mText, end - mText);
+            }
+            else
+            {
+                for (uint32_t i = 0; i < batch.numPackets; ++i)
+                {
+                    if (batch.responses[i] != nullptr)
+                    {
+                        end = MapleHexEncoder::encodeFlycast(*batch.responses[i], end);
+                    }
+                    else
+                    {
+                        const uint32_t failedLen = strlen(FAILED);
+                        const uint32_t failureLen = strlen(batch.failures[i]);
+                        memcpy(end, FAILED, failedLen);
+                        memcpy(end + failedLen, batch.failures[i], failureLen);
+                        end += failedLen + failureLen + 1;
+                    }
+                    end[-1] = (i + 1 < batch.numPackets) ? ';' : '\n';
+                }
+                flycastResponses.writeOrReportDropped(mText, end - mText, prefixLen);
+            }
+
+            for (uint32_t i = 0; i < batch.numPackets; ++i)
+            {
+                batch.responses[i].reset();
+            }
+        }
+    }
+
+    //! Written in place of the failure reason of a packet
+    static const char FAILED[];
+    //! Written in place of a line which can never fit in the output
+    static const char TOO_LARGE[];
+
+    //! Results of the packets of a single batch
+    struct Batch
+    {
+        //! Number of packets in this batch
+        uint32_t numPackets = 0;
+        //! Number of packets still waiting on a result (0 when this batch is free)
+        uint32_t numRemaining = 0;
+        //! Time of the last bus completion of this batch or 0 if none
+        uint64_t completeTimeUs = 0;
+        //! The response to each packet, or nullptr if it failed
+        std::shared_ptr<const MaplePacket> responses[MAX_PACKETS];
+        //! The reason each failed packet failed
+        const char* failures[MAX_PACKETS] = {};
+    };
+
+    //! Tag of each packet waiting on a response: batch index * MAX_PACKETS + packet index
+    TransmissionTags mTags;
+    //! All batches
+    Batch mBatches[MAX_BATCHES];
+    //! Holds the response line (too large for the stack of the Maple Bus core)
+    char mText[MAX_LINE_LEN];
+} flycastBatchTransmitter;
+
+const char FlycastBatchTransmitter::FAILED[] = "*failed ";
+const char FlycastBatchTransmitter::TOO_LARGE[] = "*failed too large\n";
+
+// Transmitter which returns status and received data as binary frames
+class FlycastBinaryTransmitter : public Transmitter
+{
+public:
+    virtual void txStarted(const std::shared_ptr<const Transmission>& tx) final
+    {}
+
+    virtual void txFailed(bool writeFailed,
+                          bool readFailed,
+                          const std::shared_ptr<const Transmission>& tx) final
+    {
+        mResponse.clear();
+        mResponse.push_back(
+            writeFailed ? MapleBinaryFrame::STATUS_WRITE_FAILED : MapleBinaryFrame::STATUS_READ_FAILED);
+        flycastTimestamps.append(flycastTimestamps.now(), mResponse);
+        output->writeFrame(FlycastCommandParser::COMMAND_CHAR, &mResponse[0], mResponse.size());
+    }
+
+    virtual void txComplete(const std::shared_ptr<const MaplePacket>& packet,
+                            const std::shared_ptr<const Transmission>& tx) final
+    {
+        txCompleteAt(packet, tx, flycastTimestamps.now());
+    }
+
+    virtual void txCompleteAt(const std::shared_ptr<const MaplePacket>& packet,
+                              const std::shared_ptr<const Transmission>& tx,
+                              uint64_t receivedTimeUs) final
+    {
+        mResponse.clear();
+        mResponse.push_back(MapleBinaryFrame::STATUS_COMPLETE);
+        MapleBinaryFrame::appendPacket(mResponse, *packet);
+        flycastTimestamps.append(receivedTimeUs, mResponse);
+        output->writeFrame(FlycastCommandParser::COMMAND_CHAR, &mResponse[0], mResponse.size());
+    }
+
+    //! Where responses are written (set on each binary submit)
+    BinaryOutput* output = nullptr;
+
+private:
+    std::vector<uint8_t> mResponse;
+} flycastBinaryTransmitter;
 
 FlycastCommandParser::FlycastCommandParser(
     SystemIdentification& identification,
+    ClockInterface& clock,
     std::shared_ptr<PrioritizedTxScheduler>* schedulers,
     const uint8_t* senderAddresses,
     uint32_t numSenders,
     const std::vector<std::shared_ptr<PlayerData>>& playerData,
-    const std::vector<std::shared_ptr<DreamcastMainNode>>& nodes
+    const std::vector<std::shared_ptr<DreamcastMainNode>>& nodes,
+    LineOutput* lineOutput
 ) :
     mIdentification(identification),
+    mClock(clock),
     mSchedulers(schedulers),
     mSenderAddresses(senderAddresses),
     mNumSenders(numSenders),
     mPlayerData(playerData),
     nodes(nodes)
-{}
+{
+    flycastTimestamps.clock = &clock;
+    flycastTimestamps.enabled = false;
+    flycastResponses.output = lineOutput;
+}
 
 const char* FlycastCommandParser::getCommandChars()
 {
@@ -72,6 +502,67 @@ const char* FlycastCommandParser::getCommandChars()
     return "X";
 }
 
+int32_t FlycastCommandParser::selectSender(MaplePacket& packet)
+{
+    int32_t idx = -1;
+    const uint8_t* senderAddress = mSenderAddresses;
+
+    if (mNumSenders == 1)
+    {
+        // Single player special case - always send to the one available, regardless of address
+        idx = 0;
+        packet.frame.senderAddr = *senderAddress;
+        packet.frame.recipientAddr = (packet.frame.recipientAddr & 0x3F) | *senderAddress;
+    }
+    else
+    {
+        uint8_t sender = packet.frame.senderAddr;
+        for (uint32_t i = 0; i < mNumSenders && idx < 0; ++i, ++senderAddress)
+        {
+            if (sender == *senderAddress)
+            {
+                idx = i;
+            }
+        }
+    }
+
+    return idx;
+}
+
+bool FlycastCommandParser::submitBinary(char command, const uint8_t* data, uint32_t len, BinaryOutput& output)
+{
+    // Binary data is only ever a packet to send; special commands are only available as text
+    MaplePacket packet;
+    uint8_t status = MapleBinaryFrame::readPacket(data, len, packet);
+    int32_t idx = -1;
+
+    if (status == MapleBinaryFrame::STATUS_COMPLETE)
+    {
+        idx = selectSender(packet);
+        if (idx < 0)
+        {
+            status = MapleBinaryFrame::STATUS_INVALID_SENDER;
+        }
+    }
+
+    if (idx >= 0)
+    {
+        flycastBinaryTransmitter.output = &output;
+        mSchedulers[idx]->add(
+            PrioritizedTxScheduler::EXTERNAL_TRANSMISSION_PRIORITY,
+            PrioritizedTxScheduler::TX_TIME_ASAP,
+            &flycastBinaryTransmitter,
+            packet,
+            true);
+    }
+    else
+    {
+        output.writeFrame(COMMAND_CHAR, &status, 1);
+    }
+
+    return true;
+}
+
 void FlycastCommandParser::submit(const char* chars, uint32_t len)
 {
     if (len == 0)
@@ -80,9 +571,7 @@ void FlycastCommandParser::submit(const char* chars, uint32_t len)
         return;
     }
 
-    bool valid = false;
     const char* eol = chars + len;
-    std::vector<uint32_t> words;
     const char* iter = chars + 1; // Skip past 'X' (implied)
 
     // left strip
@@ -96,6 +585,10 @@ void FlycastCommandParser::submit(const char* chars, uint32_t len)
         --eol;
     }
 
+    // Set when the packet is tagged
+    int32_t tag = -1;
+    char tagPrefix[8] = "";
+
     // Check for special commanding
     if (iter < eol)
     {
@@ -175,6 +668,232 @@ void FlycastCommandParser::submit(const char* chars, uint32_t len)
             }
             return;
 
+            // XR [0-3] prints the controller poll period settings for the given player:
+            //   requested period, effective period, minimum period, measured period (all in us)
+            // XR [0-3] [period us] requests a new controller poll period for the given player
+            case 'R' :
+            {
+                // Remove R
+                ++iter;
+                int idx = -1;
+                unsigned int periodUs = 0;
+                int numValues = sscanf(iter, "%i %u", &idx, &periodUs);
+                if (numValues >= 1 && idx >= 0 && static_cast<std::size_t>(idx) < mPlayerData.size())
+                {
+                    PollSettings& pollSettings = mPlayerData[idx]->pollSettings;
+                    if (numValues == 1)
+                    {
+                        printf(
+                            "%lu %lu %lu %lu\n",
+                            (long unsigned int)pollSettings.getRequestedControllerPeriodUs(),
+                            (long unsigned int)pollSettings.getEffectiveControllerPeriodUs(),
+                            (long unsigned int)pollSettings.getMinControllerPeriodUs(),
+                            (long unsigned int)pollSettings.getMeasuredControllerPeriodUs());
+                    }
+                    else if (pollSettings.requestControllerPeriodUs(periodUs))
+                    {
+                        printf("1\n");
+                    }
+                    else
+                    {
+                        printf("0\n");
+                    }
+                }
+                else
+                {
+                    printf("0\n");
+                }
+            }
+            return;
+
+            // XL [0-3] prints 1 if controller polls of the given player are aligned to USB frames
+            // XL [0-3] [0-1] disables or enables alignment of controller polls to USB frames
+            case 'L' :
+            {
+                // Remove L
+                ++iter;
+                int idx = -1;
+                int aligned = 0;
+                int numValues = sscanf(iter, "%i %i", &idx, &aligned);
+                if (numValues >= 1 && idx >= 0 && static_cast<std::size_t>(idx) < mPlayerData.size())
+                {
+                    PollSettings& pollSettings = mPlayerData[idx]->pollSettings;
+                    if (numValues == 1)
+                    {
+                        printf("%i\n", pollSettings.isFrameAligned() ? 1 : 0);
+                    }
+                    else if (pollSettings.setFrameAligned(aligned != 0))
+                    {
+                        printf("1\n");
+                    }
+                    else
+                    {
+                        printf("0\n");
+                    }
+                }
+                else
+                {
+                    printf("0\n");
+                }
+            }
+            return;
+
+            // XV [0-3] prints the emulator frame alignment of the given player: emulated frame period,
+            //   input read phase, mean alignment error, max alignment error (all in us, period 0 when
+            //   not aligned)
+            // XV [0-3] 0 stops aligning controller polls of the given player to emulated frames
+            // XV [0-3] [period us] [offset us] aligns controller polls of the given player to emulated
+            //   frames; the emulator's next input read is offset us after this command
+            //   (must be repeated within 2 seconds to stay aligned)
+            case 'V' :
+            {
+                // Remove V
+                ++iter;
+                int idx = -1;
+                unsigned int periodUs = 0;
+                unsigned int offsetUs = 0;
+                int numValues = sscanf(iter, "%i %u %u", &idx, &periodUs, &offsetUs);
+                if (numValues >= 1 && idx >= 0 && static_cast<std::size_t>(idx) < mPlayerData.size())
+                {
+                    PollSettings& pollSettings = mPlayerData[idx]->pollSettings;
+                    uint64_t currentTimeUs = mPlayerData[idx]->clock.getTimeUs();
+                    if (numValues == 1)
+                    {
+                        uint32_t framePeriodUs = 0;
+                        uint32_t readPhaseUs = 0;
+                        pollSettings.getEmulatorFrame(currentTimeUs, framePeriodUs, readPhaseUs);
+                        printf(
+                            "%lu %lu %li %lu\n",
+                            (long unsigned int)framePeriodUs,
+                            (long unsigned int)readPhaseUs,
+                            (long int)pollSettings.getMeanAlignmentErrorUs(),
+                            (long unsigned int)pollSettings.getMaxAlignmentErrorUs());
+                    }
+                    else if (numValues == 2 && periodUs == 0)
+                    {
+                        pollSettings.clearEmulatorFrame();
+                        printf("1\n");
+                    }
+                    else if (numValues == 3
+                             && pollSettings.setEmulatorFrame(
+                                 periodUs, currentTimeUs + offsetUs, currentTimeUs))
+                    {
+                        printf("1\n");
+                    }
+                    else
+                    {
+                        printf("0\n");
+                    }
+                }
+                else
+                {
+                    printf("0\n");
+                }
+            }
+            return;
+
+            // XN [0-3] prints 1 if condition changes of the given player are pushed as they happen
+            // XN [0-3] [0-1] stops or starts pushing condition changes of the given player
+            case 'N' :
+            {
+                // Remove N
+                ++iter;
+                int idx = -1;
+                int subscribed = 0;
+                int numValues = sscanf(iter, "%i %i", &idx, &subscribed);
+                if (numValues >= 1
+                    && idx >= 0
+                    && static_cast<std::size_t>(idx) < mPlayerData.size()
+                    && mPlayerData[idx]->conditionPublisher != nullptr)
+                {
+                    ConditionPublisher& publisher = *mPlayerData[idx]->conditionPublisher;
+                    if (numValues == 1)
+                    {
+                        printf("%i\n", publisher.isSubscribed() ? 1 : 0);
+                    }
+                    else
+                    {
+                        // Acknowledge before the first record is written
+                        printf("1\n");
+                        publisher.setSubscribed(subscribed != 0);
+                    }
+                }
+                else
+                {
+                    printf("0\n");
+                }
+            }
+            return;
+
+            // XK prints the device time as '^' then 16 hex characters of time in microseconds, for the
+            //   emulator to estimate clock offset and drift from round trips
+            // XK [0-1] disables or enables prefixing every response of a packet which reached the bus
+            //   with the device time at bus completion, in the same format followed by a space
+            case 'K' :
+            {
+                // Remove K
+                ++iter;
+                int enabled = 0;
+                if (1 == sscanf(iter, "%i", &enabled))
+                {
+                    flycastTimestamps.enabled = (enabled != 0);
+                    printf("1\n");
+                }
+                else
+                {
+                    char text[FlycastTimestamps::LEN];
+                    char* end = FlycastTimestamps::encode(mClock.getTimeUs(), text);
+                    end[-1] = '\n';
+                    fwrite(text, 1, end - text, stdout);
+                }
+            }
+            return;
+
+            // XO prints the number of bytes of output dropped so far because the output was full
+            case 'O' :
+            {
+                printf("%lu\n", (long unsigned int)flycastResponses.getDroppedCount());
+            }
+            return;
+
+            // XT [0-3] prints the input latency of the given player, from Maple Bus response to USB
+            //   report delivered: number of samples, p50, p90, p99, maximum (all in us)
+            // XT [0-3] - clears the input latency samples of the given player
+            case 'T' :
+            {
+                // Remove T
+                ++iter;
+                int idx = -1;
+                char op = '\0';
+                int numValues = sscanf(iter, "%i %c", &idx, &op);
+                LatencyHistogram* histogram = nullptr;
+                if (numValues >= 1 && idx >= 0 && static_cast<std::size_t>(idx) < mPlayerData.size())
+                {
+                    histogram = mPlayerData[idx]->gamepad.getInputLatencyHistogram();
+                }
+
+                if (histogram == nullptr || (numValues == 2 && op != '-'))
+                {
+                    printf("0\n");
+                }
+                else if (numValues == 2)
+                {
+                    histogram->reset();
+                    printf("1\n");
+                }
+                else
+                {
+                    printf(
+                        "%lu %lu %lu %lu %lu\n",
+                        (long unsigned int)histogram->getCount(),
+                        (long unsigned int)histogram->getPercentileUs(500),
+                        (long unsigned int)histogram->getPercentileUs(900),
+                        (long unsigned int)histogram->getPercentileUs(990),
+                        (long unsigned int)histogram->getMaxUs());
+                }
+            }
+            return;
+
             // X?0, X?1, X?2, or X?3 will print summary for the given node index
             case '?' :
             {
@@ -202,6 +921,74 @@ void FlycastCommandParser::submit(const char* chars, uint32_t len)
             }
             return;
 
+            // X@<tag> <packet> sends a packet and tags its response line
+            case '@' :
+            {
+                // Remove @
+                ++iter;
+                const char* const tagStart = iter;
+                uint32_t value = 0;
+                while (iter < eol && *iter >= '0' && *iter <= '9' && value <= 0xFFFF)
+                {
+                    value = value * 10 + (*iter++ - '0');
+                }
+
+                if (iter == tagStart || value > 0xFFFF || (iter < eol && !std::isspace(*iter)))
+                {
+                    printf("*failed invalid tag\n");
+                    return;
+                }
+
+                tag = value;
+                snprintf(tagPrefix, sizeof(tagPrefix), "@%u ", (unsigned int)value);
+            }
+            break;
+
+            // XM <packet>[;<packet>...] sends all packets at once, each on its own bus, then prints
+            // the responses in the same order, separated by ';', on one line once all are done
+            case 'M' :
+            {
+                // Remove M
+                ++iter;
+                const uint32_t numPackets = 1 + std::count(iter, eol, ';');
+                if (numPackets > FlycastBatchTransmitter::MAX_PACKETS)
+                {
+                    printf("*failed too many packets\n");
+                    return;
+                }
+
+                int32_t batchIdx = flycastBatchTransmitter.start(numPackets);
+                if (batchIdx < 0)
+                {
+                    printf("*failed busy\n");
+                    return;
+                }
+
+                for (uint32_t i = 0; i < numPackets; ++i)
+                {
+                    const char* const end = std::find(iter, eol, ';');
+                    MaplePacket packet;
+                    int32_t idx = -1;
+                    const char* failure = decodePacket(iter, end - iter, packet, idx);
+                    if (failure == nullptr)
+                    {
+                        uint32_t id = mSchedulers[idx]->add(
+                            PrioritizedTxScheduler::EXTERNAL_TRANSMISSION_PRIORITY,
+                            PrioritizedTxScheduler::TX_TIME_ASAP,
+                            &flycastBatchTransmitter,
+                            packet,
+                            true);
+                        flycastBatchTransmitter.add(batchIdx, i, mSenderAddresses[idx], id);
+                    }
+                    else
+                    {
+                        flycastBatchTransmitter.setFailed(batchIdx, i, failure);
+                    }
+                    iter = end + 1;
+                }
+            }
+            return;
+
             // Reserved
             case ' ': // Fall through
             case '0': // Fall through
@@ -232,96 +1019,92 @@ void FlycastCommandParser::submit(const char* chars, uint32_t len)
         }
     }
 
-    while (iter < eol)
+    MaplePacket packet;
+    int32_t idx = -1;
+    const char* failure = decodePacket(iter, eol - iter, packet, idx);
+    if (failure == nullptr)
     {
-        uint32_t word = 0;
-        uint32_t i = 0;
-        while (i < 8 && iter < eol)
-        {
-            char v = *iter++;
-            uint_fast8_t value = 0;
-
-            if (v >= '0' && v <= '9')
-            {
-                value = v - '0';
-            }
-            else if (v >= 'a' && v <= 'f')
-            {
-                value = v - 'a' + 0xa;
-            }
-            else if (v >= 'A' && v <= 'F')
-            {
-                value = v - 'A' + 0xA;
-            }
-            else
-            {
-                // Ignore this character
-                continue;
-            }
+        uint32_t id = mSchedulers[idx]->add(
+            PrioritizedTxScheduler::EXTERNAL_TRANSMISSION_PRIORITY,
+            PrioritizedTxScheduler::TX_TIME_ASAP,
+            (tag >= 0) ? static_cast<Transmitter*>(&flycastTaggedTransmitter)
+                       : static_cast<Transmitter*>(&flycastEchoTransmitter),
+            packet,
+            true);
 
-            // Apply value into current word
-            word |= (value << ((8 - i) * 4 - 4));
-            ++i;
+        if (tag >= 0)
+        {
+            // The scheduler sets the sender address of the transmitted packet to that of its bus
+            flycastTaggedTransmitter.tags.add(mSenderAddresses[idx], id, tag);
         }
+    }
+    else
+    {
+        char text[sizeof(tagPrefix) + 32];
+        int textLen = snprintf(text, sizeof(text), "%s*failed %s\n", tagPrefix, failure);
+        flycastResponses.write(text, textLen);
+    }
+}
 
-        // Invalid if a partial word was given
-        valid = ((i == 8) || (i == 0));
+const char* FlycastCommandParser::decodePacket(const char* chars,
+                                               uint32_t len,
+                                               MaplePacket& packet,
+                                               int32_t& idx)
+{
+    int32_t numWords = MapleHexDecoder::decode(chars, len, mWords, MapleBinaryFrame::MAX_PACKET_WORDS);
+    if (numWords == MapleHexDecoder::MISSING_DATA)
+    {
+        return "missing data";
+    }
 
-        if (i == 8)
-        {
-            words.push_back(word);
-        }
+    packet.reset();
+    if (numWords > 0)
+    {
+        packet = MaplePacket(MaplePacket::Frame::fromWord(mWords[0]), &mWords[1], numWords - 1);
+    }
+    if (!packet.isValid())
+    {
+        return "packet invalid";
     }
 
-    if (valid)
+    idx = selectSender(packet);
+    if (idx < 0)
     {
-        MaplePacket packet(&words[0], words.size());
-        if (packet.isValid())
-        {
-            uint8_t sender = packet.frame.senderAddr;
-            int32_t idx = -1;
-            const uint8_t* senderAddress = mSenderAddresses;
+        return "invalid sender";
+    }
 
-            if (mNumSenders == 1)
-            {
-                // Single player special case - always send to the one available, regardless of address
-                idx = 0;
-                packet.frame.senderAddr = *senderAddress;
-                packet.frame.recipientAddr = (packet.frame.recipientAddr & 0x3F) | *senderAddress;
-            }
-            else
-            {
-                for (uint32_t i = 0; i < mNumSenders && idx < 0; ++i, ++senderAddress)
-                {
-                    if (sender == *senderAddress)
-                    {
-                        idx = i;
-                    }
-                }
-            }
+    return nullptr;
+}
 
-            if (idx >= 0)
-            {
-                mSchedulers[idx]->add(
-                    PrioritizedTxScheduler::EXTERNAL_TRANSMISSION_PRIORITY,
-                    PrioritizedTxScheduler::TX_TIME_ASAP,
-                    &flycastEchoTransmitter,
-                    packet,
-                    true);
-            }
-            else
-            {
-                printf("*failed invalid sender\n");
-            }
-        }
-        else
+void FlycastCommandParser::setBinaryOutput(BinaryOutput* output)
+{
+    for (std::vector<std::shared_ptr<PlayerData>>::iterator iter = mPlayerData.begin();
+         iter != mPlayerData.end();
+         ++iter)
+    {
+        if ((*iter)->conditionPublisher != nullptr)
         {
-            printf("*failed packet invalid\n");
+            (*iter)->conditionPublisher->setBinaryOutput(output);
         }
     }
-    else
+}
+
+void FlycastCommandParser::sessionReset()
+{
+    // The next program to open the stream may not know any of what this one set up
+    flycastTimestamps.enabled = false;
+    flycastTaggedTransmitter.tags.clear();
+    flycastBatchTransmitter.reset();
+
+    for (std::vector<std::shared_ptr<PlayerData>>::iterator iter = mPlayerData.begin();
+         iter != mPlayerData.end();
+         ++iter)
     {
-        printf("*failed missing data\n");
+        if ((*iter)->conditionPublisher != nullptr)
+        {
+            (*iter)->conditionPublisher->setSubscribed(false);
+            (*iter)->conditionPublisher->setBinaryOutput(nullptr);
+        }
     }
 }
 
@@ -329,3 +1112,8 @@ void FlycastCommandParser::printHelp()
 {
     printf("X: commands from a flycast emulator\n");
 }
+
+uint32_t FlycastCommandParser::getNumPendingTags() const
+{
+    return flycastTaggedTransmitter.tags.size();
+}
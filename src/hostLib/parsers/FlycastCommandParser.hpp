@@ -1,9 +1,12 @@
 #pragma once
 
 #include "hal/Usb/CommandParser.hpp"
+#include "hal/Usb/LineOutput.hpp"
 #include "hal/System/SystemIdentification.hpp"
+#include "hal/System/ClockInterface.hpp"
 
 #include "PrioritizedTxScheduler.hpp"
+#include "MapleBinaryFrame.hpp"
 
 #include "PlayerData.hpp"
 #include "DreamcastMainNode.hpp"
@@ -18,11 +21,13 @@ class FlycastCommandParser : public CommandParser
 public:
     FlycastCommandParser(
         SystemIdentification& identification,
+        ClockInterface& clock,
         std::shared_ptr<PrioritizedTxScheduler>* schedulers,
         const uint8_t* senderAddresses,
         uint32_t numSenders,
         const std::vector<std::shared_ptr<PlayerData>>& playerData,
-        const std::vector<std::shared_ptr<DreamcastMainNode>>& nodes);
+        const std::vector<std::shared_ptr<DreamcastMainNode>>& nodes,
+        LineOutput* lineOutput);
 
     //! @returns the string of command characters this parser handles
     virtual const char* getCommandChars() final;
@@ -30,14 +35,47 @@ public:
     //! Called when newline reached; submit command and reset
     virtual void submit(const char* chars, uint32_t len) final;
 
+    //! Called when a binary frame is received; data is the words of a packet to send
+    virtual bool submitBinary(char command, const uint8_t* data, uint32_t len, BinaryOutput& output) final;
+
+    //! Called when the stream switches between text and binary; condition records follow the mode
+    virtual void setBinaryOutput(BinaryOutput* output) final;
+
+    //! Called when the host closes the stream; drops all condition subscriptions, disables time
+    //! stamps and forgets pending tags and batches
+    virtual void sessionReset() final;
+
     //! Prints help message for this command
     virtual void printHelp() final;
 
+    //! @returns the number of tagged packets waiting on a response
+    uint32_t getNumPendingTags() const;
+
+public:
+    //! The command character of flycast commands and their binary responses
+    static const char COMMAND_CHAR = 'X';
+
+private:
+    //! Selects the bus for the given packet, updating its addresses if needed
+    //! @returns index of the selected sender or -1 if the sender address is invalid
+    int32_t selectSender(MaplePacket& packet);
+
+    //! Decodes a packet from hex text and selects its bus
+    //! @param[in] chars  The text to decode
+    //! @param[in] len  Number of characters in chars
+    //! @param[out] packet  The decoded packet, with addresses updated for its bus
+    //! @param[out] idx  Index of the selected sender
+    //! @returns nullptr on success or the reason the packet can't be sent
+    const char* decodePacket(const char* chars, uint32_t len, MaplePacket& packet, int32_t& idx);
+
 private:
     SystemIdentification& mIdentification;
+    ClockInterface& mClock;
     std::shared_ptr<PrioritizedTxScheduler>* const mSchedulers;
     const uint8_t* const mSenderAddresses;
     const uint32_t mNumSenders;
+    //! Words decoded from the last submitted line
+    uint32_t mWords[MapleBinaryFrame::MAX_PACKET_WORDS];
     std::vector<std::shared_ptr<PlayerData>> mPlayerData;
     std::vector<std::shared_ptr<DreamcastMainNode>> nodes;
 };
@@ -0,0 +1,102 @@
+#pragma once
+
+#include "hal/MapleBus/MaplePacket.hpp"
+
+#include <stdint.h>
+#include <vector>
+
+// Encoding shared by all binary maple bus interfaces: values are little endian, and a packet is its
+// frame word followed by its payload words
+
+//! Helpers to encode and decode binary maple bus data
+class MapleBinaryFrame
+{
+public:
+    //! Status which leads each binary response
+    enum Status : uint8_t
+    {
+        //! Response received; maple words follow
+        STATUS_COMPLETE = 0,
+        //! Failed to write the packet on the bus
+        STATUS_WRITE_FAILED,
+        //! Failed to read a response from the bus
+        STATUS_READ_FAILED,
+        //! The given maple words don't form a valid packet
+        STATUS_INVALID_PACKET,
+        //! The sender address doesn't match any of the bus hosts
+        STATUS_INVALID_SENDER,
+        //! The request length isn't a whole number of words
+        STATUS_MALFORMED,
+        //! The packet was scheduled for transmission
+        STATUS_SCHEDULED,
+        //! A response was received, but it didn't fit in the output queue and was dropped
+        STATUS_RESPONSE_DROPPED
+    };
+
+    //! Maximum number of words in a packet (frame word and 255 payload words)
+    static const uint32_t MAX_PACKET_WORDS = 256;
+
+    //! Appends a 16-bit value
+    static inline void appendU16(std::vector<uint8_t>& out, uint16_t value)
+    {
+        out.push_back(value & 0xFF);
+        out.push_back((value >> 8) & 0xFF);
+    }
+
+    //! Appends a 32-bit value
+    static inline void appendU32(std::vector<uint8_t>& out, uint32_t value)
+    {
+        out.push_back(value & 0xFF);
+        out.push_back((value >> 8) & 0xFF);
+        out.push_back((value >> 16) & 0xFF);
+        out.push_back((value >> 24) & 0xFF);
+    }
+
+    //! Appends the frame word then payload words of a packet
+    static inline void appendPacket(std::vector<uint8_t>& out, const MaplePacket& packet)
+    {
+        out.reserve(out.size() + (packet.payload.size() + 1) * 4);
+        appendU32(out, packet.getFrameWord());
+        for (uint32_t word : packet.payload)
+        {
+            appendU32(out, word);
+        }
+    }
+
+    //! @returns the 16-bit value at data
+    static inline uint16_t readU16(const uint8_t* data)
+    {
+        return data[0] | (data[1] << 8);
+    }
+
+    //! @returns the 32-bit value at data
+    static inline uint32_t readU32(const uint8_t* data)
+    {
+        return data[0] | (data[1] << 8) | (data[2] << 16) | (static_cast<uint32_t>(data[3]) << 24);
+    }
+
+    //! Decodes a packet from its words
+    //! @param[in] data  The frame word followed by payload words
+    //! @param[in] len  Number of bytes in data
+    //! @param[out] packet  The decoded packet
+    //! @returns STATUS_COMPLETE if packet was decoded or the reason it couldn't be
+    static inline Status readPacket(const uint8_t* data, uint32_t len, MaplePacket& packet)
+    {
+        uint32_t numWords = len / 4;
+        if (numWords == 0 || (len % 4) != 0 || numWords > MAX_PACKET_WORDS)
+        {
+            return STATUS_MALFORMED;
+        }
+
+        packet.frame = MaplePacket::Frame::fromWord(readU32(data));
+        packet.payload.resize(numWords - 1);
+        for (uint32_t& word : packet.payload)
+        {
+            data += 4;
+            word = readU32(data);
+        }
+        packet.updateFrameLength();
+
+        return packet.isValid() ? STATUS_COMPLETE : STATUS_INVALID_PACKET;
+    }
+};
@@ -0,0 +1,129 @@
+#include "MapleBinaryRequestHandler.hpp"
+#include "hal/MapleBus/MaplePacket.hpp"
+
+MapleBinaryRequestHandler::MapleBinaryRequestHandler(
+    std::shared_ptr<PrioritizedTxScheduler>* schedulers,
+    const uint8_t* senderAddresses,
+    uint32_t numSenders
+) :
+    mSchedulers(schedulers),
+    mSenderAddresses(senderAddresses),
+    mNumSenders(numSenders),
+    mStream(nullptr),
+    mPendingTags(),
+    mResponse()
+{}
+
+void MapleBinaryRequestHandler::handleRequest(const uint8_t* data, uint32_t len, VendorStream& stream)
+{
+    mStream = &stream;
+
+    if (len < TAG_SIZE)
+    {
+        // Nothing to pair a response with
+        return;
+    }
+
+    uint16_t tag = MapleBinaryFrame::readU16(data);
+    data += TAG_SIZE;
+    len -= TAG_SIZE;
+
+    MaplePacket packet;
+    MapleBinaryFrame::Status status = MapleBinaryFrame::readPacket(data, len, packet);
+    if (status != MapleBinaryFrame::STATUS_COMPLETE)
+    {
+        sendStatus(tag, status);
+        return;
+    }
+
+    uint8_t sender = packet.frame.senderAddr;
+    int32_t idx = -1;
+    const uint8_t* senderAddress = mSenderAddresses;
+
+    if (mNumSenders == 1)
+    {
+        // Single player special case - always send to the one available, regardless of address
+        idx = 0;
+        packet.frame.senderAddr = *senderAddress;
+        packet.frame.recipientAddr = (packet.frame.recipientAddr & 0x3F) | *senderAddress;
+    }
+    else
+    {
+        for (uint32_t i = 0; i < mNumSenders && idx < 0; ++i, ++senderAddress)
+        {
+            if (sender == *senderAddress)
+            {
+                idx = i;
+            }
+        }
+    }
+
+    if (idx < 0)
+    {
+        sendStatus(tag, MapleBinaryFrame::STATUS_INVALID_SENDER);
+        return;
+    }
+
+    uint32_t id = mSchedulers[idx]->add(
+        PrioritizedTxScheduler::EXTERNAL_TRANSMISSION_PRIORITY,
+        PrioritizedTxScheduler::TX_TIME_ASAP,
+        this,
+        packet,
+        true);
+
+    // The scheduler sets the sender address of the transmitted packet to that of its bus
+    mPendingTags.add(mSenderAddresses[idx], id, tag);
+}
+
+void MapleBinaryRequestHandler::txStarted(const std::shared_ptr<const Transmission>& tx)
+{}
+
+void MapleBinaryRequestHandler::txFailed(bool writeFailed,
+                                         bool readFailed,
+                                         const std::shared_ptr<const Transmission>& tx)
+{
+    uint16_t tag;
+    if (mPendingTags.take(*tx, tag))
+    {
+        sendStatus(tag, writeFailed ? MapleBinaryFrame::STATUS_WRITE_FAILED : MapleBinaryFrame::STATUS_READ_FAILED);
+    }
+}
+
+void MapleBinaryRequestHandler::txComplete(const std::shared_ptr<const MaplePacket>& packet,
+                                           const std::shared_ptr<const Transmission>& tx)
+{
+    uint16_t tag;
+    if (!mPendingTags.take(*tx, tag) || mStream == nullptr)
+    {
+        return;
+    }
+
+    mResponse.clear();
+    MapleBinaryFrame::appendU16(mResponse, tag);
+    mResponse.push_back(MapleBinaryFrame::STATUS_COMPLETE);
+    MapleBinaryFrame::appendPacket(mResponse, *packet);
+
+    if (!mStream->sendResponse(&mResponse[0], mResponse.size()))
+    {
+        // Small status frames may still fit - let the host know that this request was answered
+        sendStatus(tag, MapleBinaryFrame::STATUS_RESPONSE_DROPPED);
+    }
+}
+
+uint32_t MapleBinaryRequestHandler::getNumPending() const
+{
+    return mPendingTags.size();
+}
+
+void MapleBinaryRequestHandler::sendStatus(uint16_t tag, MapleBinaryFrame::Status status)
+{
+    if (mStream != nullptr)
+    {
+        const uint8_t response[RESPONSE_HEADER_SIZE] = {
+            static_cast<uint8_t>(tag & 0xFF),
+            static_cast<uint8_t>((tag >> 8) & 0xFF),
+            status
+        };
+        mStream->sendResponse(response, sizeof(response));
+    }
+}
@@ -0,0 +1,61 @@
+#pragma once
+
+#include "hal/Usb/VendorStream.hpp"
+
+#include "PrioritizedTxScheduler.hpp"
+#include "Transmitter.hpp"
+#include "MapleBinaryFrame.hpp"
+#include "TransmissionTags.hpp"
+
+#include <memory>
+
+// Request structure: <tag: 16-bit><maple words: 32-bit each>
+// Response structure: <tag: 16-bit><status: 8-bit>[maple words: 32-bit each]
+// See MapleBinaryFrame for encoding of values and status
+
+//! Handles binary maple bus requests from the vendor interface
+//! Each request is sent exactly like the flycast 'X' command, but the response is returned as a
+//! binary frame which carries the tag of its request so that the host may pair them up
+class MapleBinaryRequestHandler : public VendorRequestHandler, public Transmitter
+{
+public:
+    MapleBinaryRequestHandler(
+        std::shared_ptr<PrioritizedTxScheduler>* schedulers,
+        const uint8_t* senderAddresses,
+        uint32_t numSenders);
+
+    //! Called for each complete request from the vendor stream
+    virtual void handleRequest(const uint8_t* data, uint32_t len, VendorStream& stream) final;
+
+    //! Transmitter overrides
+    virtual void txStarted(const std::shared_ptr<const Transmission>& tx) final;
+    virtual void txFailed(bool writeFailed,
+                          bool readFailed,
+                          const std::shared_ptr<const Transmission>& tx) final;
+    virtual void txComplete(const std::shared_ptr<const MaplePacket>& packet,
+                            const std::shared_ptr<const Transmission>& tx) final;
+
+    //! @returns the number of requests waiting on a response
+    uint32_t getNumPending() const;
+
+public:
+    //! Number of bytes in a tag
+    static const uint32_t TAG_SIZE = 2;
+    //! Number of bytes in a response header (tag and status)
+    static const uint32_t RESPONSE_HEADER_SIZE = TAG_SIZE + 1;
+
+private:
+    //! Sends a response without any maple words
+    void sendStatus(uint16_t tag, MapleBinaryFrame::Status status);
+
+private:
+    std::shared_ptr<PrioritizedTxScheduler>* const mSchedulers;
+    const uint8_t* const mSenderAddresses;
+    const uint32_t mNumSenders;
+    //! The stream which requests are received from and responses are sent to
+    VendorStream* mStream;
+    //! Tag of each request waiting on a response
+    TransmissionTags mPendingTags;
+    //! Buffer used to build responses
+    std::vector<uint8_t> mResponse;
+};
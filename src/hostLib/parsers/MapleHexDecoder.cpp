@@ -0,0 +1,128 @@
+#include "MapleHexDecoder.hpp"
+
+#include <string.h>
+
+static_assert(__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__, "decode4() expects little endian loads");
+
+const int32_t MapleHexDecoder::MISSING_DATA;
+const int32_t MapleHexDecoder::TOO_MANY_WORDS;
+
+//! Value to multiply a byte by to repeat it in each byte of a word
+#define EACH_BYTE 0x01010101U
+
+//! Decodes 4 hex characters at once
+//! @param[in] chars  The 4 characters to decode
+//! @param[out] value  The decoded 16-bit value, set only when all 4 characters are hex
+//! @returns true iff all 4 characters are hex
+static inline bool decode4(const char* chars, uint32_t& value)
+{
+    uint32_t x;
+    memcpy(&x, chars, sizeof(x));
+
+    // Each test leaves its result in the high bit of each byte. No byte can carry into the next
+    // because anything with its high bit set is rejected first.
+    const uint32_t lower = x | (0x20 * EACH_BYTE);
+    const uint32_t isDigit = (x + 0x50 * EACH_BYTE) & ~(x + 0x46 * EACH_BYTE); // [0x30,0x39]
+    const uint32_t isLetter = (lower + 0x1F * EACH_BYTE) & ~(lower + 0x19 * EACH_BYTE); // [a,f]
+    if (((isDigit | isLetter) & ~x & (0x80 * EACH_BYTE)) != (0x80 * EACH_BYTE))
+    {
+        return false;
+    }
+
+    // Letters have bit 6 set, and their low nibble is 9 less than their value
+    const uint32_t nibbles = (x & (0x0F * EACH_BYTE)) + ((x >> 6) & EACH_BYTE) * 9;
+
+    // First character is in the low byte; pair up nibbles into bytes then bytes into the value
+    const uint32_t bytes = ((nibbles & 0x000F000F) << 4) | ((nibbles >> 8) & 0x000F000F);
+    value = ((bytes & 0xFF) << 8) | (bytes >> 16);
+    return true;
+}
+
+//! @param[in] c  The character to decode
+//! @returns the value of the given hex character or a value over 0xF if c isn't hex
+static inline uint32_t decode1(char c)
+{
+    uint32_t value = static_cast<uint8_t>(c) - '0';
+    if (value > 9)
+    {
+        value = static_cast<uint8_t>(c | 0x20) - 'a' + 0xA;
+        if (value < 0xA)
+        {
+            value = 0xFF;
+        }
+    }
+    return value;
+}
+
+bool MapleHexDecoder::decode8(const char* chars, uint32_t& word)
+{
+    uint32_t high;
+    uint32_t low;
+    if (decode4(chars, high) && decode4(chars + 4, low))
+    {
+        word = (high << 16) | low;
+        return true;
+    }
+    return false;
+}
+
+int32_t MapleHexDecoder::decode(const char* chars, uint32_t len, uint32_t* words, uint32_t maxWords)
+{
+    if (len == 0)
+    {
+        return MISSING_DATA;
+    }
+
+    const char* const eol = chars + len;
+    uint32_t numWords = 0;
+    uint32_t word = 0;
+    uint32_t numNibbles = 0;
+    while (chars < eol)
+    {
+        uint32_t value = decode1(*chars);
+        if (value > 0xF)
+        {
+            // Ignore this character
+            ++chars;
+            continue;
+        }
+
+        if (numNibbles == 0 && (eol - chars) >= 8 && decode8(chars, value))
+        {
+            // Fast path - a whole word without separators
+            chars += 8;
+        }
+        else
+        {
+            // Slow path - a single character
+            ++chars;
+            word = (word << 4) | value;
+            if (++numNibbles < 8)
+            {
+                continue;
+            }
+
+            value = word;
+            word = 0;
+            numNibbles = 0;
+        }
+
+        if (numWords < maxWords)
+        {
+            words[numWords] = value;
+        }
+        ++numWords;
+    }
+
+    if (numNibbles != 0)
+    {
+        // Invalid if a partial word was given
+        return MISSING_DATA;
+    }
+    else if (numWords > maxWords)
+    {
+        return TOO_MANY_WORDS;
+    }
+
+    return numWords;
+}
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <stdint.h>
+
+// Decodes the text form of maple bus words: 8 hex characters per word, most significant first.
+// Characters which aren't hex are skipped wherever they are, so words may be separated (or even
+// broken up) by anything.
+
+//! SWAR (SIMD within a register) decoder of hex text to maple bus words
+class MapleHexDecoder
+{
+public:
+    //! Returned by decode() when no characters were given or the last word was only partially given
+    static const int32_t MISSING_DATA = -1;
+    //! Returned by decode() when more words were given than would fit
+    static const int32_t TOO_MANY_WORDS = -2;
+
+    //! Decodes words from hex characters
+    //! @param[in] chars  The characters to decode
+    //! @param[in] len  Number of characters in chars
+    //! @param[out] words  Where decoded words are written
+    //! @param[in] maxWords  The number of words which fit in words
+    //! @returns the number of words decoded or MISSING_DATA or TOO_MANY_WORDS
+    static int32_t decode(const char* chars, uint32_t len, uint32_t* words, uint32_t maxWords);
+
+    //! Decodes 8 hex characters at once
+    //! @param[in] chars  The 8 characters to decode
+    //! @param[out] word  The decoded word, set only when all 8 characters are hex
+    //! @returns true iff all 8 characters are hex
+    static bool decode8(const char* chars, uint32_t& word);
+};
@@ -0,0 +1,62 @@
+#include "MapleHexEncoder.hpp"
+
+const uint32_t MapleHexEncoder::MAX_WORDS_LEN;
+const uint32_t MapleHexEncoder::MAX_FLYCAST_LEN;
+const uint32_t MapleHexEncoder::MAX_DECIMAL_LEN;
+
+#define HEX_ROW(h) \
+    h "0" h "1" h "2" h "3" h "4" h "5" h "6" h "7" h "8" h "9" h "A" h "B" h "C" h "D" h "E" h "F"
+
+const char MapleHexEncoder::HEX_PAIRS[256 * 2 + 1] =
+    HEX_ROW("0") HEX_ROW("1") HEX_ROW("2") HEX_ROW("3")
+    HEX_ROW("4") HEX_ROW("5") HEX_ROW("6") HEX_ROW("7")
+    HEX_ROW("8") HEX_ROW("9") HEX_ROW("A") HEX_ROW("B")
+    HEX_ROW("C") HEX_ROW("D") HEX_ROW("E") HEX_ROW("F");
+
+#undef HEX_ROW
+
+char* MapleHexEncoder::encodeDecimal(uint32_t value, char* out)
+{
+    char digits[MAX_DECIMAL_LEN];
+    uint32_t count = 0;
+    do
+    {
+        digits[count++] = '0' + (value % 10);
+        value /= 10;
+    } while (value > 0);
+
+    while (count > 0)
+    {
+        *out++ = digits[--count];
+    }
+    return out;
+}
+
+char* MapleHexEncoder::encodeWords(const MaplePacket& packet, char* out)
+{
+    out = encodeWord(packet.frame.toWord(), out);
+    for (uint32_t word : packet.payload)
+    {
+        *out++ = ' ';
+        out = encodeWord(word, out);
+    }
+    return out;
+}
+
+char* MapleHexEncoder::encodeFlycast(const MaplePacket& packet, char* out)
+{
+    out = encodeByte(packet.frame.command, out);
+    *out++ = ' ';
+    out = encodeByte(packet.frame.recipientAddr, out);
+    *out++ = ' ';
+    out = encodeByte(packet.frame.senderAddr, out);
+    *out++ = ' ';
+    out = encodeByte(packet.frame.length, out);
+    for (uint32_t word : packet.payload)
+    {
+        *out++ = ' ';
+        out = encodeWord(word, out);
+    }
+    *out++ = '\n';
+    return out;
+}
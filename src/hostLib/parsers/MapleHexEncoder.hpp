@@ -0,0 +1,73 @@
+#pragma once
+
+#include "hal/MapleBus/MaplePacket.hpp"
+
+#include <stdint.h>
+
+// Text encoding shared by the text maple bus interfaces: words are 8 upper case hex characters,
+// separated by a single space. These helpers replace printf() formatting, which costs thousands of
+// cycles per word on the target.
+
+//! Table driven helpers to encode maple bus data as text
+class MapleHexEncoder
+{
+public:
+    //! Maximum length of encodeWords() output (frame word and 255 payload words)
+    static const uint32_t MAX_WORDS_LEN = 8 + 255 * 9;
+    //! Maximum length of encodeFlycast() output
+    static const uint32_t MAX_FLYCAST_LEN = 11 + 255 * 9 + 1;
+    //! Maximum length of encodeDecimal() output
+    static const uint32_t MAX_DECIMAL_LEN = 10;
+
+    //! Writes a byte as 2 hex characters
+    //! @param[in] value  The value to encode
+    //! @param[out] out  Where characters are written
+    //! @returns pointer to the character after the last one written
+    static inline char* encodeByte(uint8_t value, char* out)
+    {
+        const char* pair = &HEX_PAIRS[value * 2];
+        out[0] = pair[0];
+        out[1] = pair[1];
+        return out + 2;
+    }
+
+    //! Writes a word as 8 hex characters, most significant first
+    //! @param[in] value  The value to encode
+    //! @param[out] out  Where characters are written
+    //! @returns pointer to the character after the last one written
+    static inline char* encodeWord(uint32_t value, char* out)
+    {
+        out = encodeByte(value >> 24, out);
+        out = encodeByte(value >> 16, out);
+        out = encodeByte(value >> 8, out);
+        return encodeByte(value, out);
+    }
+
+    //! Writes an unsigned decimal value without leading zeros
+    //! @param[in] value  The value to encode
+    //! @param[out] out  Where characters are written
+    //! @returns pointer to the character after the last one written
+    static char* encodeDecimal(uint32_t value, char* out);
+
+    //! Writes the frame word then each payload word of a packet, separated by spaces
+    //! @param[in] packet  The packet to encode
+    //! @param[out] out  Where characters are written (must hold at least MAX_WORDS_LEN)
+    //! @returns pointer to the character after the last one written
+    static char* encodeWords(const MaplePacket& packet, char* out);
+
+    //! @returns the length of encodeFlycast() output for the given packet
+    static inline uint32_t getFlycastLen(const MaplePacket& packet)
+    {
+        return 11 + packet.payload.size() * 9 + 1;
+    }
+
+    //! Writes a packet as a flycast response line: each frame byte, then each payload word
+    //! @param[in] packet  The packet to encode
+    //! @param[out] out  Where characters are written (must hold at least MAX_FLYCAST_LEN)
+    //! @returns pointer to the character after the last one written (after the new line)
+    static char* encodeFlycast(const MaplePacket& packet, char* out);
+
+private:
+    //! The 2 hex characters of each byte value, in order
+    static const char HEX_PAIRS[256 * 2 + 1];
+};
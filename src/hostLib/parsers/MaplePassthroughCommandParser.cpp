@@ -23,19 +23,23 @@
 
 #include "MaplePassthroughCommandParser.hpp"
 #include "hal/MapleBus/MaplePacket.hpp"
+#include "MapleBinaryFrame.hpp"
+#include "MapleHexEncoder.hpp"
+#include "MapleHexDecoder.hpp"
 
 #include <stdio.h>
+#include <string.h>
 
 // Simple definition of a transmitter which just echos status and received data
 class EchoTransmitter : public Transmitter
 {
 public:
-    virtual void txStarted(std::shared_ptr<const Transmission> tx) final
+    virtual void txStarted(const std::shared_ptr<const Transmission>& tx) final
     {}
 
     virtual void txFailed(bool writeFailed,
                           bool readFailed,
-                          std::shared_ptr<const Transmission> tx) final
+                          const std::shared_ptr<const Transmission>& tx) final
     {
         if (writeFailed)
         {
@@ -47,21 +51,68 @@ public:
         }
     }
 
-    virtual void txComplete(std::shared_ptr<const MaplePacket> packet,
-                            std::shared_ptr<const Transmission> tx) final
+    virtual void txComplete(const std::shared_ptr<const MaplePacket>& packet,
+                            const std::shared_ptr<const Transmission>& tx) final
     {
-        printf("%lu: complete {", (long unsigned int)tx->transmissionId);
-        printf("%08lX", (long unsigned int)packet->frame.toWord());
-        for (std::vector<uint32_t>::const_iterator iter = packet->payload.begin();
-             iter != packet->payload.end();
-             ++iter)
-        {
-            printf(" %08lX", (long unsigned int)*iter);
-        }
-        printf("}\n");
+        static const char COMPLETE_STR[] = ": complete {";
+        char* end = MapleHexEncoder::encodeDecimal(tx->transmissionId, mText);
+        memcpy(end, COMPLETE_STR, sizeof(COMPLETE_STR) - 1);
+        end += sizeof(COMPLETE_STR) - 1;
+        end = MapleHexEncoder::encodeWords(*packet, end);
+        *end++ = '}';
+        *end++ = '\n';
+        fwrite(mText, 1, end - mText, stdout);
     }
+
+private:
+    //! Holds the response text (too large for the stack of the Maple Bus core)
+    char mText[MapleHexEncoder::MAX_DECIMAL_LEN + 12 + MapleHexEncoder::MAX_WORDS_LEN + 2];
 } echoTransmitter;
 
+// Transmitter which returns status, transmission ID, and received data as binary frames
+class BinaryEchoTransmitter : public Transmitter
+{
+public:
+    virtual void txStarted(const std::shared_ptr<const Transmission>& tx) final
+    {}
+
+    virtual void txFailed(bool writeFailed,
+                          bool readFailed,
+                          const std::shared_ptr<const Transmission>& tx) final
+    {
+        writeStatus(
+            writeFailed ? MapleBinaryFrame::STATUS_WRITE_FAILED : MapleBinaryFrame::STATUS_READ_FAILED,
+            tx->transmissionId);
+    }
+
+    virtual void txComplete(const std::shared_ptr<const MaplePacket>& packet,
+                            const std::shared_ptr<const Transmission>& tx) final
+    {
+        mResponse.clear();
+        mResponse.push_back(MapleBinaryFrame::STATUS_COMPLETE);
+        MapleBinaryFrame::appendU32(mResponse, tx->transmissionId);
+        MapleBinaryFrame::appendPacket(mResponse, *packet);
+        output->writeFrame(command, &mResponse[0], mResponse.size());
+    }
+
+    //! Writes a frame which contains just status and transmission ID
+    void writeStatus(uint8_t status, uint32_t transmissionId)
+    {
+        mResponse.clear();
+        mResponse.push_back(status);
+        MapleBinaryFrame::appendU32(mResponse, transmissionId);
+        output->writeFrame(command, &mResponse[0], mResponse.size());
+    }
+
+    //! Where responses are written (set on each binary submit)
+    BinaryOutput* output = nullptr;
+    //! The command character responses are written with (set on each binary submit)
+    char command = '0';
+
+private:
+    std::vector<uint8_t> mResponse;
+} binaryEchoTransmitter;
+
 MaplePassthroughCommandParser::MaplePassthroughCommandParser(std::shared_ptr<PrioritizedTxScheduler>* schedulers,
                                                              const uint8_t* senderAddresses,
                                                              uint32_t numSenders) :
@@ -78,54 +129,16 @@ const char* MaplePassthroughCommandParser::getCommandChars()
 
 void MaplePassthroughCommandParser::submit(const char* chars, uint32_t len)
 {
-    bool valid = false;
-    const char* const eol = chars + len;
-    std::vector<uint32_t> words;
-    const char* iter = chars;
-    while(iter < eol)
-    {
-        uint32_t word = 0;
-        uint32_t i = 0;
-        while (i < 8 && iter < eol)
-        {
-            char v = *iter++;
-            uint_fast8_t value = 0;
+    int32_t numWords = MapleHexDecoder::decode(
+        chars, len, mWords, MapleBinaryFrame::MAX_PACKET_WORDS);
 
-            if (v >= '0' && v <= '9')
-            {
-                value = v - '0';
-            }
-            else if (v >= 'a' && v <= 'f')
-            {
-                value = v - 'a' + 0xa;
-            }
-            else if (v >= 'A' && v <= 'F')
-            {
-                value = v - 'A' + 0xA;
-            }
-            else
-            {
-                // Ignore this character
-                continue;
-            }
-
-            // Apply value into current word
-            word |= (value << ((8 - i) * 4 - 4));
-            ++i;
-        }
-
-        // Invalid if a partial word was given
-        valid = ((i == 8) || (i == 0));
-
-        if (i == 8)
+    if (numWords != MapleHexDecoder::MISSING_DATA)
+    {
+        MaplePacket packet;
+        if (numWords > 0)
         {
-            words.push_back(word);
+            packet = MaplePacket(MaplePacket::Frame::fromWord(mWords[0]), &mWords[1], numWords - 1);
         }
-    }
-
-    if (valid)
-    {
-        MaplePacket packet(&words[0], words.size());
         if (packet.isValid())
         {
             uint8_t sender = packet.frame.senderAddr;
@@ -148,9 +161,10 @@ void MaplePassthroughCommandParser::submit(const char* chars, uint32_t len)
                     &echoTransmitter,
                     packet,
                     true);
-                std::vector<uint32_t>::iterator iter = words.begin();
+                const uint32_t* iter = mWords;
+                const uint32_t* const end = mWords + numWords;
                 printf("%lu: added {%08lX", (long unsigned int)id, (long unsigned int)*iter++);
-                for(; iter < words.end(); ++iter)
+                for(; iter < end; ++iter)
                 {
                     printf(" %08lX", (long unsigned int)*iter);
                 }
@@ -172,6 +186,55 @@ void MaplePassthroughCommandParser::submit(const char* chars, uint32_t len)
     }
 }
 
+bool MaplePassthroughCommandParser::submitBinary(char command,
+                                                 const uint8_t* data,
+                                                 uint32_t len,
+                                                 BinaryOutput& output)
+{
+    binaryEchoTransmitter.output = &output;
+    binaryEchoTransmitter.command = command;
+
+    MaplePacket packet;
+    uint8_t status = MapleBinaryFrame::readPacket(data, len, packet);
+    int32_t idx = -1;
+
+    if (status == MapleBinaryFrame::STATUS_COMPLETE)
+    {
+        uint8_t sender = packet.frame.senderAddr;
+        const uint8_t* senderAddress = mSenderAddresses;
+
+        for (uint32_t i = 0; i < mNumSenders && idx < 0; ++i, ++senderAddress)
+        {
+            if (sender == *senderAddress)
+            {
+                idx = i;
+            }
+        }
+
+        if (idx < 0)
+        {
+            status = MapleBinaryFrame::STATUS_INVALID_SENDER;
+        }
+    }
+
+    if (idx >= 0)
+    {
+        uint32_t id = mSchedulers[idx]->add(
+            PrioritizedTxScheduler::EXTERNAL_TRANSMISSION_PRIORITY,
+            PrioritizedTxScheduler::TX_TIME_ASAP,
+            &binaryEchoTransmitter,
+            packet,
+            true);
+        binaryEchoTransmitter.writeStatus(MapleBinaryFrame::STATUS_SCHEDULED, id);
+    }
+    else
+    {
+        binaryEchoTransmitter.writeStatus(status, 0);
+    }
+
+    return true;
+}
+
 void MaplePassthroughCommandParser::printHelp()
 {
     printf("0-1 a-f A-F: the beginning of a hex value to send to maple bus without CRC\n");
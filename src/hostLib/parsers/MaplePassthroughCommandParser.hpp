@@ -26,6 +26,7 @@
 #include "hal/Usb/CommandParser.hpp"
 
 #include "PrioritizedTxScheduler.hpp"
+#include "MapleBinaryFrame.hpp"
 
 #include <memory>
 
@@ -45,6 +46,9 @@ public:
     //! Called when newline reached; submit command and reset
     virtual void submit(const char* chars, uint32_t len) final;
 
+    //! Called when a binary frame is received; data is the words of a packet to send
+    virtual bool submitBinary(char command, const uint8_t* data, uint32_t len, BinaryOutput& output) final;
+
     //! Prints help message for this command
     virtual void printHelp() final;
 
@@ -52,4 +56,6 @@ private:
     std::shared_ptr<PrioritizedTxScheduler>* const mSchedulers;
     const uint8_t* const mSenderAddresses;
     const uint32_t mNumSenders;
+    //! Words decoded from the last submitted line
+    uint32_t mWords[MapleBinaryFrame::MAX_PACKET_WORDS];
 };
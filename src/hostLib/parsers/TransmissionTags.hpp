@@ -0,0 +1,63 @@
+#pragma once
+
+#include "Transmission.hpp"
+
+#include <stdint.h>
+#include <map>
+
+//! Pairs transmissions with the tags of the requests which added them so that responses can be
+//! returned in whatever order the buses complete them
+class TransmissionTags
+{
+public:
+    //! Associates a tag with a transmission
+    //! @param[in] senderAddr  The sender address of the bus the transmission was added to
+    //! @param[in] transmissionId  The ID of the added transmission
+    //! @param[in] tag  The tag of the request
+    inline void add(uint8_t senderAddr, uint32_t transmissionId, uint16_t tag)
+    {
+        mTags[toKey(senderAddr, transmissionId)] = tag;
+    }
+
+    //! Takes the tag associated with the given transmission
+    //! @param[in] tx  The transmission which completed or failed
+    //! @param[out] tag  The tag of the request which added tx
+    //! @returns false if tx has no tag
+    inline bool take(const Transmission& tx, uint16_t& tag)
+    {
+        std::map<uint64_t, uint16_t>::iterator iter =
+            mTags.find(toKey(tx.packet->frame.senderAddr, tx.transmissionId));
+        if (iter == mTags.end())
+        {
+            return false;
+        }
+
+        tag = iter->second;
+        mTags.erase(iter);
+        return true;
+    }
+
+    //! Forgets all tags, so that responses to their transmissions are ignored
+    inline void clear()
+    {
+        mTags.clear();
+    }
+
+    //! @returns the number of transmissions waiting on a response
+    inline uint32_t size() const
+    {
+        return mTags.size();
+    }
+
+private:
+    //! @returns the key into mTags for the given bus and transmission ID
+    //! (transmission IDs are only unique within a single scheduler)
+    static inline uint64_t toKey(uint8_t senderAddr, uint32_t transmissionId)
+    {
+        return (static_cast<uint64_t>(senderAddr) << 32) | transmissionId;
+    }
+
+private:
+    //! Maps bus and transmission ID to request tag
+    std::map<uint64_t, uint16_t> mTags;
+};
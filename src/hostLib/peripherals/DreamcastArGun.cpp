@@ -36,14 +36,14 @@ DreamcastArGun::~DreamcastArGun()
 void DreamcastArGun::task(uint64_t currentTimeUs)
 {}
 
-void DreamcastArGun::txStarted(std::shared_ptr<const Transmission> tx)
+void DreamcastArGun::txStarted(const std::shared_ptr<const Transmission>& tx)
 {}
 
 void DreamcastArGun::txFailed(bool writeFailed,
                               bool readFailed,
-                              std::shared_ptr<const Transmission> tx)
+                              const std::shared_ptr<const Transmission>& tx)
 {}
 
-void DreamcastArGun::txComplete(std::shared_ptr<const MaplePacket> packet,
-                                std::shared_ptr<const Transmission> tx)
+void DreamcastArGun::txComplete(const std::shared_ptr<const MaplePacket>& packet,
+                                const std::shared_ptr<const Transmission>& tx)
 {}
@@ -36,14 +36,14 @@ DreamcastCamera::~DreamcastCamera()
 void DreamcastCamera::task(uint64_t currentTimeUs)
 {}
 
-void DreamcastCamera::txStarted(std::shared_ptr<const Transmission> tx)
+void DreamcastCamera::txStarted(const std::shared_ptr<const Transmission>& tx)
 {}
 
 void DreamcastCamera::txFailed(bool writeFailed,
                                bool readFailed,
-                               std::shared_ptr<const Transmission> tx)
+                               const std::shared_ptr<const Transmission>& tx)
 {}
 
-void DreamcastCamera::txComplete(std::shared_ptr<const MaplePacket> packet,
-                                 std::shared_ptr<const Transmission> tx)
+void DreamcastCamera::txComplete(const std::shared_ptr<const MaplePacket>& packet,
+                                 const std::shared_ptr<const Transmission>& tx)
 {}
@@ -23,6 +23,7 @@
 
 #include "DreamcastController.hpp"
 #include "dreamcast_constants.h"
+#include "configuration.h"
 #include <string.h>
 
 
@@ -32,6 +33,16 @@ DreamcastController::DreamcastController(uint8_t addr,
                                          PlayerData playerData) :
     DreamcastPeripheral("controller", addr, fd, scheduler, playerData.playerIndex),
     mGamepad(playerData.gamepad),
+    mPollSettings(playerData.pollSettings),
+    mPeriodUs(0),
+    mConditionCount(0),
+    mMeasurementStartUs(0),
+    mAlignPeriodUs(0),
+    mFramePhaseUs(0),
+    mArrivalPhaseUs(0),
+    mAlignmentErrorCount(0),
+    mAlignmentErrorSumUs(0),
+    mAlignmentErrorMaxUs(0),
     mWaitingForData(false),
     mFirstTask(true),
     mConditionTxId(0)
@@ -41,10 +52,12 @@ DreamcastController::DreamcastController(uint8_t addr,
 
 DreamcastController::~DreamcastController()
 {
+    mPollSettings.setMeasuredControllerPeriodUs(0);
+    mPollSettings.setAlignmentErrorUs(0, 0);
     mGamepad.controllerDisconnected();
 }
 
-void DreamcastController::txStarted(std::shared_ptr<const Transmission> tx)
+void DreamcastController::txStarted(const std::shared_ptr<const Transmission>& tx)
 {
     if (mConditionTxId != 0 && tx->transmissionId == mConditionTxId)
     {
@@ -54,7 +67,7 @@ void DreamcastController::txStarted(std::shared_ptr<const Transmission> tx)
 
 void DreamcastController::txFailed(bool writeFailed,
                                    bool readFailed,
-                                   std::shared_ptr<const Transmission> tx)
+                                   const std::shared_ptr<const Transmission>& tx)
 {
     if (mConditionTxId != 0 && tx->transmissionId == mConditionTxId)
     {
@@ -62,8 +75,15 @@ void DreamcastController::txFailed(bool writeFailed,
     }
 }
 
-void DreamcastController::txComplete(std::shared_ptr<const MaplePacket> packet,
-                                     std::shared_ptr<const Transmission> tx)
+void DreamcastController::txComplete(const std::shared_ptr<const MaplePacket>& packet,
+                                     const std::shared_ptr<const Transmission>& tx)
+{
+    txCompleteAt(packet, tx, 0);
+}
+
+void DreamcastController::txCompleteAt(const std::shared_ptr<const MaplePacket>& packet,
+                                       const std::shared_ptr<const Transmission>& tx,
+                                       uint64_t receivedTimeUs)
 {
     if (mWaitingForData && packet != nullptr)
     {
@@ -76,18 +96,98 @@ void DreamcastController::txComplete(std::shared_ptr<const MaplePacket> packet,
             // Handle condition data
             DreamcastControllerObserver::ControllerCondition controllerCondition;
             memcpy(&controllerCondition, &packet->payload[1], 2 * sizeof(uint32_t));
-            mGamepad.setControllerCondition(controllerCondition);
+            mGamepad.setControllerCondition(controllerCondition, receivedTimeUs);
+            ++mConditionCount;
+
+            if (mAlignPeriodUs != 0 && receivedTimeUs != 0)
+            {
+                int32_t errorUs = PollSettings::phaseDeltaUs(
+                    receivedTimeUs % mAlignPeriodUs, mArrivalPhaseUs, mAlignPeriodUs);
+                uint32_t absErrorUs = (errorUs < 0) ? -errorUs : errorUs;
+                ++mAlignmentErrorCount;
+                mAlignmentErrorSumUs += errorUs;
+                if (absErrorUs > mAlignmentErrorMaxUs)
+                {
+                    mAlignmentErrorMaxUs = absErrorUs;
+                }
+            }
         }
     }
 }
 
 void DreamcastController::task(uint64_t currentTimeUs)
 {
-    if (mFirstTask)
+    uint32_t periodUs = mPollSettings.getEffectiveControllerPeriodUs();
+
+    // When aligned, each condition should be received just before the emulator reads its input or,
+    // without an emulator, just before the USB host's next IN poll
+    uint32_t alignPeriodUs = 0;
+    uint32_t targetPhaseUs = 0;
+    uint32_t emulatorPeriodUs = 0;
+    const UsbFrameTiming* frameTiming = mPollSettings.getFrameTiming();
+    if (mPollSettings.getEmulatorFrame(currentTimeUs, emulatorPeriodUs, targetPhaseUs))
+    {
+        // One poll per emulated frame
+        alignPeriodUs = emulatorPeriodUs;
+        periodUs = emulatorPeriodUs;
+    }
+    else if (mPollSettings.isFrameAligned()
+             && frameTiming != nullptr
+             && frameTiming->getPhaseUs(currentTimeUs, targetPhaseUs))
+    {
+        alignPeriodUs = UsbFrameTiming::FRAME_PERIOD_US;
+    }
+
+    uint32_t framePhaseUs = 0;
+    if (alignPeriodUs != 0)
+    {
+        uint32_t marginUs = USB_FRAME_ALIGNMENT_MARGIN_US % alignPeriodUs;
+        uint32_t leadUs = (PollSettings::getControllerPollDurationUs() + USB_FRAME_ALIGNMENT_MARGIN_US)
+                          % alignPeriodUs;
+        framePhaseUs = (targetPhaseUs + alignPeriodUs - leadUs) % alignPeriodUs;
+        // Errors are measured against the latest target, including drift not yet realigned
+        mArrivalPhaseUs = (targetPhaseUs + alignPeriodUs - marginUs) % alignPeriodUs;
+    }
+
+    bool periodChanged = (mFirstTask || periodUs != mPeriodUs);
+    bool realign = (alignPeriodUs != mAlignPeriodUs);
+    if (alignPeriodUs != 0 && !realign)
+    {
+        int32_t driftUs = PollSettings::phaseDeltaUs(framePhaseUs, mFramePhaseUs, alignPeriodUs);
+        realign = (driftUs > (int32_t)FRAME_ALIGNMENT_TOLERANCE_US
+                   || driftUs < -(int32_t)FRAME_ALIGNMENT_TOLERANCE_US);
+    }
+
+    if (periodChanged || realign)
     {
+        if (!mFirstTask)
+        {
+            mEndpointTxScheduler->cancelById(mConditionTxId);
+        }
         mFirstTask = false;
+        mAlignPeriodUs = alignPeriodUs;
+        mFramePhaseUs = framePhaseUs;
+
+        if (periodChanged)
+        {
+            mPeriodUs = periodUs;
+            mConditionCount = 0;
+            mAlignmentErrorCount = 0;
+            mAlignmentErrorSumUs = 0;
+            mAlignmentErrorMaxUs = 0;
+            mMeasurementStartUs = currentTimeUs;
+        }
+
+        // Unless aligning, condition is requested right away so the first report on this period
+        // isn't delayed
+        uint64_t txTime = PrioritizedTxScheduler::TX_TIME_ASAP;
+        if (mAlignPeriodUs != 0)
+        {
+            txTime = PrioritizedTxScheduler::computeNextTimeCadence(
+                currentTimeUs, mAlignPeriodUs, mFramePhaseUs);
+        }
+
         uint32_t payload[] = {DEVICE_FN_CONTROLLER};
-        uint64_t txTime = PrioritizedTxScheduler::computeNextTimeCadence(currentTimeUs, US_PER_CHECK);
         mConditionTxId = mEndpointTxScheduler->add(
             txTime,
             this,
@@ -95,7 +195,29 @@ void DreamcastController::task(uint64_t currentTimeUs)
             payload,
             1,
             true,
-            3,
-            US_PER_CHECK);
+            PollSettings::CONTROLLER_CONDITION_PAYLOAD_WORDS,
+            mPeriodUs);
+    }
+    else if (currentTimeUs - mMeasurementStartUs >= MEASUREMENT_WINDOW_US)
+    {
+        uint64_t elapsedUs = currentTimeUs - mMeasurementStartUs;
+        uint32_t measuredUs = 0;
+        if (mConditionCount > 0)
+        {
+            measuredUs = elapsedUs / mConditionCount;
+        }
+        mPollSettings.setMeasuredControllerPeriodUs(measuredUs);
+        mConditionCount = 0;
+
+        int32_t meanErrorUs = 0;
+        if (mAlignmentErrorCount > 0)
+        {
+            meanErrorUs = mAlignmentErrorSumUs / (int32_t)mAlignmentErrorCount;
+        }
+        mPollSettings.setAlignmentErrorUs(meanErrorUs, mAlignmentErrorMaxUs);
+        mAlignmentErrorCount = 0;
+        mAlignmentErrorSumUs = 0;
+        mAlignmentErrorMaxUs = 0;
+        mMeasurementStartUs = currentTimeUs;
     }
 }
@@ -48,16 +48,21 @@ class DreamcastController : public DreamcastPeripheral
         virtual void task(uint64_t currentTimeUs) final;
 
         //! Inherited from DreamcastPeripheral
-        virtual void txStarted(std::shared_ptr<const Transmission> tx) final;
+        virtual void txStarted(const std::shared_ptr<const Transmission>& tx) final;
 
         //! Inherited from DreamcastPeripheral
         virtual void txFailed(bool writeFailed,
                               bool readFailed,
-                              std::shared_ptr<const Transmission> tx) final;
+                              const std::shared_ptr<const Transmission>& tx) final;
 
         //! Inherited from DreamcastPeripheral
-        virtual void txComplete(std::shared_ptr<const MaplePacket> packet,
-                                std::shared_ptr<const Transmission> tx) final;
+        virtual void txComplete(const std::shared_ptr<const MaplePacket>& packet,
+                                const std::shared_ptr<const Transmission>& tx) final;
+
+        //! Inherited from DreamcastPeripheral
+        virtual void txCompleteAt(const std::shared_ptr<const MaplePacket>& packet,
+                                  const std::shared_ptr<const Transmission>& tx,
+                                  uint64_t receivedTimeUs) final;
 
         //! Inherited from DreamcastPeripheral
         inline uint32_t getFunctionCode() override final
@@ -69,11 +74,34 @@ class DreamcastController : public DreamcastPeripheral
         //! Function code for controller
         static const uint32_t FUNCTION_CODE = DEVICE_FN_CONTROLLER;
 
+        //! Duration over which the achieved poll period is averaged (in microseconds)
+        static const uint32_t MEASUREMENT_WINDOW_US = 1000000;
+        //! Polls are realigned once they drift this far from the target point in a frame
+        static const uint32_t FRAME_ALIGNMENT_TOLERANCE_US = 20;
+
     private:
-        //! Time between each controller state poll (in microseconds)
-        static const uint32_t US_PER_CHECK = 16000;
         //! The gamepad to write button presses to
         DreamcastControllerObserver& mGamepad;
+        //! Run-time poll settings for this player
+        PollSettings& mPollSettings;
+        //! The poll period which is currently scheduled (in microseconds)
+        uint32_t mPeriodUs;
+        //! Number of conditions received since mMeasurementStartUs
+        uint32_t mConditionCount;
+        //! Time at which the current measurement window started
+        uint64_t mMeasurementStartUs;
+        //! Period of the emulated or USB frames the scheduled polls are aligned to or 0 if not aligned
+        uint32_t mAlignPeriodUs;
+        //! Phase within a frame at which the scheduled polls are sent (when aligned)
+        uint32_t mFramePhaseUs;
+        //! Phase within a frame at which conditions should currently arrive (when aligned)
+        uint32_t mArrivalPhaseUs;
+        //! Number of alignment errors accumulated since mMeasurementStartUs
+        uint32_t mAlignmentErrorCount;
+        //! Sum of signed alignment errors accumulated since mMeasurementStartUs
+        int64_t mAlignmentErrorSumUs;
+        //! Largest absolute alignment error since mMeasurementStartUs
+        uint32_t mAlignmentErrorMaxUs;
         //! True iff the controller is waiting for data
         bool mWaitingForData;
         //! Initialized to true and set to false in task()
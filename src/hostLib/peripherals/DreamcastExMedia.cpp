@@ -36,14 +36,14 @@ DreamcastExMedia::~DreamcastExMedia()
 void DreamcastExMedia::task(uint64_t currentTimeUs)
 {}
 
-void DreamcastExMedia::txStarted(std::shared_ptr<const Transmission> tx)
+void DreamcastExMedia::txStarted(const std::shared_ptr<const Transmission>& tx)
 {}
 
 void DreamcastExMedia::txFailed(bool writeFailed,
                               bool readFailed,
-                              std::shared_ptr<const Transmission> tx)
+                              const std::shared_ptr<const Transmission>& tx)
 {}
 
-void DreamcastExMedia::txComplete(std::shared_ptr<const MaplePacket> packet,
-                                std::shared_ptr<const Transmission> tx)
+void DreamcastExMedia::txComplete(const std::shared_ptr<const MaplePacket>& packet,
+                                const std::shared_ptr<const Transmission>& tx)
 {}
@@ -48,16 +48,16 @@ class DreamcastExMedia : public DreamcastPeripheral
 
         //! Called when transmission has been sent
         //! @param[in] tx  The transmission that was sent
-        virtual void txStarted(std::shared_ptr<const Transmission> tx) final;
+        virtual void txStarted(const std::shared_ptr<const Transmission>& tx) final;
 
         //! Inherited from DreamcastPeripheral
         virtual void txFailed(bool writeFailed,
                               bool readFailed,
-                              std::shared_ptr<const Transmission> tx) final;
+                              const std::shared_ptr<const Transmission>& tx) final;
 
         //! Inherited from DreamcastPeripheral
-        virtual void txComplete(std::shared_ptr<const MaplePacket> packet,
-                                std::shared_ptr<const Transmission> tx) final;
+        virtual void txComplete(const std::shared_ptr<const MaplePacket>& packet,
+                                const std::shared_ptr<const Transmission>& tx) final;
 
         //! Inherited from DreamcastPeripheral
         inline uint32_t getFunctionCode() override final
@@ -36,14 +36,14 @@ DreamcastGun::~DreamcastGun()
 void DreamcastGun::task(uint64_t currentTimeUs)
 {}
 
-void DreamcastGun::txStarted(std::shared_ptr<const Transmission> tx)
+void DreamcastGun::txStarted(const std::shared_ptr<const Transmission>& tx)
 {}
 
 void DreamcastGun::txFailed(bool writeFailed,
                             bool readFailed,
-                            std::shared_ptr<const Transmission> tx)
+                            const std::shared_ptr<const Transmission>& tx)
 {}
 
-void DreamcastGun::txComplete(std::shared_ptr<const MaplePacket> packet,
-                              std::shared_ptr<const Transmission> tx)
+void DreamcastGun::txComplete(const std::shared_ptr<const MaplePacket>& packet,
+                              const std::shared_ptr<const Transmission>& tx)
 {}
@@ -36,14 +36,14 @@ DreamcastKeyboard::~DreamcastKeyboard()
 void DreamcastKeyboard::task(uint64_t currentTimeUs)
 {}
 
-void DreamcastKeyboard::txStarted(std::shared_ptr<const Transmission> tx)
+void DreamcastKeyboard::txStarted(const std::shared_ptr<const Transmission>& tx)
 {}
 
 void DreamcastKeyboard::txFailed(bool writeFailed,
                                  bool readFailed,
-                                 std::shared_ptr<const Transmission> tx)
+                                 const std::shared_ptr<const Transmission>& tx)
 {}
 
-void DreamcastKeyboard::txComplete(std::shared_ptr<const MaplePacket> packet,
-                                   std::shared_ptr<const Transmission> tx)
+void DreamcastKeyboard::txComplete(const std::shared_ptr<const MaplePacket>& packet,
+                                   const std::shared_ptr<const Transmission>& tx)
 {}
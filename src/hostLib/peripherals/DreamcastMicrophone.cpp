@@ -36,14 +36,14 @@ DreamcastMicrophone::~DreamcastMicrophone()
 void DreamcastMicrophone::task(uint64_t currentTimeUs)
 {}
 
-void DreamcastMicrophone::txStarted(std::shared_ptr<const Transmission> tx)
+void DreamcastMicrophone::txStarted(const std::shared_ptr<const Transmission>& tx)
 {}
 
 void DreamcastMicrophone::txFailed(bool writeFailed,
                                    bool readFailed,
-                                   std::shared_ptr<const Transmission> tx)
+                                   const std::shared_ptr<const Transmission>& tx)
 {}
 
-void DreamcastMicrophone::txComplete(std::shared_ptr<const MaplePacket> packet,
-                                     std::shared_ptr<const Transmission> tx)
+void DreamcastMicrophone::txComplete(const std::shared_ptr<const MaplePacket>& packet,
+                                     const std::shared_ptr<const Transmission>& tx)
 {}
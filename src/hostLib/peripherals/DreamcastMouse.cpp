@@ -36,14 +36,14 @@ DreamcastMouse::~DreamcastMouse()
 void DreamcastMouse::task(uint64_t currentTimeUs)
 {}
 
-void DreamcastMouse::txStarted(std::shared_ptr<const Transmission> tx)
+void DreamcastMouse::txStarted(const std::shared_ptr<const Transmission>& tx)
 {}
 
 void DreamcastMouse::txFailed(bool writeFailed,
                               bool readFailed,
-                              std::shared_ptr<const Transmission> tx)
+                              const std::shared_ptr<const Transmission>& tx)
 {}
 
-void DreamcastMouse::txComplete(std::shared_ptr<const MaplePacket> packet,
-                                std::shared_ptr<const Transmission> tx)
+void DreamcastMouse::txComplete(const std::shared_ptr<const MaplePacket>& packet,
+                                const std::shared_ptr<const Transmission>& tx)
 {}
@@ -101,6 +101,10 @@ class DreamcastPeripheral : public Transmitter
         //! @returns the function definition of this peripheral
         inline const uint32_t& getFunctionDefinition() { return mFd; }
 
+        //! @returns estimated bus time of the longest transaction this peripheral may schedule in
+        //!          microseconds (0 when negligible)
+        virtual uint32_t getLongestTransactionUs() { return 0; }
+
     public:
         //! The maximum number of sub peripherals that a main peripheral can handle
         static const uint32_t MAX_SUB_PERIPHERALS = 5;
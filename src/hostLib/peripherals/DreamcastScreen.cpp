@@ -39,8 +39,8 @@ DreamcastScreen::DreamcastScreen(uint8_t addr,
 DreamcastScreen::~DreamcastScreen()
 {}
 
-void DreamcastScreen::txComplete(std::shared_ptr<const MaplePacket> packet,
-                                 std::shared_ptr<const Transmission> tx)
+void DreamcastScreen::txComplete(const std::shared_ptr<const MaplePacket>& packet,
+                                 const std::shared_ptr<const Transmission>& tx)
 {
     if (mWaitingForData && packet != nullptr)
     {
@@ -87,7 +87,7 @@ void DreamcastScreen::task(uint64_t currentTimeUs)
     }
 }
 
-void DreamcastScreen::txStarted(std::shared_ptr<const Transmission> tx)
+void DreamcastScreen::txStarted(const std::shared_ptr<const Transmission>& tx)
 {
     if (mTransmissionId > 0 && mTransmissionId == tx->transmissionId)
     {
@@ -97,7 +97,7 @@ void DreamcastScreen::txStarted(std::shared_ptr<const Transmission> tx)
 
 void DreamcastScreen::txFailed(bool writeFailed,
                                bool readFailed,
-                               std::shared_ptr<const Transmission> tx)
+                               const std::shared_ptr<const Transmission>& tx)
 {
     if (mTransmissionId > 0 && mTransmissionId == tx->transmissionId)
     {
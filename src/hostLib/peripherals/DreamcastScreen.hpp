@@ -49,16 +49,16 @@ class DreamcastScreen : public DreamcastPeripheral
 
         //! Called when transmission has been sent
         //! @param[in] tx  The transmission that was sent
-        virtual void txStarted(std::shared_ptr<const Transmission> tx) final;
+        virtual void txStarted(const std::shared_ptr<const Transmission>& tx) final;
 
         //! Inherited from DreamcastPeripheral
         virtual void txFailed(bool writeFailed,
                               bool readFailed,
-                              std::shared_ptr<const Transmission> tx) final;
+                              const std::shared_ptr<const Transmission>& tx) final;
 
         //! Inherited from DreamcastPeripheral
-        virtual void txComplete(std::shared_ptr<const MaplePacket> packet,
-                                std::shared_ptr<const Transmission> tx) final;
+        virtual void txComplete(const std::shared_ptr<const MaplePacket>& packet,
+                                const std::shared_ptr<const Transmission>& tx) final;
 
         //! Inherited from DreamcastPeripheral
         inline uint32_t getFunctionCode() override final
@@ -66,6 +66,12 @@ class DreamcastScreen : public DreamcastPeripheral
             return FUNCTION_CODE;
         }
 
+        //! Inherited from DreamcastPeripheral (a full screen write is the longest transaction)
+        inline uint32_t getLongestTransactionUs() override final
+        {
+            return PrioritizedTxScheduler::computeTxDurationUs(ScreenData::NUM_SCREEN_WORDS + 2, true, 0);
+        }
+
     public:
         //! Function code for screen
         static const uint32_t FUNCTION_CODE = DEVICE_FN_LCD;
@@ -102,7 +102,7 @@ void DreamcastStorage::task(uint64_t currentTimeUs)
                 payload,
                 2,
                 true,
-                130);
+                BLOCK_READ_RESPONSE_PAYLOAD_WORDS);
             mReadState = READ_WRITE_SENT;
         }
         break;
@@ -159,7 +159,7 @@ void DreamcastStorage::task(uint64_t currentTimeUs)
     }
 }
 
-void DreamcastStorage::txStarted(std::shared_ptr<const Transmission> tx)
+void DreamcastStorage::txStarted(const std::shared_ptr<const Transmission>& tx)
 {
     if (mReadState != READ_WRITE_IDLE && tx->transmissionId == mReadingTxId)
     {
@@ -173,7 +173,7 @@ void DreamcastStorage::txStarted(std::shared_ptr<const Transmission> tx)
 
 void DreamcastStorage::txFailed(bool writeFailed,
                                 bool readFailed,
-                                std::shared_ptr<const Transmission> tx)
+                                const std::shared_ptr<const Transmission>& tx)
 {
     if (mReadState != READ_WRITE_IDLE && tx->transmissionId == mReadingTxId)
     {
@@ -199,8 +199,8 @@ void DreamcastStorage::txFailed(bool writeFailed,
     }
 }
 
-void DreamcastStorage::txComplete(std::shared_ptr<const MaplePacket> packet,
-                                  std::shared_ptr<const Transmission> tx)
+void DreamcastStorage::txComplete(const std::shared_ptr<const MaplePacket>& packet,
+                                  const std::shared_ptr<const Transmission>& tx)
 {
     if (mReadState != READ_WRITE_IDLE && tx->transmissionId == mReadingTxId)
     {
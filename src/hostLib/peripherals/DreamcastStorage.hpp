@@ -67,16 +67,16 @@ class DreamcastStorage : public DreamcastPeripheral, UsbFile
 
         //! Called when transmission has been sent
         //! @param[in] tx  The transmission that was sent
-        virtual void txStarted(std::shared_ptr<const Transmission> tx) final;
+        virtual void txStarted(const std::shared_ptr<const Transmission>& tx) final;
 
         //! Inherited from DreamcastPeripheral
         virtual void txFailed(bool writeFailed,
                               bool readFailed,
-                              std::shared_ptr<const Transmission> tx) final;
+                              const std::shared_ptr<const Transmission>& tx) final;
 
         //! Inherited from DreamcastPeripheral
-        virtual void txComplete(std::shared_ptr<const MaplePacket> packet,
-                                std::shared_ptr<const Transmission> tx) final;
+        virtual void txComplete(const std::shared_ptr<const MaplePacket>& packet,
+                                const std::shared_ptr<const Transmission>& tx) final;
 
         // The following are inherited from UsbFile
 
@@ -134,6 +134,12 @@ class DreamcastStorage : public DreamcastPeripheral, UsbFile
             return FUNCTION_CODE;
         }
 
+        //! Inherited from DreamcastPeripheral (a block read is the longest transaction)
+        inline uint32_t getLongestTransactionUs() override final
+        {
+            return PrioritizedTxScheduler::computeTxDurationUs(2, true, BLOCK_READ_RESPONSE_PAYLOAD_WORDS);
+        }
+
     private:
         //! Flips the endianness of a word
         //! @param[in] word  Input word
@@ -153,6 +159,8 @@ class DreamcastStorage : public DreamcastPeripheral, UsbFile
         static const uint32_t DEFAULT_MIN_DURATION_US_BETWEEN_WRITES = 10000;
         //! Amount of time to increment time between writes after failure
         static const uint32_t DURATION_US_BETWEEN_WRITES_INC = 5000;
+        //! Number of payload words in a block read response (function code, block, and 512 bytes)
+        static const uint32_t BLOCK_READ_RESPONSE_PAYLOAD_WORDS = 130;
 
     private:
         //! Initialized false and set to true when destructor called
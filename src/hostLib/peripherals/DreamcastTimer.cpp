@@ -54,16 +54,16 @@ DreamcastTimer::~DreamcastTimer()
 void DreamcastTimer::task(uint64_t currentTimeUs)
 {}
 
-void DreamcastTimer::txStarted(std::shared_ptr<const Transmission> tx)
+void DreamcastTimer::txStarted(const std::shared_ptr<const Transmission>& tx)
 {}
 
 void DreamcastTimer::txFailed(bool writeFailed,
                               bool readFailed,
-                              std::shared_ptr<const Transmission> tx)
+                              const std::shared_ptr<const Transmission>& tx)
 {}
 
-void DreamcastTimer::txComplete(std::shared_ptr<const MaplePacket> packet,
-                                std::shared_ptr<const Transmission> tx)
+void DreamcastTimer::txComplete(const std::shared_ptr<const MaplePacket>& packet,
+                                const std::shared_ptr<const Transmission>& tx)
 {
     if (tx->transmissionId == mButtonStatusId
         && packet->frame.command == COMMAND_RESPONSE_DATA_XFER
@@ -96,7 +96,7 @@ void DreamcastVibration::task(uint64_t currentTimeUs)
     }
 }
 
-void DreamcastVibration::txStarted(std::shared_ptr<const Transmission> tx)
+void DreamcastVibration::txStarted(const std::shared_ptr<const Transmission>& tx)
 {
     if (tx->transmissionId == mTransmissionId)
     {
@@ -106,12 +106,12 @@ void DreamcastVibration::txStarted(std::shared_ptr<const Transmission> tx)
 
 void DreamcastVibration::txFailed(bool writeFailed,
                                   bool readFailed,
-                                  std::shared_ptr<const Transmission> tx)
+                                  const std::shared_ptr<const Transmission>& tx)
 {
 }
 
-void DreamcastVibration::txComplete(std::shared_ptr<const MaplePacket> packet,
-                                    std::shared_ptr<const Transmission> tx)
+void DreamcastVibration::txComplete(const std::shared_ptr<const MaplePacket>& packet,
+                                    const std::shared_ptr<const Transmission>& tx)
 {
 }
 
@@ -0,0 +1,81 @@
+// MIT License
+//
+// Copyright (c) 2022-2025 James Smith of OrangeFox86
+// https://github.com/OrangeFox86/DreamcastControllerUsbPico
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "BackoffProbePolicy.hpp"
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+TEST(BackoffProbePolicy, fastProbesThenDoublesUpToCeiling)
+{
+    // --- MOCKING ---
+    BackoffProbePolicy policy(2000, 3, 16000, 100000);
+
+    // --- TEST EXECUTION ---
+    uint32_t intervals[9];
+    for (uint32_t i = 0; i < 9; ++i)
+    {
+        intervals[i] = policy.nextProbeIntervalUs();
+    }
+
+    // --- EXPECTATIONS ---
+    EXPECT_EQ(intervals[0], 2000U);
+    EXPECT_EQ(intervals[1], 2000U);
+    EXPECT_EQ(intervals[2], 2000U);
+    EXPECT_EQ(intervals[3], 16000U);
+    EXPECT_EQ(intervals[4], 32000U);
+    EXPECT_EQ(intervals[5], 64000U);
+    EXPECT_EQ(intervals[6], 100000U);
+    EXPECT_EQ(intervals[7], 100000U);
+    EXPECT_EQ(intervals[8], 100000U);
+}
+
+TEST(BackoffProbePolicy, resetStartsOver)
+{
+    // --- MOCKING ---
+    BackoffProbePolicy policy(2000, 1, 16000, 250000);
+    for (uint32_t i = 0; i < 10; ++i)
+    {
+        policy.nextProbeIntervalUs();
+    }
+
+    // --- TEST EXECUTION ---
+    policy.reset();
+
+    // --- EXPECTATIONS ---
+    EXPECT_EQ(policy.nextProbeIntervalUs(), 2000U);
+    EXPECT_EQ(policy.nextProbeIntervalUs(), 16000U);
+}
+
+TEST(BackoffProbePolicy, fixedInterval)
+{
+    // --- MOCKING ---
+    BackoffProbePolicy policy(16000, 0, 16000, 16000);
+
+    // --- TEST EXECUTION ---
+    // --- EXPECTATIONS ---
+    for (uint32_t i = 0; i < 5; ++i)
+    {
+        EXPECT_EQ(policy.nextProbeIntervalUs(), 16000U);
+    }
+}
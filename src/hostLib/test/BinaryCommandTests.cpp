@@ -0,0 +1,218 @@
+// MIT License
+//
+// Copyright (c) 2022-2025 James Smith of OrangeFox86
+// https://github.com/OrangeFox86/DreamcastControllerUsbPico
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "MockMutex.hpp"
+#include "MockBinaryOutput.hpp"
+#include "MockSystemIdentification.hpp"
+#include "MockClock.hpp"
+
+#include "FlycastCommandParser.hpp"
+#include "MaplePassthroughCommandParser.hpp"
+#include "MapleBinaryFrame.hpp"
+#include "PrioritizedTxScheduler.hpp"
+#include "hal/MapleBus/MaplePacket.hpp"
+
+#include <memory>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+using ::testing::NiceMock;
+using ::testing::ElementsAre;
+using ::testing::internal::CaptureStdout;
+using ::testing::internal::GetCapturedStdout;
+
+class BinaryCommandTest : public ::testing::Test
+{
+    public:
+        BinaryCommandTest() :
+            mSchedulers{
+                std::make_shared<PrioritizedTxScheduler>(mMutex, 0x00),
+                std::make_shared<PrioritizedTxScheduler>(mMutex, 0x40)},
+            mFlycast(mIdentification, mClock, mSchedulers, SENDER_ADDRESSES, 2, {}, {}, nullptr),
+            mPassthrough(mSchedulers, SENDER_ADDRESSES, 2)
+        {}
+
+    protected:
+        //! Encodes maple words as binary frame data
+        static std::vector<uint8_t> encode(const std::vector<uint32_t>& words)
+        {
+            std::vector<uint8_t> bytes;
+            for (uint32_t word : words)
+            {
+                MapleBinaryFrame::appendU32(bytes, word);
+            }
+            return bytes;
+        }
+
+        //! Pops the next transmission from the given scheduler
+        std::shared_ptr<Transmission> popNext(uint32_t idx)
+        {
+            PrioritizedTxScheduler::ScheduleItem item = mSchedulers[idx]->peekNext(0);
+            return mSchedulers[idx]->popItem(item);
+        }
+
+        static const uint8_t SENDER_ADDRESSES[2];
+        NiceMock<MockMutex> mMutex;
+        NiceMock<MockSystemIdentification> mIdentification;
+        NiceMock<MockClock> mClock;
+        std::shared_ptr<PrioritizedTxScheduler> mSchedulers[2];
+        FlycastCommandParser mFlycast;
+        MaplePassthroughCommandParser mPassthrough;
+        MockBinaryOutput mOutput;
+};
+
+const uint8_t BinaryCommandTest::SENDER_ADDRESSES[2] = {0x00, 0x40};
+
+TEST_F(BinaryCommandTest, flycastPacketRoundTrip)
+{
+    // --- MOCKING ---
+    std::vector<uint8_t> data = encode({0x09414001, 0x00000001});
+    uint32_t payload[1] = {0xA1B2C3D4};
+    std::shared_ptr<const MaplePacket> response =
+        std::make_shared<MaplePacket>(MaplePacket::Frame::fromWord(0x08004100), payload, 1);
+
+    // --- TEST EXECUTION ---
+    bool handled = mFlycast.submitBinary('X', data.data(), data.size(), mOutput);
+    std::shared_ptr<Transmission> tx = popNext(1);
+    ASSERT_NE(tx, nullptr);
+    tx->transmitter->txComplete(response, tx);
+
+    // --- EXPECTATIONS ---
+    EXPECT_TRUE(handled);
+    EXPECT_EQ(tx->packet->getFrameWord(), 0x09414001U);
+    EXPECT_THAT(tx->packet->payload, ElementsAre(0x00000001));
+    ASSERT_EQ(mOutput.mFrames.size(), 1U);
+    EXPECT_EQ(mOutput.mFrames[0].first, 'X');
+    EXPECT_THAT(
+        mOutput.mFrames[0].second,
+        ElementsAre(
+            MapleBinaryFrame::STATUS_COMPLETE,
+            0x01, 0x41, 0x00, 0x08,
+            0xD4, 0xC3, 0xB2, 0xA1));
+}
+
+TEST_F(BinaryCommandTest, flycastFailures)
+{
+    // --- MOCKING ---
+    std::vector<uint8_t> partialWord = encode({0x01200000});
+    partialWord.pop_back();
+    std::vector<uint8_t> invalidSender = encode({0x01208000});
+    std::vector<uint8_t> valid = encode({0x01200000});
+
+    // --- TEST EXECUTION ---
+    mFlycast.submitBinary('X', partialWord.data(), partialWord.size(), mOutput);
+    mFlycast.submitBinary('X', invalidSender.data(), invalidSender.size(), mOutput);
+    mFlycast.submitBinary('X', valid.data(), valid.size(), mOutput);
+    std::shared_ptr<Transmission> tx = popNext(0);
+    ASSERT_NE(tx, nullptr);
+    tx->transmitter->txFailed(false, true, tx);
+
+    // --- EXPECTATIONS ---
+    ASSERT_EQ(mOutput.mFrames.size(), 3U);
+    EXPECT_THAT(mOutput.mFrames[0].second, ElementsAre(MapleBinaryFrame::STATUS_MALFORMED));
+    EXPECT_THAT(mOutput.mFrames[1].second, ElementsAre(MapleBinaryFrame::STATUS_INVALID_SENDER));
+    EXPECT_THAT(mOutput.mFrames[2].second, ElementsAre(MapleBinaryFrame::STATUS_READ_FAILED));
+}
+
+TEST_F(BinaryCommandTest, flycastTimestampsAppendedWhenEnabled)
+{
+    // --- MOCKING ---
+    std::vector<uint8_t> data = encode({0x09200000});
+    std::shared_ptr<const MaplePacket> response =
+        std::make_shared<MaplePacket>(MaplePacket::Frame::fromWord(0x08002000));
+    CaptureStdout();
+    mFlycast.submit("XK 1", 4);
+    GetCapturedStdout();
+
+    // --- TEST EXECUTION ---
+    mFlycast.submitBinary('X', data.data(), data.size(), mOutput);
+    std::shared_ptr<Transmission> tx = popNext(0);
+    ASSERT_NE(tx, nullptr);
+    tx->transmitter->txCompleteAt(response, tx, 0x0102030405060708ULL);
+    CaptureStdout();
+    mFlycast.submit("XK 0", 4);
+    GetCapturedStdout();
+    mFlycast.submitBinary('X', data.data(), data.size(), mOutput);
+    tx = popNext(0);
+    ASSERT_NE(tx, nullptr);
+    tx->transmitter->txCompleteAt(response, tx, 0x0102030405060708ULL);
+
+    // --- EXPECTATIONS ---
+    ASSERT_EQ(mOutput.mFrames.size(), 2U);
+    EXPECT_THAT(
+        mOutput.mFrames[0].second,
+        ElementsAre(
+            MapleBinaryFrame::STATUS_COMPLETE,
+            0x00, 0x20, 0x00, 0x08,
+            0x08, 0x07, 0x06, 0x05, 0x04, 0x03, 0x02, 0x01));
+    EXPECT_THAT(
+        mOutput.mFrames[1].second,
+        ElementsAre(MapleBinaryFrame::STATUS_COMPLETE, 0x00, 0x20, 0x00, 0x08));
+}
+
+TEST_F(BinaryCommandTest, passthroughReportsTransmissionId)
+{
+    // --- MOCKING ---
+    std::vector<uint8_t> data = encode({0x01204000});
+    std::shared_ptr<const MaplePacket> response =
+        std::make_shared<MaplePacket>(MaplePacket::Frame::fromWord(0x05004000));
+
+    // --- TEST EXECUTION ---
+    bool handled = mPassthrough.submitBinary('0', data.data(), data.size(), mOutput);
+    std::shared_ptr<Transmission> tx = popNext(1);
+    ASSERT_NE(tx, nullptr);
+    tx->transmitter->txComplete(response, tx);
+
+    // --- EXPECTATIONS ---
+    EXPECT_TRUE(handled);
+    uint8_t id = tx->transmissionId;
+    ASSERT_EQ(mOutput.mFrames.size(), 2U);
+    EXPECT_EQ(mOutput.mFrames[0].first, '0');
+    EXPECT_THAT(mOutput.mFrames[0].second, ElementsAre(MapleBinaryFrame::STATUS_SCHEDULED, id, 0, 0, 0));
+    EXPECT_EQ(mOutput.mFrames[1].first, '0');
+    EXPECT_THAT(
+        mOutput.mFrames[1].second,
+        ElementsAre(MapleBinaryFrame::STATUS_COMPLETE, id, 0, 0, 0, 0x00, 0x40, 0x00, 0x05));
+}
+
+TEST_F(BinaryCommandTest, textFrameOnlyPacketsTakeTheirPayloadLength)
+{
+    // --- TEST EXECUTION ---
+    // Both frame words claim 2 payload words which aren't there
+    CaptureStdout();
+    mFlycast.submit("X 01200002", 10);
+    mPassthrough.submit("01604002", 8);
+    GetCapturedStdout();
+    std::shared_ptr<Transmission> flycastTx = popNext(0);
+    std::shared_ptr<Transmission> passthroughTx = popNext(1);
+
+    // --- EXPECTATIONS ---
+    ASSERT_NE(flycastTx, nullptr);
+    ASSERT_NE(passthroughTx, nullptr);
+    EXPECT_EQ(flycastTx->packet->getFrameWord(), 0x01200000U);
+    EXPECT_TRUE(flycastTx->packet->payload.empty());
+    EXPECT_EQ(passthroughTx->packet->getFrameWord(), 0x01604000U);
+    EXPECT_TRUE(passthroughTx->packet->payload.empty());
+}
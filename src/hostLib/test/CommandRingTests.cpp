@@ -0,0 +1,209 @@
+// MIT License
+//
+// Copyright (c) 2022-2025 James Smith of OrangeFox86
+// https://github.com/OrangeFox86/DreamcastControllerUsbPico
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "CommandRing.hpp"
+
+#include <string>
+#include <thread>
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+// Local copies so that they may be passed by reference to the test macros
+static const uint32_t QUEUE_SIZE = CommandRing::MAX_QUEUE_SIZE;
+static const uint32_t MAX_ITEMS = CommandRing::MAX_ITEMS;
+
+class CommandRingTest : public ::testing::Test
+{
+    public:
+        CommandRingTest() : mRing() {}
+
+    protected:
+        //! Adds and commits a NULL terminated text command
+        void addText(const std::string& text)
+        {
+            uint32_t start = mRing.getTail();
+            mRing.push(text.c_str(), text.size() + 1);
+            mRing.commit(start, text.size(), false);
+        }
+
+        //! Processes the next command, returning it as a string
+        std::string take()
+        {
+            CommandRing::Item item;
+            const char* chars = nullptr;
+            if (!mRing.peek(item, chars))
+            {
+                return std::string("<none>");
+            }
+            std::string s(chars, item.len);
+            if (!item.isFrame)
+            {
+                // Terminator must be handed over too
+                EXPECT_EQ(chars[item.len], '\0');
+            }
+            mRing.release();
+            return s;
+        }
+
+        CommandRing mRing;
+};
+
+TEST_F(CommandRingTest, commandsHandedOverInOrder)
+{
+    // --- TEST EXECUTION ---
+    addText("abc");
+    uint32_t start = mRing.getTail();
+    mRing.push('#');
+    mRing.push("\x01\x02", 2);
+    mRing.commit(start, 3, true);
+
+    // --- EXPECTATIONS ---
+    EXPECT_EQ(take(), "abc");
+    EXPECT_EQ(take(), std::string("#\x01\x02"));
+    EXPECT_EQ(take(), "<none>");
+    EXPECT_EQ(mRing.getUsedSpace(), 0U);
+}
+
+TEST_F(CommandRingTest, uncommittedCharactersAreNotHandedOver)
+{
+    // --- MOCKING ---
+    addText("abc");
+    uint32_t tail = mRing.getTail();
+    mRing.push("partial", 7);
+
+    // --- TEST EXECUTION ---
+    mRing.setTail(tail);
+
+    // --- EXPECTATIONS ---
+    EXPECT_EQ(take(), "abc");
+    EXPECT_EQ(take(), "<none>");
+    EXPECT_EQ(mRing.getFreeSpace(), QUEUE_SIZE);
+}
+
+TEST_F(CommandRingTest, wrapAroundIsHandedOverInOnePiece)
+{
+    // --- MOCKING ---
+    // Leave 4 characters before the end of the ring buffer
+    std::string filler(QUEUE_SIZE - 5, 'x');
+    addText(filler);
+    EXPECT_EQ(take(), filler);
+
+    // --- TEST EXECUTION ---
+    addText("0123456789");
+
+    // --- EXPECTATIONS ---
+    EXPECT_EQ(mRing.at(QUEUE_SIZE - 4), '0');
+    EXPECT_EQ(mRing.at(QUEUE_SIZE), '4');
+    EXPECT_EQ(take(), "0123456789");
+    EXPECT_EQ(mRing.getUsedSpace(), 0U);
+}
+
+TEST_F(CommandRingTest, byteOverflow)
+{
+    // --- MOCKING ---
+    std::string first(1000, 'a');
+    std::string second(QUEUE_SIZE - first.size() - 2, 'b');
+
+    // --- TEST EXECUTION ---
+    addText(first);
+    addText(second);
+
+    // --- EXPECTATIONS ---
+    EXPECT_EQ(mRing.getUsedSpace(), QUEUE_SIZE);
+    EXPECT_EQ(mRing.getFreeSpace(), 0U);
+    // Only released characters become free again
+    EXPECT_EQ(take(), first);
+    EXPECT_EQ(mRing.getFreeSpace(), first.size() + 1);
+    EXPECT_EQ(take(), second);
+    EXPECT_EQ(mRing.getFreeSpace(), QUEUE_SIZE);
+}
+
+TEST_F(CommandRingTest, itemIndexFull)
+{
+    // --- TEST EXECUTION ---
+    for (uint32_t i = 0; i < MAX_ITEMS; ++i)
+    {
+        ASSERT_TRUE(mRing.isItemSpaceAvailable());
+        addText(std::to_string(i));
+    }
+
+    // --- EXPECTATIONS ---
+    EXPECT_FALSE(mRing.isItemSpaceAvailable());
+    // Plenty of characters left, but the index is what limits
+    EXPECT_GT(mRing.getFreeSpace(), QUEUE_SIZE / 2);
+    EXPECT_EQ(take(), "0");
+    EXPECT_TRUE(mRing.isItemSpaceAvailable());
+    addText("64");
+    EXPECT_FALSE(mRing.isItemSpaceAvailable());
+    for (uint32_t i = 1; i <= MAX_ITEMS; ++i)
+    {
+        EXPECT_EQ(take(), std::to_string(i));
+    }
+    EXPECT_EQ(take(), "<none>");
+}
+
+TEST_F(CommandRingTest, producerConsumerHandoff)
+{
+    // --- MOCKING ---
+    const uint32_t numCommands = 20000;
+
+    // --- TEST EXECUTION ---
+    std::thread producer([this, numCommands]()
+    {
+        for (uint32_t i = 0; i < numCommands; ++i)
+        {
+            // Varying lengths so that commands land on every part of the ring buffer
+            std::string text = std::to_string(i) + std::string(i % 97, 'z');
+            while (mRing.getFreeSpace() < text.size() + 1 || !mRing.isItemSpaceAvailable())
+            {
+                std::this_thread::yield();
+            }
+            addText(text);
+        }
+    });
+
+    uint32_t numTaken = 0;
+    while (numTaken < numCommands)
+    {
+        CommandRing::Item item;
+        const char* chars = nullptr;
+        if (mRing.peek(item, chars))
+        {
+            std::string expected = std::to_string(numTaken) + std::string(numTaken % 97, 'z');
+            ASSERT_EQ(std::string(chars, item.len), expected);
+            mRing.release();
+            ++numTaken;
+        }
+        else
+        {
+            std::this_thread::yield();
+        }
+    }
+
+    producer.join();
+
+    // --- EXPECTATIONS ---
+    EXPECT_EQ(numTaken, numCommands);
+    EXPECT_EQ(mRing.getUsedSpace(), 0U);
+}
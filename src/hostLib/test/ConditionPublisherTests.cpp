@@ -0,0 +1,243 @@
+// MIT License
+//
+// Copyright (c) 2022-2025 James Smith of OrangeFox86
+// https://github.com/OrangeFox86/DreamcastControllerUsbPico
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "ConditionPublisher.hpp"
+#include "FlycastCommandParser.hpp"
+#include "PlayerData.hpp"
+#include "ScreenData.hpp"
+#include "PollSettings.hpp"
+#include "MockDreamcastControllerObserver.hpp"
+#include "MockClock.hpp"
+#include "MockUsbFileSystem.hpp"
+#include "MockSystemIdentification.hpp"
+#include "MockBinaryOutput.hpp"
+
+#include <string.h>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+using ::testing::_;
+using ::testing::NiceMock;
+using ::testing::internal::CaptureStdout;
+using ::testing::internal::GetCapturedStdout;
+
+class ConditionPublisherTest : public ::testing::Test
+{
+    public:
+        ConditionPublisherTest() : mPublisher(2, mObserver) {}
+
+    protected:
+        //! @returns a condition made from the 2 given condition words
+        static DreamcastControllerObserver::ControllerCondition condition(uint32_t word1, uint32_t word2)
+        {
+            uint32_t words[2] = {word1, word2};
+            DreamcastControllerObserver::ControllerCondition c;
+            memcpy(&c, words, sizeof(c));
+            return c;
+        }
+
+        NiceMock<MockDreamcastControllerObserver> mObserver;
+        ConditionPublisher mPublisher;
+};
+
+TEST_F(ConditionPublisherTest, passesEverythingThrough)
+{
+    // --- MOCKING ---
+    EXPECT_CALL(mObserver, controllerConnected()).Times(1);
+    EXPECT_CALL(mObserver, setControllerCondition(_, 1234)).Times(1);
+    EXPECT_CALL(mObserver, controllerDisconnected()).Times(1);
+
+    // --- TEST EXECUTION ---
+    CaptureStdout();
+    mPublisher.controllerConnected();
+    mPublisher.setControllerCondition(condition(0xFFFF0000, 0x80808080), 1234);
+    mPublisher.controllerDisconnected();
+    std::string output = GetCapturedStdout();
+
+    // --- EXPECTATIONS ---
+    EXPECT_EQ(output, "");
+}
+
+TEST_F(ConditionPublisherTest, writesOnlyChanges)
+{
+    // --- MOCKING ---
+    mPublisher.controllerConnected();
+
+    // --- TEST EXECUTION ---
+    CaptureStdout();
+    mPublisher.setSubscribed(true);
+    mPublisher.setControllerCondition(condition(0xFFFF0000, 0x80808080), 0);
+    mPublisher.setControllerCondition(condition(0xFFFF0000, 0x80808080), 0);
+    mPublisher.setControllerCondition(condition(0xFFFB0000, 0x80808080), 0);
+    mPublisher.setControllerCondition(condition(0xFFFB0000, 0x80808080), 0);
+    mPublisher.setSubscribed(false);
+    mPublisher.setControllerCondition(condition(0xFFFF0000, 0x80808080), 0);
+    std::string output = GetCapturedStdout();
+
+    // --- EXPECTATIONS ---
+    EXPECT_EQ(output, "$2 FFFF0000 80808080\n$2 FFFB0000 80808080\n");
+}
+
+TEST_F(ConditionPublisherTest, resubscribeWritesCurrentCondition)
+{
+    // --- MOCKING ---
+    mPublisher.controllerConnected();
+    mPublisher.setSubscribed(true);
+    mPublisher.setControllerCondition(condition(0xFFFF0000, 0x80808080), 0);
+
+    // --- TEST EXECUTION ---
+    CaptureStdout();
+    mPublisher.setSubscribed(true);
+    mPublisher.setControllerCondition(condition(0xFFFF0000, 0x80808080), 0);
+    std::string output = GetCapturedStdout();
+
+    // --- EXPECTATIONS ---
+    EXPECT_EQ(output, "$2 FFFF0000 80808080\n");
+}
+
+TEST_F(ConditionPublisherTest, disconnectRecords)
+{
+    // --- TEST EXECUTION ---
+    CaptureStdout();
+    mPublisher.setSubscribed(true);
+    mPublisher.controllerConnected();
+    mPublisher.setControllerCondition(condition(0xFFFF0000, 0x80808080), 0);
+    mPublisher.controllerDisconnected();
+    mPublisher.controllerConnected();
+    mPublisher.setControllerCondition(condition(0xFFFF0000, 0x80808080), 0);
+    std::string output = GetCapturedStdout();
+
+    // --- EXPECTATIONS ---
+    EXPECT_EQ(output,
+              "$2 -\n"
+              "$2 FFFF0000 80808080\n"
+              "$2 -\n"
+              "$2 FFFF0000 80808080\n");
+}
+
+TEST_F(ConditionPublisherTest, binaryModeWritesFrames)
+{
+    // --- MOCKING ---
+    MockBinaryOutput binaryOutput;
+
+    // --- TEST EXECUTION ---
+    CaptureStdout();
+    mPublisher.setBinaryOutput(&binaryOutput);
+    mPublisher.setSubscribed(true);
+    mPublisher.controllerConnected();
+    mPublisher.setControllerCondition(condition(0xFFFF0000, 0x80808081), 0);
+    mPublisher.controllerDisconnected();
+    mPublisher.setBinaryOutput(nullptr);
+    mPublisher.controllerConnected();
+    mPublisher.setControllerCondition(condition(0xFFFF0000, 0x80808081), 0);
+    std::string output = GetCapturedStdout();
+
+    // --- EXPECTATIONS ---
+    // Nothing leaks into the binary stream as text
+    EXPECT_EQ(output, "$2 FFFF0000 80808081\n");
+    ASSERT_EQ(binaryOutput.mFrames.size(), 3U);
+    EXPECT_EQ(binaryOutput.mFrames[0].first, '$');
+    EXPECT_EQ(binaryOutput.mFrames[0].second, std::vector<uint8_t>({2}));
+    EXPECT_EQ(binaryOutput.mFrames[1].first, '$');
+    EXPECT_EQ(binaryOutput.mFrames[1].second,
+              std::vector<uint8_t>({2, 0x00, 0x00, 0xFF, 0xFF, 0x81, 0x80, 0x80, 0x80}));
+    EXPECT_EQ(binaryOutput.mFrames[2].first, '$');
+    EXPECT_EQ(binaryOutput.mFrames[2].second, std::vector<uint8_t>({2}));
+}
+
+TEST(ConditionSubscribeCommandTest, subscribeThroughFlycastCommand)
+{
+    // --- MOCKING ---
+    NiceMock<MockDreamcastControllerObserver> observer;
+    ConditionPublisher publisher(0, observer);
+    ScreenData screenData;
+    NiceMock<MockClock> clock;
+    NiceMock<MockUsbFileSystem> fileSystem;
+    PollSettings pollSettings;
+    PlayerData playerData(0, publisher, screenData, clock, fileSystem, pollSettings, &publisher);
+    NiceMock<MockSystemIdentification> identification;
+    FlycastCommandParser flycast(
+        identification,
+        clock,
+        nullptr,
+        nullptr,
+        0,
+        {std::shared_ptr<PlayerData>(std::shared_ptr<PlayerData>(), &playerData)},
+        {},
+        nullptr);
+    publisher.controllerConnected();
+
+    // --- TEST EXECUTION ---
+    CaptureStdout();
+    flycast.submit("XN 0", 4);
+    flycast.submit("XN 0 1", 6);
+    flycast.submit("XN 0", 4);
+    flycast.submit("XN 1 1", 6);
+    std::string output = GetCapturedStdout();
+
+    // --- EXPECTATIONS ---
+    EXPECT_EQ(output, "0\n1\n1\n0\n");
+    EXPECT_TRUE(publisher.isSubscribed());
+}
+
+TEST(ConditionSubscribeCommandTest, sessionResetDropsSubscriptions)
+{
+    // --- MOCKING ---
+    NiceMock<MockDreamcastControllerObserver> observer;
+    ConditionPublisher publisher(0, observer);
+    ScreenData screenData;
+    NiceMock<MockClock> clock;
+    NiceMock<MockUsbFileSystem> fileSystem;
+    PollSettings pollSettings;
+    PlayerData playerData(0, publisher, screenData, clock, fileSystem, pollSettings, &publisher);
+    NiceMock<MockSystemIdentification> identification;
+    FlycastCommandParser flycast(
+        identification,
+        clock,
+        nullptr,
+        nullptr,
+        0,
+        {std::shared_ptr<PlayerData>(std::shared_ptr<PlayerData>(), &playerData)},
+        {},
+        nullptr);
+    MockBinaryOutput binaryOutput;
+    publisher.controllerConnected();
+    CaptureStdout();
+    flycast.setBinaryOutput(&binaryOutput);
+    flycast.submit("XN 0 1", 6);
+
+    // --- TEST EXECUTION ---
+    flycast.sessionReset();
+    publisher.setControllerCondition(DreamcastControllerObserver::ControllerCondition(), 0);
+    std::string output = GetCapturedStdout();
+
+    // --- EXPECTATIONS ---
+    // Only the response to the subscribe command is written
+    EXPECT_EQ(output, "1\n");
+    EXPECT_TRUE(binaryOutput.mFrames.empty());
+    EXPECT_FALSE(publisher.isSubscribed());
+}
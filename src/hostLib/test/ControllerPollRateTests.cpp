@@ -0,0 +1,670 @@
+// MIT License
+//
+// Copyright (c) 2022-2025 James Smith of OrangeFox86
+// https://github.com/OrangeFox86/DreamcastControllerUsbPico
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "DreamcastMainNode.hpp"
+#include "PrioritizedTxScheduler.hpp"
+#include "ScreenData.hpp"
+#include "PlayerData.hpp"
+#include "PollSettings.hpp"
+#include "DreamcastStorage.hpp"
+#include "dreamcast_constants.h"
+#include "configuration.h"
+#include "hal/Usb/UsbFrameTiming.hpp"
+
+#include "MockUsbFileSystem.hpp"
+#include "SimulatedMapleDevices.hpp"
+
+#include <memory>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+using ::testing::NiceMock;
+
+TEST(PollSettingsTest, defaultsToSixtyHertz)
+{
+    // --- TEST EXECUTION ---
+    PollSettings pollSettings;
+
+    // --- EXPECTATIONS ---
+    EXPECT_EQ(pollSettings.getRequestedControllerPeriodUs(), 16000U);
+    EXPECT_EQ(pollSettings.getEffectiveControllerPeriodUs(), 16000U);
+    EXPECT_EQ(pollSettings.getMinControllerPeriodUs(), (uint32_t)PollSettings::MIN_CONTROLLER_PERIOD_US);
+    EXPECT_EQ(pollSettings.getMeasuredControllerPeriodUs(), 0U);
+}
+
+TEST(PollSettingsTest, refusesPeriodsOutOfRange)
+{
+    // --- MOCKING ---
+    PollSettings pollSettings;
+
+    // --- TEST EXECUTION & EXPECTATIONS ---
+    EXPECT_FALSE(pollSettings.requestControllerPeriodUs(PollSettings::MIN_CONTROLLER_PERIOD_US - 1));
+    EXPECT_FALSE(pollSettings.requestControllerPeriodUs(PollSettings::MAX_CONTROLLER_PERIOD_US + 1));
+    EXPECT_EQ(pollSettings.getRequestedControllerPeriodUs(), 16000U);
+    EXPECT_TRUE(pollSettings.requestControllerPeriodUs(PollSettings::MIN_CONTROLLER_PERIOD_US));
+    EXPECT_EQ(pollSettings.getRequestedControllerPeriodUs(), (uint32_t)PollSettings::MIN_CONTROLLER_PERIOD_US);
+}
+
+TEST(PollSettingsTest, refusesPeriodsWhichStarveOtherTraffic)
+{
+    // --- MOCKING ---
+    PollSettings pollSettings;
+    uint32_t reservedUs = PrioritizedTxScheduler::computeTxDurationUs(
+        2, true, DreamcastStorage::BLOCK_READ_RESPONSE_PAYLOAD_WORDS);
+
+    // --- TEST EXECUTION ---
+    pollSettings.setReservedBusTimeUs(reservedUs);
+
+    // --- EXPECTATIONS ---
+    uint32_t minPeriodUs = PollSettings::getControllerPollDurationUs() + reservedUs;
+    EXPECT_EQ(pollSettings.getMinControllerPeriodUs(), minPeriodUs);
+    EXPECT_FALSE(pollSettings.requestControllerPeriodUs(minPeriodUs - 1));
+    EXPECT_TRUE(pollSettings.requestControllerPeriodUs(minPeriodUs));
+}
+
+TEST(PollSettingsTest, effectivePeriodStretchedWhileTrafficReserved)
+{
+    // --- MOCKING ---
+    PollSettings pollSettings;
+    ASSERT_TRUE(pollSettings.requestControllerPeriodUs(PollSettings::MIN_CONTROLLER_PERIOD_US));
+
+    // --- TEST EXECUTION & EXPECTATIONS ---
+    pollSettings.setReservedBusTimeUs(5000);
+    EXPECT_EQ(pollSettings.getEffectiveControllerPeriodUs(), pollSettings.getMinControllerPeriodUs());
+    EXPECT_GT(pollSettings.getEffectiveControllerPeriodUs(), 5000U);
+    // Requested period is restored once the reservation is removed
+    pollSettings.setReservedBusTimeUs(0);
+    EXPECT_EQ(pollSettings.getEffectiveControllerPeriodUs(), (uint32_t)PollSettings::MIN_CONTROLLER_PERIOD_US);
+}
+
+TEST(PollSettingsTest, frameAlignmentRequiresFrameTiming)
+{
+    // --- MOCKING ---
+    PollSettings pollSettings;
+
+    // --- TEST EXECUTION & EXPECTATIONS ---
+    EXPECT_FALSE(pollSettings.setFrameAligned(true));
+    EXPECT_FALSE(pollSettings.isFrameAligned());
+    EXPECT_TRUE(pollSettings.setFrameAligned(false));
+}
+
+TEST(PollSettingsTest, frameAlignedPeriodIsWholeFrames)
+{
+    // --- MOCKING ---
+    UsbFrameTiming frameTiming;
+    PollSettings pollSettings(&frameTiming);
+    ASSERT_TRUE(pollSettings.requestControllerPeriodUs(2500));
+
+    // --- TEST EXECUTION ---
+    EXPECT_TRUE(pollSettings.setFrameAligned(true));
+
+    // --- EXPECTATIONS ---
+    EXPECT_EQ(pollSettings.getRequestedControllerPeriodUs(), 2500U);
+    EXPECT_EQ(pollSettings.getEffectiveControllerPeriodUs(), 3000U);
+}
+
+TEST(PollSettingsTest, emulatorFrameStoredAsReadPhase)
+{
+    // --- MOCKING ---
+    PollSettings pollSettings;
+    uint32_t periodUs = 0;
+    uint32_t readPhaseUs = 0;
+
+    // --- TEST EXECUTION & EXPECTATIONS ---
+    EXPECT_FALSE(pollSettings.getEmulatorFrame(1000000, periodUs, readPhaseUs));
+    EXPECT_FALSE(pollSettings.setEmulatorFrame(PollSettings::MIN_CONTROLLER_PERIOD_US - 1, 0, 1000000));
+    EXPECT_FALSE(pollSettings.setEmulatorFrame(PollSettings::MAX_CONTROLLER_PERIOD_US + 1, 0, 1000000));
+    EXPECT_TRUE(pollSettings.setEmulatorFrame(16683, 1005000, 1000000));
+    EXPECT_TRUE(pollSettings.getEmulatorFrame(1000000, periodUs, readPhaseUs));
+    EXPECT_EQ(periodUs, 16683U);
+    EXPECT_EQ(readPhaseUs, 1005000U % 16683U);
+    pollSettings.clearEmulatorFrame();
+    EXPECT_FALSE(pollSettings.getEmulatorFrame(1000000, periodUs, readPhaseUs));
+}
+
+TEST(PollSettingsTest, emulatorFrameGoesStale)
+{
+    // --- MOCKING ---
+    PollSettings pollSettings;
+    uint32_t periodUs = 0;
+    uint32_t readPhaseUs = 0;
+    ASSERT_TRUE(pollSettings.setEmulatorFrame(16683, 0, 1000000));
+
+    // --- TEST EXECUTION & EXPECTATIONS ---
+    EXPECT_TRUE(pollSettings.getEmulatorFrame(
+        1000000 + PollSettings::EMULATOR_FRAME_STALE_US, periodUs, readPhaseUs));
+    EXPECT_FALSE(pollSettings.getEmulatorFrame(
+        1000001 + PollSettings::EMULATOR_FRAME_STALE_US, periodUs, readPhaseUs));
+    // Stays cleared even once the 32-bit report time wraps around
+    EXPECT_FALSE(pollSettings.getEmulatorFrame(1000000 + 0x100000000ULL, periodUs, readPhaseUs));
+}
+
+TEST(PollSettingsTest, phaseDeltaWrapsAroundPeriod)
+{
+    // --- TEST EXECUTION & EXPECTATIONS ---
+    EXPECT_EQ(PollSettings::phaseDeltaUs(100, 16600, 16683), 183);
+    EXPECT_EQ(PollSettings::phaseDeltaUs(16600, 100, 16683), -183);
+    EXPECT_EQ(PollSettings::phaseDeltaUs(5000, 4000, 16683), 1000);
+}
+
+TEST(UsbFrameTimingTest, takesEarliestObservation)
+{
+    // --- MOCKING ---
+    UsbFrameTiming frameTiming;
+    uint32_t phaseUs = 0;
+    EXPECT_FALSE(frameTiming.getPhaseUs(0, phaseUs));
+
+    // --- TEST EXECUTION ---
+    // Frames begin at 250 us into each millisecond, but are observed with up to 60 us of latency
+    static const uint32_t LATENCY_US[] = {40, 60, 5, 30, 20, 55, 10, 45};
+    uint64_t timeUs = 10000000;
+    for (uint32_t i = 0; i < 100; ++i, timeUs += 1000)
+    {
+        frameTiming.startOfFrame(timeUs + 250 + LATENCY_US[i % (sizeof(LATENCY_US) / sizeof(LATENCY_US[0]))]);
+    }
+
+    // --- EXPECTATIONS ---
+    EXPECT_TRUE(frameTiming.getPhaseUs(timeUs, phaseUs));
+    EXPECT_GE(phaseUs, 255U);
+    EXPECT_LE(phaseUs, 255U + 8U);
+    // Stale once frames stop (ex: suspended)
+    EXPECT_FALSE(frameTiming.getPhaseUs(timeUs + UsbFrameTiming::STALE_US + 1000, phaseUs));
+}
+
+TEST(UsbFrameTimingTest, followsDriftAcrossFrameBoundary)
+{
+    // --- MOCKING ---
+    UsbFrameTiming frameTiming;
+
+    // --- TEST EXECUTION ---
+    // Host frames are 0.5 us longer than a local millisecond, so the phase slowly moves later
+    uint64_t frameTimeNs = 5000990000ULL;
+    for (uint32_t i = 0; i < 10000; ++i, frameTimeNs += 1000500)
+    {
+        frameTiming.startOfFrame(frameTimeNs / 1000);
+    }
+
+    // --- EXPECTATIONS ---
+    uint32_t phaseUs = 0;
+    uint64_t lastFrameUs = (frameTimeNs - 1000500) / 1000;
+    EXPECT_TRUE(frameTiming.getPhaseUs(lastFrameUs, phaseUs));
+    int32_t errorUs = UsbFrameTiming::phaseDelta(phaseUs, lastFrameUs % UsbFrameTiming::FRAME_PERIOD_US);
+    EXPECT_GE(errorUs, -2);
+    EXPECT_LE(errorUs, 2);
+}
+
+//! Records the time at which each controller condition is received
+class ConditionTimeRecorder : public NullControllerObserver
+{
+    public:
+        ConditionTimeRecorder(const SimulatedClock& clock) :
+            mClock(clock),
+            mConditionTimesUs(),
+            mReceivedTimesUs()
+        {}
+
+        void setControllerCondition(const ControllerCondition& controllerCondition,
+                                    uint64_t receivedTimeUs) override
+        {
+            mConditionTimesUs.push_back(mClock.getTimeUs());
+            mReceivedTimesUs.push_back(receivedTimeUs);
+        }
+
+        const SimulatedClock& mClock;
+        std::vector<uint64_t> mConditionTimesUs;
+        std::vector<uint64_t> mReceivedTimesUs;
+};
+
+class ControllerPollRateTest : public ::testing::Test
+{
+    public:
+        //! Simulated time between each call to task() (roughly one bus transaction)
+        static const uint32_t US_PER_TASK = 100;
+
+        ControllerPollRateTest() :
+            mGamepad(mClock),
+            mScreenData(),
+            mFrameTiming(),
+            mPollSettings(&mFrameTiming),
+            mPlayerData(0, mGamepad, mScreenData, mClock, mUsbFileSystem, mPollSettings),
+            mScheduler(std::make_shared<PrioritizedTxScheduler>(mMutex, 0x00)),
+            mDreamcastMainNode(mBus, mPlayerData, mScheduler)
+        {}
+
+    protected:
+        StdMutex mMutex;
+        SimulatedClock mClock;
+        ConditionTimeRecorder mGamepad;
+        NiceMock<MockUsbFileSystem> mUsbFileSystem;
+        ScreenData mScreenData;
+        UsbFrameTiming mFrameTiming;
+        PollSettings mPollSettings;
+        PlayerData mPlayerData;
+        SimulatedControllerWithVmu mBus;
+        std::shared_ptr<PrioritizedTxScheduler> mScheduler;
+        DreamcastMainNode mDreamcastMainNode;
+        //! USB host frame period in nanoseconds or 0 when USB frames aren't simulated
+        uint64_t mHostFramePeriodNs = 0;
+        //! Time of next USB host start of frame in nanoseconds
+        uint64_t mNextFrameNs = 0;
+
+        virtual void SetUp()
+        {
+            mClock.advance(100000);
+        }
+
+        //! Starts simulating USB start of frame
+        //! @param[in] phaseUs  Time of the next start of frame modulo 1 ms
+        //! @param[in] framePeriodNs  Host frame period in nanoseconds
+        void startFrames(uint32_t phaseUs, uint64_t framePeriodNs = 1000000)
+        {
+            mHostFramePeriodNs = framePeriodNs;
+            mNextFrameNs = ((mClock.getTimeUs() / 1000 + 1) * 1000 + phaseUs) * 1000;
+        }
+
+        //! Checks that every condition received after startUs landed within the target window just
+        //! before a start of frame
+        //! @param[in] startUs  Conditions received before this time are ignored
+        //! @param[in] frameDelayUs  Simulated delay of start of frame observation plus estimate error
+        //! @returns number of conditions checked
+        uint32_t expectConditionsBeforeFrames(uint64_t startUs, uint32_t frameDelayUs)
+        {
+            // Simulated responses arrive in the task following the write (faster than estimated), and
+            // a late observation of start of frame makes conditions land later
+            const int32_t maxLeadUs = PollSettings::getControllerPollDurationUs()
+                                      + USB_FRAME_ALIGNMENT_MARGIN_US
+                                      + DreamcastController::FRAME_ALIGNMENT_TOLERANCE_US;
+            const int32_t minLeadUs = (int32_t)USB_FRAME_ALIGNMENT_MARGIN_US
+                                      - (int32_t)frameDelayUs
+                                      - (int32_t)DreamcastController::FRAME_ALIGNMENT_TOLERANCE_US;
+            uint32_t count = 0;
+            for (uint64_t timeUs : mGamepad.mConditionTimesUs)
+            {
+                if (timeUs >= startUs)
+                {
+                    // Time until the frame this condition was meant for
+                    uint64_t frameNs = mNextFrameNs;
+                    while (frameNs >= mHostFramePeriodNs && frameNs - mHostFramePeriodNs >= timeUs * 1000)
+                    {
+                        frameNs -= mHostFramePeriodNs;
+                    }
+                    int32_t leadUs = (int32_t)(frameNs / 1000 - timeUs);
+                    EXPECT_GE(leadUs, minLeadUs) << "condition at " << timeUs;
+                    EXPECT_LE(leadUs, maxLeadUs) << "condition at " << timeUs;
+                    ++count;
+                }
+            }
+            return count;
+        }
+
+        //! Reports the emulator's frame cadence the way the emulator would, as an offset from now
+        //! @param[in] firstReadNs  Time of any one emulated input read in nanoseconds
+        //! @param[in] framePeriodNs  Emulated frame period in nanoseconds
+        //! @returns the result of PollSettings::setEmulatorFrame()
+        bool reportEmulatorFrame(uint64_t firstReadNs, uint64_t framePeriodNs)
+        {
+            uint64_t nowNs = mClock.getTimeUs() * 1000;
+            uint64_t nextReadNs = firstReadNs;
+            while (nextReadNs < nowNs)
+            {
+                nextReadNs += framePeriodNs;
+            }
+            uint32_t offsetUs = (nextReadNs - nowNs) / 1000;
+            return mPollSettings.setEmulatorFrame(
+                framePeriodNs / 1000, mClock.getTimeUs() + offsetUs, mClock.getTimeUs());
+        }
+
+        //! Runs while the emulator reports its cadence every reportPeriodUs
+        void runEmulator(uint64_t durationUs,
+                         uint64_t firstReadNs,
+                         uint64_t framePeriodNs,
+                         uint64_t reportPeriodUs)
+        {
+            for (uint64_t t = 0; t < durationUs; t += reportPeriodUs)
+            {
+                EXPECT_TRUE(reportEmulatorFrame(firstReadNs, framePeriodNs));
+                run(reportPeriodUs);
+            }
+        }
+
+        //! Checks that every condition received after startUs landed within the target window just
+        //! before an emulated input read
+        //! @returns number of conditions checked
+        uint32_t expectConditionsBeforeReads(uint64_t startUs,
+                                             uint64_t firstReadNs,
+                                             uint64_t framePeriodNs,
+                                             uint32_t driftUs)
+        {
+            const int32_t maxLeadUs = PollSettings::getControllerPollDurationUs()
+                                      + USB_FRAME_ALIGNMENT_MARGIN_US
+                                      + DreamcastController::FRAME_ALIGNMENT_TOLERANCE_US
+                                      + driftUs;
+            const int32_t minLeadUs = (int32_t)USB_FRAME_ALIGNMENT_MARGIN_US
+                                      - (int32_t)DreamcastController::FRAME_ALIGNMENT_TOLERANCE_US
+                                      - (int32_t)driftUs;
+            uint32_t count = 0;
+            for (uint64_t timeUs : mGamepad.mConditionTimesUs)
+            {
+                if (timeUs >= startUs)
+                {
+                    // Time until the emulated read this condition was meant for
+                    uint64_t readNs = firstReadNs
+                        + ((timeUs * 1000 - firstReadNs) / framePeriodNs + 1) * framePeriodNs;
+                    int32_t leadUs = (int32_t)(readNs / 1000 - timeUs);
+                    EXPECT_GE(leadUs, minLeadUs) << "condition at " << timeUs;
+                    EXPECT_LE(leadUs, maxLeadUs) << "condition at " << timeUs;
+                    ++count;
+                }
+            }
+            return count;
+        }
+
+        virtual void TearDown()
+        {}
+
+        //! Runs task() for the given amount of simulated time
+        void run(uint64_t durationUs)
+        {
+            for (uint64_t t = 0; t < durationUs; t += US_PER_TASK)
+            {
+                mClock.advance(US_PER_TASK);
+                if (mHostFramePeriodNs > 0 && mNextFrameNs <= mClock.getTimeUs() * 1000)
+                {
+                    // Observed on the first task at or after the start of frame
+                    mFrameTiming.startOfFrame(mClock.getTimeUs());
+                    mNextFrameNs += mHostFramePeriodNs;
+                }
+                mDreamcastMainNode.task(mClock.getTimeUs());
+            }
+        }
+
+        //! Measures the poll rate over one measurement window after settling
+        //! @param[out] numConditionRequests  Number of condition requests sent over the window
+        //! @returns the measured average poll period
+        uint32_t measure(uint32_t& numConditionRequests)
+        {
+            // Settle then let a full measurement window pass
+            run(DreamcastController::MEASUREMENT_WINDOW_US + 100000);
+            uint32_t startCount = mBus.getCommandCount(COMMAND_GET_CONDITION);
+            run(DreamcastController::MEASUREMENT_WINDOW_US);
+            numConditionRequests = mBus.getCommandCount(COMMAND_GET_CONDITION) - startCount;
+            return mPollSettings.getMeasuredControllerPeriodUs();
+        }
+};
+
+TEST_F(ControllerPollRateTest, defaultPeriodAchieved)
+{
+    // --- MOCKING ---
+    mBus.setVmuAttached(false);
+
+    // --- TEST EXECUTION ---
+    uint32_t numConditionRequests = 0;
+    uint32_t measuredUs = measure(numConditionRequests);
+
+    // --- EXPECTATIONS ---
+    printf("[ POLL     ] default: %lu us (%lu polls/s)\n",
+           (long unsigned int)measuredUs, (long unsigned int)numConditionRequests);
+    EXPECT_NEAR(measuredUs, 16000, 500);
+    EXPECT_NEAR(numConditionRequests, 62, 2);
+}
+
+TEST_F(ControllerPollRateTest, conditionsCarryMapleReadCompleteTime)
+{
+    // --- MOCKING ---
+    mBus.setVmuAttached(false);
+
+    // --- TEST EXECUTION ---
+    run(100000);
+
+    // --- EXPECTATIONS ---
+    ASSERT_FALSE(mGamepad.mReceivedTimesUs.empty());
+    ASSERT_EQ(mGamepad.mReceivedTimesUs.size(), mGamepad.mConditionTimesUs.size());
+    for (uint32_t i = 0; i < mGamepad.mReceivedTimesUs.size(); ++i)
+    {
+        EXPECT_EQ(mGamepad.mReceivedTimesUs[i],
+                  mGamepad.mConditionTimesUs[i] - SimulatedControllerWithVmu::READ_COMPLETE_LAG_US);
+    }
+}
+
+TEST_F(ControllerPollRateTest, oneKilohertzAchievedWithoutVmu)
+{
+    // --- MOCKING ---
+    mBus.setVmuAttached(false);
+    run(100000);
+
+    // --- TEST EXECUTION ---
+    EXPECT_TRUE(mPollSettings.requestControllerPeriodUs(1000));
+    uint32_t numConditionRequests = 0;
+    uint32_t measuredUs = measure(numConditionRequests);
+
+    // --- EXPECTATIONS ---
+    printf("[ POLL     ] 1 kHz requested: %lu us (%lu polls/s)\n",
+           (long unsigned int)measuredUs, (long unsigned int)numConditionRequests);
+    EXPECT_NEAR(measuredUs, 1000, 50);
+    EXPECT_NEAR(numConditionRequests, 1000, 20);
+}
+
+TEST_F(ControllerPollRateTest, fastPeriodRefusedWithVmu)
+{
+    // --- MOCKING ---
+    run(100000);
+
+    // --- TEST EXECUTION & EXPECTATIONS ---
+    // A VMU block read couldn't fit between polls
+    EXPECT_FALSE(mPollSettings.requestControllerPeriodUs(1000));
+    EXPECT_GT(mPollSettings.getMinControllerPeriodUs(),
+              PrioritizedTxScheduler::computeTxDurationUs(2, true, DreamcastStorage::BLOCK_READ_RESPONSE_PAYLOAD_WORDS));
+    EXPECT_TRUE(mPollSettings.requestControllerPeriodUs(mPollSettings.getMinControllerPeriodUs()));
+    uint32_t numConditionRequests = 0;
+    uint32_t measuredUs = measure(numConditionRequests);
+    printf("[ POLL     ] fastest with VMU: %lu us (%lu polls/s)\n",
+           (long unsigned int)measuredUs, (long unsigned int)numConditionRequests);
+    EXPECT_NEAR(measuredUs, mPollSettings.getMinControllerPeriodUs(), 500);
+}
+
+TEST_F(ControllerPollRateTest, vmuInsertedAfterFastPeriodIsNotStarved)
+{
+    // --- MOCKING ---
+    mBus.setVmuAttached(false);
+    run(100000);
+    ASSERT_TRUE(mPollSettings.requestControllerPeriodUs(1000));
+    run(100000);
+
+    // --- TEST EXECUTION ---
+    mBus.setVmuAttached(true);
+    uint32_t numConditionRequests = 0;
+    uint32_t measuredUs = measure(numConditionRequests);
+
+    // --- EXPECTATIONS ---
+    // Requested period is kept, but polling is stretched while the VMU is inserted
+    EXPECT_EQ(mPollSettings.getRequestedControllerPeriodUs(), 1000U);
+    EXPECT_GT(mPollSettings.getEffectiveControllerPeriodUs(), 1000U);
+    EXPECT_EQ(mPollSettings.getEffectiveControllerPeriodUs(), mPollSettings.getMinControllerPeriodUs());
+    EXPECT_NEAR(measuredUs, mPollSettings.getMinControllerPeriodUs(), 500);
+    // The VMU screen got its initial write through
+    EXPECT_GT(mBus.getCommandCount(COMMAND_BLOCK_WRITE), 0U);
+
+    // --- TEST EXECUTION ---
+    mBus.setVmuAttached(false);
+    measuredUs = measure(numConditionRequests);
+
+    // --- EXPECTATIONS ---
+    EXPECT_NEAR(measuredUs, 1000, 50);
+}
+
+TEST_F(ControllerPollRateTest, frameAlignedConditionsLandBeforeStartOfFrame)
+{
+    // --- MOCKING ---
+    mBus.setVmuAttached(false);
+    startFrames(300);
+    run(100000);
+    ASSERT_TRUE(mPollSettings.requestControllerPeriodUs(4000));
+
+    // --- TEST EXECUTION ---
+    EXPECT_TRUE(mPollSettings.setFrameAligned(true));
+    run(10000);
+    uint64_t startUs = mClock.getTimeUs();
+    run(1000000);
+
+    // --- EXPECTATIONS ---
+    uint32_t count = expectConditionsBeforeFrames(startUs, 0);
+    EXPECT_NEAR(count, 250, 2);
+
+    // --- TEST EXECUTION ---
+    // Host restarts frames at a different phase (ex: after reset)
+    startFrames(800);
+    run(10000);
+    startUs = mClock.getTimeUs();
+    run(1000000);
+
+    // --- EXPECTATIONS ---
+    count = expectConditionsBeforeFrames(startUs, 0);
+    EXPECT_NEAR(count, 250, 2);
+}
+
+TEST_F(ControllerPollRateTest, frameAlignedPollsFollowHostClockDrift)
+{
+    // --- MOCKING ---
+    mBus.setVmuAttached(false);
+    // Host frames 200 ppm longer than local time - the frame phase moves 200 us per second
+    startFrames(500, 1000200);
+    run(100000);
+    ASSERT_TRUE(mPollSettings.requestControllerPeriodUs(1000));
+
+    // --- TEST EXECUTION ---
+    EXPECT_TRUE(mPollSettings.setFrameAligned(true));
+    run(10000);
+    uint64_t startUs = mClock.getTimeUs();
+    run(5000000);
+
+    // --- EXPECTATIONS ---
+    // Start of frame is observed up to one task late
+    uint32_t count = expectConditionsBeforeFrames(startUs, US_PER_TASK);
+    EXPECT_GT(count, 4900U);
+}
+
+TEST_F(ControllerPollRateTest, frameAlignmentFallsBackWhenFramesStop)
+{
+    // --- MOCKING ---
+    mBus.setVmuAttached(false);
+    startFrames(300);
+    run(100000);
+    EXPECT_TRUE(mPollSettings.setFrameAligned(true));
+    run(100000);
+
+    // --- TEST EXECUTION ---
+    // USB suspended
+    mHostFramePeriodNs = 0;
+    uint32_t numConditionRequests = 0;
+    uint32_t measuredUs = measure(numConditionRequests);
+
+    // --- EXPECTATIONS ---
+    EXPECT_NEAR(measuredUs, 16000, 500);
+}
+
+TEST_F(ControllerPollRateTest, emulatorAlignedConditionsLandBeforeInputReads)
+{
+    // --- MOCKING ---
+    mBus.setVmuAttached(false);
+    run(100000);
+    // 60 Hz emulated frames with input read 5.3 ms into each
+    const uint64_t framePeriodNs = 16683000;
+    const uint64_t firstReadNs = mClock.getTimeUs() * 1000 + 5300000;
+
+    // --- TEST EXECUTION ---
+    runEmulator(100000, firstReadNs, framePeriodNs, 50000);
+    uint64_t startUs = mClock.getTimeUs();
+    runEmulator(DreamcastController::MEASUREMENT_WINDOW_US, firstReadNs, framePeriodNs, 500000);
+
+    // --- EXPECTATIONS ---
+    uint32_t count = expectConditionsBeforeReads(startUs, firstReadNs, framePeriodNs, 0);
+    EXPECT_NEAR(count, 60, 1);
+    EXPECT_NEAR(mPollSettings.getMeasuredControllerPeriodUs(), 16683, 300);
+    // Simulated responses arrive sooner than estimated, but never after the target
+    EXPECT_LE(mPollSettings.getMeanAlignmentErrorUs(), 0);
+    EXPECT_GT(mPollSettings.getMaxAlignmentErrorUs(), 0U);
+    EXPECT_LE(mPollSettings.getMaxAlignmentErrorUs(), PollSettings::getControllerPollDurationUs());
+}
+
+TEST_F(ControllerPollRateTest, emulatorAlignedPollsFollowEmulatorClockDrift)
+{
+    // --- MOCKING ---
+    mBus.setVmuAttached(false);
+    run(100000);
+    // 59.94 Hz emulated frames - not a whole number of local microseconds
+    const uint64_t framePeriodNs = 16683350;
+    const uint64_t firstReadNs = mClock.getTimeUs() * 1000 + 1000000;
+
+    // --- TEST EXECUTION ---
+    runEmulator(100000, firstReadNs, framePeriodNs, 50000);
+    uint64_t startUs = mClock.getTimeUs();
+    runEmulator(5000000, firstReadNs, framePeriodNs, 100000);
+
+    // --- EXPECTATIONS ---
+    // Phase moves up to 2 us per frame between reports
+    uint32_t count = expectConditionsBeforeReads(startUs, firstReadNs, framePeriodNs, 15);
+    EXPECT_NEAR(count, 300, 1);
+}
+
+TEST_F(ControllerPollRateTest, emulatorAlignmentTakesPrecedenceOverFrameAlignment)
+{
+    // --- MOCKING ---
+    mBus.setVmuAttached(false);
+    startFrames(300);
+    run(100000);
+    ASSERT_TRUE(mPollSettings.requestControllerPeriodUs(1000));
+    EXPECT_TRUE(mPollSettings.setFrameAligned(true));
+    const uint64_t framePeriodNs = 16683000;
+    const uint64_t firstReadNs = mClock.getTimeUs() * 1000 + 2450000;
+
+    // --- TEST EXECUTION ---
+    runEmulator(100000, firstReadNs, framePeriodNs, 50000);
+    uint64_t startUs = mClock.getTimeUs();
+    runEmulator(1000000, firstReadNs, framePeriodNs, 500000);
+
+    // --- EXPECTATIONS ---
+    uint32_t count = expectConditionsBeforeReads(startUs, firstReadNs, framePeriodNs, 0);
+    EXPECT_NEAR(count, 60, 1);
+}
+
+TEST_F(ControllerPollRateTest, emulatorAlignmentFallsBackWhenReportsStop)
+{
+    // --- MOCKING ---
+    mBus.setVmuAttached(false);
+    run(100000);
+    runEmulator(100000, mClock.getTimeUs() * 1000, 16683000, 50000);
+
+    // --- TEST EXECUTION ---
+    // Emulator closed without clearing alignment
+    run(PollSettings::EMULATOR_FRAME_STALE_US);
+    ASSERT_TRUE(mPollSettings.requestControllerPeriodUs(4000));
+    uint32_t numConditionRequests = 0;
+    uint32_t measuredUs = measure(numConditionRequests);
+
+    // --- EXPECTATIONS ---
+    EXPECT_NEAR(measuredUs, 4000, 100);
+    EXPECT_EQ(mPollSettings.getMeanAlignmentErrorUs(), 0);
+    EXPECT_EQ(mPollSettings.getMaxAlignmentErrorUs(), 0U);
+}
@@ -0,0 +1,102 @@
+// MIT License
+//
+// Copyright (c) 2022-2025 James Smith of OrangeFox86
+// https://github.com/OrangeFox86/DreamcastControllerUsbPico
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "DeferredLog.hpp"
+
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+class DeferredLogTest : public ::testing::Test
+{
+    public:
+        DeferredLogTest() : mLog(mBuffer, NUM_WORDS) {}
+
+    protected:
+        static const uint32_t NUM_WORDS = 16;
+        uint32_t mBuffer[NUM_WORDS];
+        DeferredLog mLog;
+};
+
+TEST_F(DeferredLogTest, readSerializesRecords)
+{
+    // --- TEST EXECUTION ---
+    const char* fmt1 = "P%lu connected\n";
+    const char* fmt2 = "done\n";
+    EXPECT_TRUE(mLog.print(fmt1, 0x04030201));
+    EXPECT_TRUE(mLog.print(fmt2));
+    uint8_t out[64];
+    uint32_t len = mLog.read(out, sizeof(out));
+
+    // --- EXPECTATIONS ---
+    uint32_t fmt1Addr = static_cast<uint32_t>(reinterpret_cast<uintptr_t>(fmt1));
+    uint32_t fmt2Addr = static_cast<uint32_t>(reinterpret_cast<uintptr_t>(fmt2));
+    std::vector<uint8_t> expected = {
+        DeferredLog::SYNC_BYTE, 1,
+        (uint8_t)fmt1Addr, (uint8_t)(fmt1Addr >> 8), (uint8_t)(fmt1Addr >> 16), (uint8_t)(fmt1Addr >> 24),
+        0x01, 0x02, 0x03, 0x04,
+        DeferredLog::SYNC_BYTE, 0,
+        (uint8_t)fmt2Addr, (uint8_t)(fmt2Addr >> 8), (uint8_t)(fmt2Addr >> 16), (uint8_t)(fmt2Addr >> 24)
+    };
+    EXPECT_EQ(std::vector<uint8_t>(out, out + len), expected);
+    EXPECT_TRUE(mLog.isEmpty());
+}
+
+TEST_F(DeferredLogTest, readOnlyWholeRecords)
+{
+    // --- TEST EXECUTION ---
+    EXPECT_TRUE(mLog.print("%lu %lu", 1, 2));
+    EXPECT_TRUE(mLog.print("%lu", 3));
+    uint8_t out[64];
+    uint32_t len1 = mLog.read(out, DeferredLog::recordSize(2) + 1);
+    uint32_t len2 = mLog.read(out, sizeof(out));
+
+    // --- EXPECTATIONS ---
+    EXPECT_EQ(len1, DeferredLog::recordSize(2));
+    EXPECT_EQ(len2, DeferredLog::recordSize(1));
+    EXPECT_TRUE(mLog.isEmpty());
+}
+
+TEST_F(DeferredLogTest, overflowReportsDroppedCount)
+{
+    // --- TEST EXECUTION ---
+    // Each of these records consumes 8 of the 16 words
+    EXPECT_TRUE(mLog.print("%lu%lu%lu%lu%lu%lu", 1, 2, 3, 4, 5, 6));
+    EXPECT_TRUE(mLog.print("%lu%lu%lu%lu%lu%lu", 1, 2, 3, 4, 5, 6));
+    EXPECT_FALSE(mLog.print("x"));
+    EXPECT_FALSE(mLog.print("y"));
+    uint8_t out[128];
+    uint32_t len = mLog.read(out, sizeof(out));
+
+    // --- EXPECTATIONS ---
+    ASSERT_EQ(len, DeferredLog::recordSize(1) + 2 * DeferredLog::recordSize(6));
+    // Dropped record report comes first
+    EXPECT_EQ(out[0], (uint8_t)DeferredLog::SYNC_BYTE);
+    EXPECT_EQ(out[1], 1);
+    EXPECT_EQ(out[2] | out[3] | out[4] | out[5], 0);
+    EXPECT_EQ(out[6], 2);
+    EXPECT_TRUE(mLog.isEmpty());
+    // Space is available again after read
+    EXPECT_TRUE(mLog.print("z"));
+}
@@ -0,0 +1,270 @@
+// MIT License
+//
+// Copyright (c) 2022-2025 James Smith of OrangeFox86
+// https://github.com/OrangeFox86/DreamcastControllerUsbPico
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "DreamcastMainNode.hpp"
+#include "PrioritizedTxScheduler.hpp"
+#include "ScreenData.hpp"
+#include "PlayerData.hpp"
+#include "dreamcast_constants.h"
+#include "BackoffProbePolicy.hpp"
+#include "configuration.h"
+
+#include "MockUsbFileSystem.hpp"
+#include "SimulatedMapleDevices.hpp"
+
+#include <memory>
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+using ::testing::_;
+using ::testing::NiceMock;
+using ::testing::Mock;
+using ::testing::SaveArg;
+
+class EnumerationTest : public ::testing::Test
+{
+    public:
+        //! Simulated time between each call to task() (roughly one bus transaction)
+        static const uint32_t US_PER_TASK = 100;
+
+        EnumerationTest() :
+            mScreenData(),
+            mPlayerData(0, mGamepad, mScreenData, mClock, mUsbFileSystem, mPollSettings),
+            mScheduler(std::make_shared<PrioritizedTxScheduler>(mMutex, 0x00)),
+            mDreamcastMainNode(mBus, mPlayerData, mScheduler)
+        {}
+
+    protected:
+        StdMutex mMutex;
+        SimulatedClock mClock;
+        NullControllerObserver mGamepad;
+        NiceMock<MockUsbFileSystem> mUsbFileSystem;
+        ScreenData mScreenData;
+        PollSettings mPollSettings;
+        PlayerData mPlayerData;
+        SimulatedControllerWithVmu mBus;
+        std::shared_ptr<PrioritizedTxScheduler> mScheduler;
+        DreamcastMainNode mDreamcastMainNode;
+
+        virtual void SetUp()
+        {
+            // Boot happens some time after power up
+            mClock.advance(100000);
+        }
+
+        virtual void TearDown()
+        {}
+
+        //! Runs task() until the node reports ready or the timeout elapses
+        //! @returns time to ready or 0 on timeout
+        uint64_t runUntilReady(uint64_t timeoutUs)
+        {
+            for (uint64_t t = 0; t < timeoutUs && mDreamcastMainNode.getTimeToReadyUs() == 0; t += US_PER_TASK)
+            {
+                run(US_PER_TASK);
+            }
+            return mDreamcastMainNode.getTimeToReadyUs();
+        }
+
+        //! Runs task() for the given amount of simulated time
+        void run(uint64_t durationUs)
+        {
+            for (uint64_t t = 0; t < durationUs; t += US_PER_TASK)
+            {
+                mClock.advance(US_PER_TASK);
+                mDreamcastMainNode.task(mClock.getTimeUs());
+            }
+        }
+};
+
+TEST_F(EnumerationTest, bootWithVmuReadyWithinOneCheckPeriod)
+{
+    // --- MOCKING ---
+    EXPECT_CALL(mUsbFileSystem, add(_)).Times(1);
+
+    // --- TEST EXECUTION ---
+    uint64_t timeToReadyUs = runUntilReady(100000);
+
+    // --- EXPECTATIONS ---
+    printf("[ ENUM     ] boot to ready: %lu us\n", (long unsigned int)timeToReadyUs);
+    // Controller and VMU identified in a single burst rather than on consecutive check periods
+    EXPECT_GT(timeToReadyUs, 0U);
+    EXPECT_LT(timeToReadyUs, (uint64_t)DreamcastMainNode::US_PER_CHECK);
+}
+
+TEST_F(EnumerationTest, hotPlugAfterFastPeriodReadyWithinOneCheckPeriod)
+{
+    // --- MOCKING ---
+    mBus.setControllerAttached(false);
+    run(1000000);
+    EXPECT_CALL(mUsbFileSystem, add(_)).Times(1);
+
+    // --- TEST EXECUTION ---
+    mBus.setControllerAttached(true);
+    uint64_t timeToReadyUs = runUntilReady(100000);
+
+    // --- EXPECTATIONS ---
+    // Measured from detection of the main peripheral
+    printf("[ ENUM     ] hot plug to ready: %lu us\n", (long unsigned int)timeToReadyUs);
+    EXPECT_GT(timeToReadyUs, 0U);
+    EXPECT_LT(timeToReadyUs, (uint64_t)DreamcastMainNode::US_PER_CHECK);
+}
+
+TEST_F(EnumerationTest, emptyPortBacksOff)
+{
+    // --- MOCKING ---
+    mBus.setControllerAttached(false);
+
+    // --- TEST EXECUTION ---
+    run(DreamcastMainNode::FAST_ENUMERATION_DURATION_US);
+    uint32_t fastCount = mBus.getWriteCount();
+    run(1000000);
+    uint32_t backoffCount = mBus.getWriteCount() - fastCount;
+    run(1000000);
+    uint32_t ceilingCount = mBus.getWriteCount() - fastCount - backoffCount;
+
+    // --- EXPECTATIONS ---
+    // Each interval is counted from when the previous probe went out, so allow a little slip
+    EXPECT_GE(fastCount,
+              (uint32_t)(DreamcastMainNode::FAST_ENUMERATION_DURATION_US
+                         / (DreamcastMainNode::FAST_ENUMERATION_US_PER_CHECK + 2 * US_PER_TASK)));
+    // Remaining fast probes then 16, 32, 64, 128, 250, 250, 250...
+    EXPECT_LE(backoffCount, 16U);
+    EXPECT_LE(ceilingCount, (uint32_t)(1000000 / EMPTY_PORT_PROBE_MAX_INTERVAL_US + 1));
+    EXPECT_EQ(mDreamcastMainNode.getTimeToReadyUs(), 0U);
+}
+
+TEST_F(EnumerationTest, lineActivitySnapsBackToFastProbing)
+{
+    // --- MOCKING ---
+    mBus.setControllerAttached(false);
+    run(3000000);
+    mBus.injectLineNoise();
+    // Wait for the noisy probe to go out
+    uint32_t startCount = mBus.getWriteCount();
+    while (mBus.getWriteCount() == startCount)
+    {
+        run(US_PER_TASK);
+    }
+    startCount = mBus.getWriteCount();
+
+    // --- TEST EXECUTION ---
+    run(20000);
+
+    // --- EXPECTATIONS ---
+    EXPECT_GE(mBus.getWriteCount() - startCount,
+              (uint32_t)(20000 / DreamcastMainNode::FAST_ENUMERATION_US_PER_CHECK - 1));
+}
+
+TEST_F(EnumerationTest, customProbePolicy)
+{
+    // --- MOCKING ---
+    std::shared_ptr<BackoffProbePolicy> fixedPolicy =
+        std::make_shared<BackoffProbePolicy>(10000, 0, 10000, 10000);
+    DreamcastMainNode node(mBus, mPlayerData, mScheduler, fixedPolicy);
+    mBus.setControllerAttached(false);
+
+    // --- TEST EXECUTION ---
+    for (uint32_t i = 0; i < 1000000 / US_PER_TASK; ++i)
+    {
+        mClock.advance(US_PER_TASK);
+        node.task(mClock.getTimeUs());
+    }
+
+    // --- EXPECTATIONS ---
+    EXPECT_NEAR(mBus.getWriteCount(), 100U, 2U);
+}
+
+TEST_F(EnumerationTest, vmuInsertedAfterConnect)
+{
+    // --- MOCKING ---
+    mBus.setVmuAttached(false);
+    runUntilReady(100000);
+    UsbFile* addedFile = nullptr;
+    EXPECT_CALL(mUsbFileSystem, add(_)).Times(1).WillOnce(SaveArg<0>(&addedFile));
+    uint32_t startInfoRequests = mBus.getCommandCount(COMMAND_DEVICE_INFO_REQUEST);
+
+    // --- TEST EXECUTION ---
+    mBus.setVmuAttached(true);
+    // Detected on the next heartbeat, then identified right away
+    run(DreamcastMainNode::US_PER_CHECK + 2 * US_PER_TASK);
+
+    // --- EXPECTATIONS ---
+    // The VMU's storage was added after a single identification of the new sub peripheral
+    EXPECT_TRUE(Mock::VerifyAndClearExpectations(&mUsbFileSystem));
+    EXPECT_NE(addedFile, nullptr);
+    EXPECT_EQ(mBus.getCommandCount(COMMAND_DEVICE_INFO_REQUEST) - startInfoRequests, 1U);
+    EXPECT_TRUE(mDreamcastMainNode.isMainPeripheralConnected());
+}
+
+TEST_F(EnumerationTest, activeMainPeripheralNeedsNoHeartbeat)
+{
+    // --- MOCKING ---
+    runUntilReady(100000);
+    uint32_t startCount = mBus.getCommandCount(COMMAND_DEVICE_INFO_REQUEST);
+
+    // --- TEST EXECUTION ---
+    run(1000000);
+
+    // --- EXPECTATIONS ---
+    // Condition responses serve as the heartbeat
+    EXPECT_EQ(mBus.getCommandCount(COMMAND_DEVICE_INFO_REQUEST), startCount);
+    EXPECT_GT(mBus.getCommandCount(COMMAND_GET_CONDITION), 0U);
+}
+
+TEST_F(EnumerationTest, quietMainPeripheralHeartbeatAfterSilence)
+{
+    // --- MOCKING ---
+    // A screen only peripheral only talks when there is something to show
+    mBus.setMainPeripheral(DEVICE_FN_LCD, 0x00051000);
+    mBus.setVmuAttached(false);
+    runUntilReady(100000);
+    ASSERT_TRUE(mDreamcastMainNode.isMainPeripheralConnected());
+    uint32_t startCount = mBus.getCommandCount(COMMAND_DEVICE_INFO_REQUEST);
+
+    // --- TEST EXECUTION ---
+    run(1000000);
+
+    // --- EXPECTATIONS ---
+    EXPECT_TRUE(mDreamcastMainNode.isMainPeripheralConnected());
+    uint32_t heartbeatCount = mBus.getCommandCount(COMMAND_DEVICE_INFO_REQUEST) - startCount;
+    EXPECT_GT(heartbeatCount, 0U);
+    EXPECT_LE(heartbeatCount, (uint32_t)(1000000 / DreamcastMainNode::HEARTBEAT_SILENCE_US));
+}
+
+TEST_F(EnumerationTest, quietMainPeripheralDisconnectDetected)
+{
+    // --- MOCKING ---
+    mBus.setMainPeripheral(DEVICE_FN_LCD, 0x00051000);
+    mBus.setVmuAttached(false);
+    runUntilReady(100000);
+
+    // --- TEST EXECUTION ---
+    mBus.setControllerAttached(false);
+    run(DreamcastMainNode::HEARTBEAT_SILENCE_US
+        + DreamcastMainNode::MAX_FAILURE_DISCONNECT_COUNT * DreamcastMainNode::US_PER_CHECK);
+
+    // --- EXPECTATIONS ---
+    EXPECT_FALSE(mDreamcastMainNode.isMainPeripheralConnected());
+}
@@ -0,0 +1,580 @@
+// MIT License
+//
+// Copyright (c) 2022-2025 James Smith of OrangeFox86
+// https://github.com/OrangeFox86/DreamcastControllerUsbPico
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "MockMutex.hpp"
+#include "MockSystemIdentification.hpp"
+#include "MockClock.hpp"
+
+#include "FlycastCommandParser.hpp"
+#include "OutputRing.hpp"
+#include "MapleHexEncoder.hpp"
+#include "PrioritizedTxScheduler.hpp"
+#include "hal/MapleBus/MaplePacket.hpp"
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+using ::testing::NiceMock;
+using ::testing::Return;
+using ::testing::internal::CaptureStdout;
+using ::testing::internal::GetCapturedStdout;
+
+class FlycastCommandParserTest : public ::testing::Test
+{
+    public:
+        FlycastCommandParserTest() :
+            mSchedulers{
+                std::make_shared<PrioritizedTxScheduler>(mMutex, 0x00),
+                std::make_shared<PrioritizedTxScheduler>(mMutex, 0x40)},
+            mFlycast(mIdentification, mClock, mSchedulers, SENDER_ADDRESSES, 2, {}, {}, nullptr)
+        {}
+
+    protected:
+        //! Submits a line the same way the TTY parser does (NUL terminated)
+        void submit(const std::string& line)
+        {
+            mFlycast.submit(line.c_str(), line.size());
+        }
+
+        //! Pops the next transmission from the given scheduler
+        std::shared_ptr<Transmission> popNext(uint32_t idx)
+        {
+            PrioritizedTxScheduler::ScheduleItem item = mSchedulers[idx]->peekNext(0);
+            return mSchedulers[idx]->popItem(item);
+        }
+
+        //! @returns a response packet from the given sender with one payload word
+        static std::shared_ptr<const MaplePacket> response(uint8_t senderAddr, uint32_t payload)
+        {
+            return std::make_shared<MaplePacket>(
+                MaplePacket::Frame{.command=0x08, .recipientAddr=senderAddr, .senderAddr=static_cast<uint8_t>(senderAddr | 0x20)},
+                payload);
+        }
+
+        static const uint8_t SENDER_ADDRESSES[2];
+        NiceMock<MockMutex> mMutex;
+        NiceMock<MockSystemIdentification> mIdentification;
+        NiceMock<MockClock> mClock;
+        std::shared_ptr<PrioritizedTxScheduler> mSchedulers[2];
+        FlycastCommandParser mFlycast;
+};
+
+const uint8_t FlycastCommandParserTest::SENDER_ADDRESSES[2] = {0x00, 0x40};
+
+TEST_F(FlycastCommandParserTest, untaggedResponse)
+{
+    // --- TEST EXECUTION ---
+    CaptureStdout();
+    submit("X 09200001 00000001");
+    std::shared_ptr<Transmission> tx = popNext(0);
+    ASSERT_NE(tx, nullptr);
+    tx->transmitter->txComplete(response(0x00, 0xA1B2C3D4), tx);
+    std::string output = GetCapturedStdout();
+
+    // --- EXPECTATIONS ---
+    EXPECT_EQ(output, "08 00 20 01 A1B2C3D4\n");
+}
+
+TEST_F(FlycastCommandParserTest, taggedResponsesCompleteOutOfOrder)
+{
+    // --- TEST EXECUTION ---
+    CaptureStdout();
+    submit("X@1 09200001 00000001");
+    submit("X@65535 09604001 00000001");
+    submit("X@2 09200001 00000002");
+    std::shared_ptr<Transmission> port0First = popNext(0);
+    std::shared_ptr<Transmission> port1 = popNext(1);
+    ASSERT_NE(port0First, nullptr);
+    ASSERT_NE(port1, nullptr);
+    // Port 1 finishes before port 0
+    port1->transmitter->txComplete(response(0x40, 0x11111111), port1);
+    port0First->transmitter->txFailed(false, true, port0First);
+    std::shared_ptr<Transmission> port0Second = popNext(0);
+    ASSERT_NE(port0Second, nullptr);
+    port0Second->transmitter->txComplete(response(0x00, 0x22222222), port0Second);
+    std::string output = GetCapturedStdout();
+
+    // --- EXPECTATIONS ---
+    EXPECT_EQ(output,
+              "@65535 08 40 60 01 11111111\n"
+              "@1 *failed read\n"
+              "@2 08 00 20 01 22222222\n");
+}
+
+TEST_F(FlycastCommandParserTest, taggedFailuresBeforeScheduling)
+{
+    // --- TEST EXECUTION ---
+    CaptureStdout();
+    submit("X@3 09208001");
+    submit("X@4 0920");
+    submit("X@5");
+    std::string output = GetCapturedStdout();
+
+    // --- EXPECTATIONS ---
+    EXPECT_EQ(output,
+              "@3 *failed invalid sender\n"
+              "@4 *failed missing data\n"
+              "@5 *failed missing data\n");
+}
+
+TEST_F(FlycastCommandParserTest, taggedPacketCanceledByUnplug)
+{
+    // --- MOCKING ---
+    uint32_t numPendingBefore = mFlycast.getNumPendingTags();
+    CaptureStdout();
+    submit("X@7 09200001 00000001");
+    uint32_t numPendingQueued = mFlycast.getNumPendingTags();
+
+    // --- TEST EXECUTION ---
+    // Device on port 0 is removed before the packet goes out
+    uint32_t numCanceled = mSchedulers[0]->cancelByRecipient(0x20);
+    std::string output = GetCapturedStdout();
+
+    // --- EXPECTATIONS ---
+    EXPECT_EQ(numCanceled, 1U);
+    EXPECT_EQ(output, "@7 *failed write\n");
+    EXPECT_EQ(numPendingQueued, numPendingBefore + 1);
+    EXPECT_EQ(mFlycast.getNumPendingTags(), numPendingBefore);
+}
+
+TEST_F(FlycastCommandParserTest, invalidTag)
+{
+    // --- TEST EXECUTION ---
+    CaptureStdout();
+    submit("X@ 09200000");
+    submit("X@65536 09200000");
+    submit("X@1x 09200000");
+    std::string output = GetCapturedStdout();
+
+    // --- EXPECTATIONS ---
+    EXPECT_EQ(output, "*failed invalid tag\n*failed invalid tag\n*failed invalid tag\n");
+    EXPECT_EQ(popNext(0), nullptr);
+}
+
+TEST_F(FlycastCommandParserTest, batchRespondsOnceAllAreDone)
+{
+    // --- TEST EXECUTION ---
+    CaptureStdout();
+    submit("XM 09200001 00000001;09604001 00000001");
+    std::shared_ptr<Transmission> port0 = popNext(0);
+    std::shared_ptr<Transmission> port1 = popNext(1);
+    ASSERT_NE(port0, nullptr);
+    ASSERT_NE(port1, nullptr);
+    port1->transmitter->txComplete(response(0x40, 0x11111111), port1);
+    std::string partialOutput = GetCapturedStdout();
+    CaptureStdout();
+    port0->transmitter->txFailed(false, true, port0);
+    std::string output = GetCapturedStdout();
+
+    // --- EXPECTATIONS ---
+    EXPECT_EQ(port0->packet->getFrameWord(), 0x09200001U);
+    EXPECT_EQ(port1->packet->getFrameWord(), 0x09604001U);
+    EXPECT_EQ(partialOutput, "");
+    EXPECT_EQ(output, "*failed read;08 40 60 01 11111111\n");
+}
+
+TEST_F(FlycastCommandParserTest, batchWithImmediateFailures)
+{
+    // --- TEST EXECUTION ---
+    CaptureStdout();
+    submit("XM 09208001;0920;");
+    std::string output = GetCapturedStdout();
+
+    // --- EXPECTATIONS ---
+    EXPECT_EQ(output, "*failed invalid sender;*failed missing data;*failed missing data\n");
+}
+
+TEST_F(FlycastCommandParserTest, batchTooManyPackets)
+{
+    // --- TEST EXECUTION ---
+    CaptureStdout();
+    submit("XM 09200000;09200000;09200000;09200000;09200000;09200000;09200000;09200000;09200000");
+    std::string output = GetCapturedStdout();
+
+    // --- EXPECTATIONS ---
+    EXPECT_EQ(output, "*failed too many packets\n");
+    EXPECT_EQ(popNext(0), nullptr);
+}
+
+TEST_F(FlycastCommandParserTest, batchBusyUntilOneCompletes)
+{
+    // --- MOCKING ---
+    std::vector<std::shared_ptr<Transmission>> pending;
+    CaptureStdout();
+    for (uint32_t i = 0; i < 4; ++i)
+    {
+        submit("XM 09200000");
+        pending.push_back(popNext(0));
+        ASSERT_NE(pending.back(), nullptr);
+    }
+
+    // --- TEST EXECUTION ---
+    submit("XM 09200000");
+    std::string busyOutput = GetCapturedStdout();
+    CaptureStdout();
+    for (std::shared_ptr<Transmission>& tx : pending)
+    {
+        tx->transmitter->txFailed(true, false, tx);
+    }
+    submit("XM 09200000");
+    std::shared_ptr<Transmission> tx = popNext(0);
+    ASSERT_NE(tx, nullptr);
+    tx->transmitter->txComplete(response(0x00, 0x12345678), tx);
+    std::string output = GetCapturedStdout();
+
+    // --- EXPECTATIONS ---
+    EXPECT_EQ(busyOutput, "*failed busy\n");
+    EXPECT_EQ(output,
+              "*failed write\n*failed write\n*failed write\n*failed write\n"
+              "08 00 20 01 12345678\n");
+}
+
+TEST_F(FlycastCommandParserTest, batchCompletesWhenDeviceUnplugged)
+{
+    // --- MOCKING ---
+    CaptureStdout();
+    submit("XM 09200001 00000001;09604001 00000001");
+    std::shared_ptr<Transmission> port1 = popNext(1);
+    ASSERT_NE(port1, nullptr);
+    port1->transmitter->txComplete(response(0x40, 0x11111111), port1);
+    // Fill the remaining batch slots with packets for the same device
+    for (uint32_t i = 0; i < 3; ++i)
+    {
+        submit("XM 09200000");
+    }
+    std::string queuedOutput = GetCapturedStdout();
+
+    // --- TEST EXECUTION ---
+    // Device on port 0 is removed before any of its packets go out
+    CaptureStdout();
+    uint32_t numCanceled = mSchedulers[0]->cancelByRecipient(0x20);
+    std::string canceledOutput = GetCapturedStdout();
+    CaptureStdout();
+    submit("XM 09200000");
+    std::shared_ptr<Transmission> tx = popNext(0);
+    ASSERT_NE(tx, nullptr);
+    tx->transmitter->txComplete(response(0x00, 0x12345678), tx);
+    std::string output = GetCapturedStdout();
+
+    // --- EXPECTATIONS ---
+    EXPECT_EQ(queuedOutput, "");
+    EXPECT_EQ(numCanceled, 4U);
+    EXPECT_EQ(canceledOutput,
+              "*failed write;08 40 60 01 11111111\n"
+              "*failed write\n*failed write\n*failed write\n");
+    // All batch slots were freed
+    EXPECT_EQ(output, "08 00 20 01 12345678\n");
+}
+
+TEST_F(FlycastCommandParserTest, clockPingPrintsDeviceTime)
+{
+    // --- MOCKING ---
+    EXPECT_CALL(mClock, getTimeUs()).WillOnce(Return(0x123456789AULL));
+
+    // --- TEST EXECUTION ---
+    CaptureStdout();
+    submit("XK");
+    std::string output = GetCapturedStdout();
+
+    // --- EXPECTATIONS ---
+    EXPECT_EQ(output, "^000000123456789A\n");
+}
+
+TEST_F(FlycastCommandParserTest, responsesNotTimestampedByDefault)
+{
+    // --- TEST EXECUTION ---
+    CaptureStdout();
+    submit("X 09200000");
+    std::shared_ptr<Transmission> tx = popNext(0);
+    ASSERT_NE(tx, nullptr);
+    tx->transmitter->txCompleteAt(response(0x00, 0x12345678), tx, 5000);
+    std::string output = GetCapturedStdout();
+
+    // --- EXPECTATIONS ---
+    EXPECT_EQ(output, "08 00 20 01 12345678\n");
+}
+
+TEST_F(FlycastCommandParserTest, responsesTimestampedAtBusCompletion)
+{
+    // --- MOCKING ---
+    ON_CALL(mClock, getTimeUs()).WillByDefault(Return(0x1000));
+
+    // --- TEST EXECUTION ---
+    CaptureStdout();
+    submit("XK 1");
+    submit("X 09200000");
+    submit("X@7 09604000");
+    std::shared_ptr<Transmission> untagged = popNext(0);
+    std::shared_ptr<Transmission> tagged = popNext(1);
+    ASSERT_NE(untagged, nullptr);
+    ASSERT_NE(tagged, nullptr);
+    tagged->transmitter->txCompleteAt(response(0x40, 0xAABBCCDD), tagged, 0x1234);
+    untagged->transmitter->txFailed(false, true, untagged);
+    // Failures before scheduling never reached the bus
+    submit("X 0920");
+    std::string output = GetCapturedStdout();
+
+    // --- EXPECTATIONS ---
+    EXPECT_EQ(output,
+              "1\n"
+              "^0000000000001234 @7 08 40 60 01 AABBCCDD\n"
+              "^0000000000001000 *failed read\n"
+              "*failed missing data\n");
+}
+
+TEST_F(FlycastCommandParserTest, batchTimestampedAtLastBusCompletion)
+{
+    // --- TEST EXECUTION ---
+    CaptureStdout();
+    submit("XK 1");
+    submit("XM 09200000;09604000");
+    std::shared_ptr<Transmission> port0 = popNext(0);
+    std::shared_ptr<Transmission> port1 = popNext(1);
+    ASSERT_NE(port0, nullptr);
+    ASSERT_NE(port1, nullptr);
+    port1->transmitter->txCompleteAt(response(0x40, 0x22222222), port1, 0x2000);
+    port0->transmitter->txCompleteAt(response(0x00, 0x11111111), port0, 0x2100);
+    submit("XK 0");
+    submit("X 09200000");
+    std::shared_ptr<Transmission> tx = popNext(0);
+    ASSERT_NE(tx, nullptr);
+    tx->transmitter->txCompleteAt(response(0x00, 0x33333333), tx, 0x2200);
+    std::string output = GetCapturedStdout();
+
+    // --- EXPECTATIONS ---
+    EXPECT_EQ(output,
+              "1\n"
+              "^0000000000002100 08 00 20 01 11111111;08 40 60 01 22222222\n"
+              "1\n"
+              "08 00 20 01 33333333\n");
+}
+
+TEST_F(FlycastCommandParserTest, responsesWrittenAsWholeLinesAndDropsCounted)
+{
+    // --- MOCKING ---
+    uint8_t buffer[64];
+    OutputRing ring(buffer, sizeof(buffer), mMutex);
+    FlycastCommandParser flycast(mIdentification, mClock, mSchedulers, SENDER_ADDRESSES, 2, {}, {}, &ring);
+    const std::string first("X 09200000");
+    const std::string second("X 09604000");
+    flycast.submit(first.c_str(), first.size());
+    flycast.submit(second.c_str(), second.size());
+    std::shared_ptr<Transmission> port0 = popNext(0);
+    std::shared_ptr<Transmission> port1 = popNext(1);
+    ASSERT_NE(port0, nullptr);
+    ASSERT_NE(port1, nullptr);
+    // 6 payload words is 66 characters, which never fits
+    const uint32_t payload[6] = {1, 2, 3, 4, 5, 6};
+    std::shared_ptr<const MaplePacket> longResponse =
+        std::make_shared<MaplePacket>(MaplePacket::Frame{.command=0x08, .recipientAddr=0x00, .senderAddr=0x20}, payload, 6);
+
+    // --- TEST EXECUTION ---
+    port0->transmitter->txComplete(longResponse, port0);
+    port1->transmitter->txComplete(response(0x40, 0x11111111), port1);
+    char out[64];
+    std::string written(out, ring.read(reinterpret_cast<uint8_t*>(out), sizeof(out)));
+    CaptureStdout();
+    const std::string query("XO");
+    flycast.submit(query.c_str(), query.size());
+    std::string output = GetCapturedStdout();
+
+    // --- EXPECTATIONS ---
+    // Nothing of the dropped line made it out, but it was still answered
+    EXPECT_EQ(written, "*failed dropped\n08 40 60 01 11111111\n");
+    EXPECT_EQ(output, "66\n");
+}
+
+TEST_F(FlycastCommandParserTest, everyTagAnsweredOnceWhenOutputFull)
+{
+    // --- MOCKING ---
+    uint8_t buffer[256];
+    OutputRing ring(buffer, sizeof(buffer), mMutex, 0, 128);
+    FlycastCommandParser flycast(mIdentification, mClock, mSchedulers, SENDER_ADDRESSES, 2, {}, {}, &ring);
+    uint32_t numPendingBefore = flycast.getNumPendingTags();
+    // Everything but the reserved space is taken
+    ring.write(std::vector<uint8_t>(128, 'x').data(), 128);
+    const uint32_t payload[6] = {1, 2, 3, 4, 5, 6};
+    std::vector<std::shared_ptr<Transmission>> pending;
+    for (uint32_t tag = 1; tag <= 4; ++tag)
+    {
+        const uint32_t idx = tag % 2;
+        const std::string line =
+            "X@" + std::to_string(tag) + (idx == 0 ? " 09200000" : " 09604000");
+        flycast.submit(line.c_str(), line.size());
+        pending.push_back(popNext(idx));
+        ASSERT_NE(pending.back(), nullptr);
+    }
+
+    // --- TEST EXECUTION ---
+    for (uint32_t i = 0; i < 3; ++i)
+    {
+        const uint8_t addr = pending[i]->packet->frame.senderAddr;
+        std::shared_ptr<const MaplePacket> longResponse = std::make_shared<MaplePacket>(
+            MaplePacket::Frame{.command=0x08, .recipientAddr=addr, .senderAddr=static_cast<uint8_t>(addr | 0x20)},
+            payload,
+            6);
+        pending[i]->transmitter->txComplete(longResponse, pending[i]);
+    }
+    pending[3]->transmitter->txFailed(false, true, pending[3]);
+    char out[256];
+    std::string written(out, ring.read(reinterpret_cast<uint8_t*>(out), sizeof(out)));
+
+    // --- EXPECTATIONS ---
+    EXPECT_EQ(written,
+              std::string(128, 'x')
+              + "@1 *failed dropped\n"
+              + "@2 *failed dropped\n"
+              + "@3 *failed dropped\n"
+              + "@4 *failed read\n");
+    EXPECT_EQ(flycast.getNumPendingTags(), numPendingBefore);
+}
+
+TEST_F(FlycastCommandParserTest, sessionResetStopsTimestampsAndForgetsPending)
+{
+    // --- MOCKING ---
+    uint32_t numPendingBefore = mFlycast.getNumPendingTags();
+    CaptureStdout();
+    submit("XK 1");
+    submit("X@1 09200000");
+    submit("XM 09604000");
+    std::string setupOutput = GetCapturedStdout();
+    std::shared_ptr<Transmission> tagged = popNext(0);
+    std::shared_ptr<Transmission> batched = popNext(1);
+    ASSERT_NE(tagged, nullptr);
+    ASSERT_NE(batched, nullptr);
+
+    // --- TEST EXECUTION ---
+    mFlycast.sessionReset();
+    CaptureStdout();
+    tagged->transmitter->txCompleteAt(response(0x00, 0x11111111), tagged, 0x1000);
+    batched->transmitter->txCompleteAt(response(0x40, 0x22222222), batched, 0x1000);
+    submit("X 09200000");
+    std::shared_ptr<Transmission> tx = popNext(0);
+    ASSERT_NE(tx, nullptr);
+    tx->transmitter->txCompleteAt(response(0x00, 0x33333333), tx, 0x2000);
+    std::string output = GetCapturedStdout();
+
+    // --- EXPECTATIONS ---
+    EXPECT_EQ(setupOutput, "1\n");
+    // Nothing set up by the closed session leaks into the next one
+    EXPECT_EQ(output, "08 00 20 01 33333333\n");
+    EXPECT_EQ(mFlycast.getNumPendingTags(), numPendingBefore);
+}
+
+class FlycastBatchOutputTest : public FlycastCommandParserTest
+{
+    public:
+        // Same sizes as the CDC output
+        FlycastBatchOutputTest() :
+            mRing(mBuffer, sizeof(mBuffer), mMutex, 256, 256),
+            mRingFlycast(mIdentification, mClock, mSchedulers, SENDER_ADDRESSES, 2, {}, {}, &mRing)
+        {}
+
+    protected:
+        //! Submits a batch of block reads to port 0 and completes each with a maximum size response
+        void completeMaxSizeBatch(uint32_t numPackets)
+        {
+            std::string line("XM 0B200000");
+            for (uint32_t i = 1; i < numPackets; ++i)
+            {
+                line += ";0B200000";
+            }
+            mRingFlycast.submit(line.c_str(), line.size());
+
+            std::vector<uint32_t> payload(255, 0xA5A5A5A5);
+            std::shared_ptr<const MaplePacket> maxResponse = std::make_shared<MaplePacket>(
+                MaplePacket::Frame{.command=0x08, .recipientAddr=0x00, .senderAddr=0x20},
+                payload.data(),
+                payload.size());
+            std::vector<std::shared_ptr<Transmission>> pending;
+            for (uint32_t i = 0; i < numPackets; ++i)
+            {
+                pending.push_back(popNext(0));
+                ASSERT_NE(pending.back(), nullptr);
+            }
+            for (std::shared_ptr<Transmission>& tx : pending)
+            {
+                tx->transmitter->txComplete(maxResponse, tx);
+            }
+        }
+
+        std::string readAll()
+        {
+            std::string out;
+            char chunk[1024];
+            uint32_t len;
+            while ((len = mRing.read(reinterpret_cast<uint8_t*>(chunk), sizeof(chunk))) > 0)
+            {
+                out.append(chunk, len);
+            }
+            return out;
+        }
+
+        uint8_t mBuffer[8192];
+        OutputRing mRing;
+        FlycastCommandParser mRingFlycast;
+};
+
+TEST_F(FlycastBatchOutputTest, maxSizeResponsesWrittenAsOneWholeLine)
+{
+    // --- TEST EXECUTION ---
+    completeMaxSizeBatch(3);
+    std::string written = readAll();
+
+    // --- EXPECTATIONS ---
+    ASSERT_EQ(written.size(), 3U * MapleHexEncoder::MAX_FLYCAST_LEN);
+    EXPECT_EQ(std::count(written.begin(), written.end(), ';'), 2);
+    EXPECT_EQ(std::count(written.begin(), written.end(), '\n'), 1);
+    EXPECT_EQ(written.back(), '\n');
+    EXPECT_EQ(written.substr(0, 20), "08 00 20 FF A5A5A5A5");
+}
+
+TEST_F(FlycastBatchOutputTest, lineWhichDoesNotFitNowIsDroppedWhole)
+{
+    // --- MOCKING ---
+    const std::string filler(4096, 'x');
+    mRing.write(reinterpret_cast<const uint8_t*>(filler.data()), filler.size());
+
+    // --- TEST EXECUTION ---
+    completeMaxSizeBatch(3);
+    std::string written = readAll();
+
+    // --- EXPECTATIONS ---
+    EXPECT_EQ(written, filler + "*failed dropped\n");
+}
+
+TEST_F(FlycastBatchOutputTest, lineWhichCanNeverFitIsTooLarge)
+{
+    // --- TEST EXECUTION ---
+    // Largest batch
+    completeMaxSizeBatch(8);
+    std::string written = readAll();
+
+    // --- EXPECTATIONS ---
+    EXPECT_EQ(written, "*failed too large\n");
+}
@@ -0,0 +1,250 @@
+// MIT License
+//
+// Copyright (c) 2022-2025 James Smith of OrangeFox86
+// https://github.com/OrangeFox86/DreamcastControllerUsbPico
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "hal/Usb/DreamcastGamepadReport.hpp"
+
+#include <chrono>
+#include <vector>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+//! Reproduces the per-field conversion which was done through the UsbGamepad setters
+class PerFieldReportReference
+{
+    public:
+        PerFieldReportReference() : mReport(), mUpdated(false) {}
+
+        //! @returns true iff any field of the report changed
+        bool setCondition(const controller_condition_t& condition)
+        {
+            mUpdated = false;
+            setButton(0, 0 == condition.a);
+            setButton(1, 0 == condition.b);
+            setButton(2, 0 == condition.c);
+            setButton(3, 0 == condition.x);
+            setButton(4, 0 == condition.y);
+            setButton(5, 0 == condition.z);
+            setButton(11, 0 == condition.start);
+            setButton(6, 0 == condition.rightb);
+            setButton(7, 0 == condition.leftb);
+            setButton(8, 0 == condition.downb);
+            setButton(9, 0 == condition.upb);
+            setButton(10, 0 == condition.d);
+            setAxis(mReport.z, static_cast<int32_t>(condition.l) - 128);
+            setAxis(mReport.rz, static_cast<int32_t>(condition.r) - 128);
+            setAxis(mReport.x, static_cast<int32_t>(condition.lAnalogLR) - 128);
+            setAxis(mReport.y, static_cast<int32_t>(condition.lAnalogUD) - 128);
+            setAxis(mReport.rx, static_cast<int32_t>(condition.rAnalogLR) - 128);
+            setAxis(mReport.ry, static_cast<int32_t>(condition.rAnalogUD) - 128);
+            uint8_t hat = getHat(0 == condition.up, 0 == condition.down, 0 == condition.left, 0 == condition.right);
+            mUpdated = mUpdated || (hat != mReport.hat);
+            mReport.hat = hat;
+            return mUpdated;
+        }
+
+        hid_dc_gamepad_report_t mReport;
+
+    private:
+        void setButton(uint8_t button, bool isPressed)
+        {
+            uint32_t lastButtons = mReport.buttons;
+            if (isPressed)
+            {
+                mReport.buttons |= (1 << button);
+            }
+            else
+            {
+                mReport.buttons &= ~(1 << button);
+            }
+            mUpdated = mUpdated || (lastButtons != mReport.buttons);
+        }
+
+        void setAxis(int8_t& axis, int32_t value)
+        {
+            int8_t limited = (value < -127) ? -127 : ((value > 127) ? 127 : value);
+            mUpdated = mUpdated || (limited != axis);
+            axis = limited;
+        }
+
+        static uint8_t getHat(bool up, bool down, bool left, bool right)
+        {
+            typedef DreamcastGamepadReportBuilder B;
+            if (up)
+            {
+                return left ? B::HAT_UP_LEFT : (right ? B::HAT_UP_RIGHT : B::HAT_UP);
+            }
+            else if (down)
+            {
+                return left ? B::HAT_DOWN_LEFT : (right ? B::HAT_DOWN_RIGHT : B::HAT_DOWN);
+            }
+            else if (left)
+            {
+                return B::HAT_LEFT;
+            }
+            else if (right)
+            {
+                return B::HAT_RIGHT;
+            }
+            return B::HAT_CENTERED;
+        }
+
+        bool mUpdated;
+};
+
+static controller_condition_t makeCondition(uint32_t word0, uint32_t word1)
+{
+    uint32_t words[2] = {word0, word1};
+    controller_condition_t condition;
+    memcpy(&condition, words, sizeof(condition));
+    return condition;
+}
+
+static void expectSameReport(const hid_dc_gamepad_report_t& actual,
+                             const hid_dc_gamepad_report_t& expected,
+                             uint32_t word0,
+                             uint32_t word1)
+{
+    EXPECT_EQ(actual.x, expected.x) << std::hex << word0 << " " << word1;
+    EXPECT_EQ(actual.y, expected.y) << std::hex << word0 << " " << word1;
+    EXPECT_EQ(actual.z, expected.z) << std::hex << word0 << " " << word1;
+    EXPECT_EQ(actual.rz, expected.rz) << std::hex << word0 << " " << word1;
+    EXPECT_EQ(actual.rx, expected.rx) << std::hex << word0 << " " << word1;
+    EXPECT_EQ(actual.ry, expected.ry) << std::hex << word0 << " " << word1;
+    EXPECT_EQ(actual.hat, expected.hat) << std::hex << word0 << " " << word1;
+    EXPECT_EQ(actual.buttons, expected.buttons) << std::hex << word0 << " " << word1;
+}
+
+TEST(DreamcastGamepadReportBuilderTest, allDigitalCombinationsMatchPerFieldConversion)
+{
+    // --- TEST EXECUTION ---
+    for (uint32_t digital = 0; digital <= 0xFFFF; ++digital)
+    {
+        uint32_t word0 = (digital << 16) | 0x8000 | (digital & 0xFF);
+        uint32_t word1 = 0x80808080 ^ (digital * 0x01010101);
+        controller_condition_t condition = makeCondition(word0, word1);
+        PerFieldReportReference reference;
+        reference.setCondition(condition);
+        DreamcastGamepadReportBuilder builder;
+        builder.setCondition(condition);
+
+        // --- EXPECTATIONS ---
+        expectSameReport(builder.getReport(), reference.mReport, word0, word1);
+        EXPECT_EQ(builder.getDpadMask(), (~digital >> 12) & 0x0F);
+        if (HasFailure())
+        {
+            break;
+        }
+    }
+}
+
+TEST(DreamcastGamepadReportBuilderTest, allAnalogValuesMatchPerFieldConversion)
+{
+    // --- TEST EXECUTION ---
+    for (uint32_t value = 0; value <= 0xFF; ++value)
+    {
+        uint32_t word0 = 0xFFFF0000 | (value << 8) | (0xFF - value);
+        uint32_t word1 = value * 0x01010101;
+        controller_condition_t condition = makeCondition(word0, word1);
+        PerFieldReportReference reference;
+        reference.setCondition(condition);
+        DreamcastGamepadReportBuilder builder;
+        builder.setCondition(condition);
+
+        // --- EXPECTATIONS ---
+        expectSameReport(builder.getReport(), reference.mReport, word0, word1);
+    }
+}
+
+TEST(DreamcastGamepadReportBuilderTest, unchangedConditionSkipped)
+{
+    // --- MOCKING ---
+    DreamcastGamepadReportBuilder builder;
+    controller_condition_t condition = makeCondition(0xFFFF0000, 0x80808080);
+
+    // --- TEST EXECUTION ---
+    bool first = builder.setCondition(condition);
+    bool repeat = builder.setCondition(condition);
+    condition.a = 0;
+    bool changed = builder.setCondition(condition);
+    builder.reset();
+    bool afterReset = builder.setCondition(condition);
+
+    // --- EXPECTATIONS ---
+    EXPECT_TRUE(first);
+    EXPECT_FALSE(repeat);
+    EXPECT_TRUE(changed);
+    EXPECT_EQ(builder.getReport().buttons, 0x00000001);
+    EXPECT_TRUE(afterReset);
+}
+
+TEST(DreamcastGamepadReportBuilderTest, benchmark)
+{
+    // --- MOCKING ---
+    // Conditions change every 8th poll on average, as when a player is actively moving
+    const uint32_t numConditions = 1000000;
+    std::vector<controller_condition_t> conditions;
+    conditions.reserve(numConditions);
+    srand(1);
+    uint32_t word0 = 0xFFFF0000;
+    uint32_t word1 = 0x80808080;
+    for (uint32_t i = 0; i < numConditions; ++i)
+    {
+        if ((rand() & 0x07) == 0)
+        {
+            word0 = (static_cast<uint32_t>(rand()) << 16) | (rand() & 0xFFFF);
+            word1 = (static_cast<uint32_t>(rand()) << 16) | (rand() & 0xFFFF);
+        }
+        conditions.push_back(makeCondition(word0, word1));
+    }
+    PerFieldReportReference reference;
+    DreamcastGamepadReportBuilder builder;
+
+    // --- TEST EXECUTION ---
+    uint32_t referenceUpdates = 0;
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for (const controller_condition_t& condition : conditions)
+    {
+        referenceUpdates += reference.setCondition(condition) ? 1 : 0;
+    }
+    std::chrono::steady_clock::time_point middle = std::chrono::steady_clock::now();
+    uint32_t builderUpdates = 0;
+    for (const controller_condition_t& condition : conditions)
+    {
+        builderUpdates += builder.setCondition(condition) ? 1 : 0;
+    }
+    std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+
+    // --- EXPECTATIONS ---
+    // Rebuilt at least whenever the report changed
+    EXPECT_GE(builderUpdates, referenceUpdates);
+    expectSameReport(builder.getReport(), reference.mReport, 0, 0);
+
+    double referenceNs = std::chrono::duration<double, std::nano>(middle - start).count();
+    double builderNs = std::chrono::duration<double, std::nano>(end - middle).count();
+    printf("[ BENCHMARK] %.1f ns per condition per field, %.1f ns per condition table driven\n",
+           referenceNs / numConditions,
+           builderNs / numConditions);
+}
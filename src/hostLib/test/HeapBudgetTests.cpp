@@ -0,0 +1,228 @@
+// MIT License
+//
+// Copyright (c) 2022-2025 James Smith of OrangeFox86
+// https://github.com/OrangeFox86/DreamcastControllerUsbPico
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "DreamcastMainNode.hpp"
+#include "PrioritizedTxScheduler.hpp"
+#include "ScreenData.hpp"
+#include "PlayerData.hpp"
+#include "HeapStats.hpp"
+#include "dreamcast_constants.h"
+#include "hal/Usb/UsbFile.hpp"
+
+#include "MockUsbFileSystem.hpp"
+#include "SimulatedMapleDevices.hpp"
+
+#include <atomic>
+#include <thread>
+#include <vector>
+#include <memory>
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+using ::testing::_;
+using ::testing::Invoke;
+using ::testing::NiceMock;
+
+// gmock allocates on every mocked call which would swamp the counts, so light fakes are used for
+// everything touched on each cycle
+
+class HeapBudgetTest : public ::testing::Test
+{
+    public:
+        //! Number of players simulated
+        static const uint32_t NUM_PLAYERS = 4;
+        //! Simulated time between each call to task()
+        static const uint32_t US_PER_TASK = 100;
+        //! Number of task() calls which make up one 16 ms polling cycle
+        static const uint32_t TASKS_PER_CYCLE = 16000 / US_PER_TASK;
+
+        HeapBudgetTest() : mNodes(), mStorage() {}
+
+    protected:
+        StdMutex mHeapStatsMutex;
+        SimulatedClock mClock;
+        NullControllerObserver mGamepads[NUM_PLAYERS];
+        NiceMock<MockUsbFileSystem> mUsbFileSystem;
+        ScreenData mScreenData[NUM_PLAYERS];
+        PollSettings mPollSettings[NUM_PLAYERS];
+        SimulatedControllerWithVmu mBuses[NUM_PLAYERS];
+        StdMutex mSchedulerMutexes[NUM_PLAYERS];
+        std::vector<std::shared_ptr<DreamcastMainNode>> mNodes;
+        std::vector<UsbFile*> mStorage;
+        HeapStats mBaseline;
+
+        virtual void SetUp()
+        {
+            heap_stats_set_mutex(&mHeapStatsMutex);
+
+            ON_CALL(mUsbFileSystem, add(_)).WillByDefault(Invoke(
+                [this](UsbFile* file){ mStorage.push_back(file); }
+            ));
+
+            // Everything allocated from here on is owned by the host nodes
+            mStorage.reserve(NUM_PLAYERS);
+            mNodes.reserve(NUM_PLAYERS);
+            mBaseline = heap_stats_get();
+            heap_stats_reset_peak();
+
+            for (uint32_t i = 0; i < NUM_PLAYERS; ++i)
+            {
+                PlayerData playerData(i, mGamepads[i], mScreenData[i], mClock, mUsbFileSystem, mPollSettings[i]);
+                std::shared_ptr<PrioritizedTxScheduler> scheduler =
+                    std::make_shared<PrioritizedTxScheduler>(
+                        mSchedulerMutexes[i],
+                        DreamcastPeripheral::getRecipientAddress(i, 0));
+                mNodes.push_back(std::make_shared<DreamcastMainNode>(mBuses[i], playerData, scheduler));
+            }
+        }
+
+        virtual void TearDown()
+        {
+            mNodes.clear();
+            heap_stats_set_mutex(nullptr);
+        }
+
+        //! Runs task() of all players for the given number of cycles
+        //! @returns the highest number of allocations made within a single task() call
+        uint32_t runCycles(uint32_t numCycles)
+        {
+            uint32_t maxTaskAllocations = 0;
+            for (uint32_t i = 0; i < numCycles * TASKS_PER_CYCLE; ++i)
+            {
+                mClock.advance(US_PER_TASK);
+                for (std::shared_ptr<DreamcastMainNode>& node : mNodes)
+                {
+                    node->task(mClock.getTimeUs());
+                    maxTaskAllocations = std::max(maxTaskAllocations, node->getLastTaskAllocationCount());
+                }
+            }
+            return maxTaskAllocations;
+        }
+
+        //! @returns peak bytes allocated since SetUp()
+        uint32_t peakBytesOverBaseline()
+        {
+            return heap_stats_get().peakBytes - mBaseline.liveBytes;
+        }
+};
+
+// Budgets are measured values plus some headroom - only raise these deliberately
+//! Allocations for a full 16 ms cycle of 4 players polling controller and VMU buttons
+static const uint32_t STEADY_STATE_ALLOCATIONS_PER_CYCLE_BUDGET = 20;
+//! Allocations for a full 16 ms cycle of 4 players which also write a new screen each cycle
+static const uint32_t SCREEN_STREAM_ALLOCATIONS_PER_CYCLE_BUDGET = 44;
+//! Most allocations allowed within a single DreamcastMainNode::task() call after connection
+static const uint32_t SINGLE_TASK_ALLOCATIONS_BUDGET = 8;
+//! Peak heap usage of 4 players, each with a controller and VMU (this includes connection)
+static const uint32_t PEAK_HEAP_BYTES_BUDGET = 12 * 1024;
+
+TEST_F(HeapBudgetTest, steadyStateControllerWithVmu)
+{
+    // --- MOCKING ---
+    // Allow all peripherals to connect and settle
+    runCycles(10);
+    ASSERT_EQ(mStorage.size(), (size_t)NUM_PLAYERS);
+
+    // --- TEST EXECUTION ---
+    const uint32_t numCycles = 50;
+    uint32_t startAllocations = heap_stats_total_allocations();
+    uint32_t maxTaskAllocations = runCycles(numCycles);
+    uint32_t allocationsPerCycle = (heap_stats_total_allocations() - startAllocations) / numCycles;
+    uint32_t peakBytes = peakBytesOverBaseline();
+
+    // --- EXPECTATIONS ---
+    printf("[ HEAP     ] steady state: %lu allocations per cycle, %lu max per task, %lu peak bytes\n",
+           (long unsigned int)allocationsPerCycle,
+           (long unsigned int)maxTaskAllocations,
+           (long unsigned int)peakBytes);
+    EXPECT_LE(allocationsPerCycle, STEADY_STATE_ALLOCATIONS_PER_CYCLE_BUDGET);
+    EXPECT_LE(maxTaskAllocations, SINGLE_TASK_ALLOCATIONS_BUDGET);
+    EXPECT_LE(peakBytes, PEAK_HEAP_BYTES_BUDGET);
+}
+
+TEST_F(HeapBudgetTest, flycastScreenStream)
+{
+    // --- MOCKING ---
+    runCycles(10);
+    uint32_t screen[ScreenData::NUM_SCREEN_WORDS] = {};
+
+    // --- TEST EXECUTION ---
+    // New screen data from the host on every cycle, just like flycast does while a game runs
+    const uint32_t numCycles = 50;
+    uint32_t startAllocations = heap_stats_total_allocations();
+    uint32_t maxTaskAllocations = 0;
+    for (uint32_t i = 0; i < numCycles; ++i)
+    {
+        screen[0] = i;
+        for (uint32_t j = 0; j < NUM_PLAYERS; ++j)
+        {
+            mScreenData[j].setData(screen);
+        }
+        maxTaskAllocations = std::max(maxTaskAllocations, runCycles(1));
+    }
+    uint32_t allocationsPerCycle = (heap_stats_total_allocations() - startAllocations) / numCycles;
+    uint32_t peakBytes = peakBytesOverBaseline();
+
+    // --- EXPECTATIONS ---
+    printf("[ HEAP     ] screen stream: %lu allocations per cycle, %lu max per task, %lu peak bytes\n",
+           (long unsigned int)allocationsPerCycle,
+           (long unsigned int)maxTaskAllocations,
+           (long unsigned int)peakBytes);
+    EXPECT_LE(allocationsPerCycle, SCREEN_STREAM_ALLOCATIONS_PER_CYCLE_BUDGET);
+    EXPECT_LE(maxTaskAllocations, SINGLE_TASK_ALLOCATIONS_BUDGET);
+    EXPECT_LE(peakBytes, PEAK_HEAP_BYTES_BUDGET);
+}
+
+TEST_F(HeapBudgetTest, massStorageRead)
+{
+    // --- MOCKING ---
+    runCycles(10);
+    ASSERT_EQ(mStorage.size(), (size_t)NUM_PLAYERS);
+    uint8_t buffer[512] = {};
+    std::atomic<int32_t> numRead(-2);
+
+    // --- TEST EXECUTION ---
+    // The USB core blocks in read() while the maple core keeps processing
+    std::thread usbThread(
+        [this, &buffer, &numRead]()
+        {
+            numRead.store(mStorage[0]->read(3, buffer, sizeof(buffer), 1000000));
+        }
+    );
+    uint32_t maxTaskAllocations = 0;
+    for (uint32_t i = 0; i < 100 && numRead.load() == -2; ++i)
+    {
+        maxTaskAllocations = std::max(maxTaskAllocations, runCycles(1));
+    }
+    usbThread.join();
+    uint32_t peakBytes = peakBytesOverBaseline();
+
+    // --- EXPECTATIONS ---
+    printf("[ HEAP     ] storage read: %lu max per task, %lu peak bytes\n",
+           (long unsigned int)maxTaskAllocations,
+           (long unsigned int)peakBytes);
+    EXPECT_EQ(numRead.load(), 512);
+    EXPECT_LE(maxTaskAllocations, SINGLE_TASK_ALLOCATIONS_BUDGET);
+    EXPECT_LE(peakBytes, PEAK_HEAP_BYTES_BUDGET);
+}
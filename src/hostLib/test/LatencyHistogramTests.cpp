@@ -0,0 +1,95 @@
+// MIT License
+//
+// Copyright (c) 2022-2025 James Smith of OrangeFox86
+// https://github.com/OrangeFox86/DreamcastControllerUsbPico
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "LatencyHistogram.hpp"
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+class LatencyHistogramTest : public ::testing::Test
+{
+    protected:
+        LatencyHistogram mHistogram;
+};
+
+TEST_F(LatencyHistogramTest, empty)
+{
+    // --- EXPECTATIONS ---
+    EXPECT_EQ(mHistogram.getCount(), 0);
+    EXPECT_EQ(mHistogram.getMaxUs(), 0);
+    EXPECT_EQ(mHistogram.getPercentileUs(500), 0);
+}
+
+TEST_F(LatencyHistogramTest, percentilesReportUpperBinEdge)
+{
+    // --- TEST EXECUTION ---
+    // 100 samples: 0, 10, 20, ..., 990 us
+    for (uint32_t i = 0; i < 100; ++i)
+    {
+        mHistogram.add(i * 10);
+    }
+
+    // --- EXPECTATIONS ---
+    EXPECT_EQ(mHistogram.getCount(), 100);
+    EXPECT_EQ(mHistogram.getMaxUs(), 990);
+    // 50th sample is 490 us, in bin [450,500)
+    EXPECT_EQ(mHistogram.getPercentileUs(500), 500);
+    // 90th sample is 890 us, in bin [850,900)
+    EXPECT_EQ(mHistogram.getPercentileUs(900), 900);
+    // 99th sample is 980 us, but no sample is above the max
+    EXPECT_EQ(mHistogram.getPercentileUs(990), 990);
+    EXPECT_EQ(mHistogram.getPercentileUs(0), 50);
+}
+
+TEST_F(LatencyHistogramTest, overflowReportsMax)
+{
+    // --- TEST EXECUTION ---
+    const uint32_t overflowUs = LatencyHistogram::BIN_WIDTH_US * LatencyHistogram::NUM_BINS + 12345;
+    mHistogram.add(100);
+    mHistogram.add(overflowUs);
+
+    // --- EXPECTATIONS ---
+    EXPECT_EQ(mHistogram.getCount(), 2);
+    EXPECT_EQ(mHistogram.getPercentileUs(500), 150);
+    EXPECT_EQ(mHistogram.getPercentileUs(1000), overflowUs);
+    EXPECT_EQ(mHistogram.getMaxUs(), overflowUs);
+}
+
+TEST_F(LatencyHistogramTest, resetClearsBeforeNextSample)
+{
+    // --- MOCKING ---
+    mHistogram.add(5000);
+    mHistogram.add(6000);
+
+    // --- TEST EXECUTION ---
+    mHistogram.reset();
+
+    // --- EXPECTATIONS ---
+    EXPECT_EQ(mHistogram.getCount(), 0);
+    EXPECT_EQ(mHistogram.getMaxUs(), 0);
+
+    mHistogram.add(75);
+    EXPECT_EQ(mHistogram.getCount(), 1);
+    EXPECT_EQ(mHistogram.getMaxUs(), 75);
+    EXPECT_EQ(mHistogram.getPercentileUs(990), 75);
+}
@@ -54,8 +54,8 @@ class MockedDreamcastSubNode : public DreamcastSubNode
 
         MOCK_METHOD(void,
                     txComplete,
-                    (std::shared_ptr<const MaplePacket> packet,
-                        std::shared_ptr<const Transmission> tx),
+                    (const std::shared_ptr<const MaplePacket>& packet,
+                        const std::shared_ptr<const Transmission>& tx),
                     (override));
 
         MOCK_METHOD(void, task, (uint64_t currentTimeUs), (override));
@@ -135,9 +135,8 @@ class MainNodeTest : public ::testing::Test
         //! Sets up the DreamcastMainNode with mocked interfaces
         MainNodeTest() :
             mDreamcastControllerObserver(),
-            mMutex(),
-            mScreenData(mMutex),
-            mPlayerData{0, mDreamcastControllerObserver, mScreenData, mClock, mUsbFileSystem},
+            mScreenData(),
+            mPlayerData{0, mDreamcastControllerObserver, mScreenData, mClock, mUsbFileSystem, mPollSettings},
             mMapleBus(),
             mPrioritizedTxScheduler(std::make_shared<PrioritizedTxScheduler>(mMutex2, 0x00)),
             mDreamcastMainNode(mMapleBus, mPlayerData, mPrioritizedTxScheduler)
@@ -145,11 +144,11 @@ class MainNodeTest : public ::testing::Test
 
     protected:
         MockDreamcastControllerObserver mDreamcastControllerObserver;
-        MockMutex mMutex;
         MockMutex mMutex2;
         MockClock mClock;
         MockUsbFileSystem mUsbFileSystem;
         ScreenData mScreenData;
+        PollSettings mPollSettings;
         PlayerData mPlayerData;
         MockMapleBus mMapleBus;
         std::shared_ptr<PrioritizedTxScheduler> mPrioritizedTxScheduler;
@@ -281,8 +280,9 @@ TEST_F(MainNodeTest, peripheralDisconnect)
         std::make_shared<MockDreamcastPeripheral>(0x20, 0, mDreamcastMainNode.getEndpointTxScheduler(), mPlayerData.playerIndex);
     mDreamcastMainNode.getPeripherals().push_back(mockedDreamcastPeripheral);
     // This is a bad way to do it, but I need mCurrentTx in TransmissionTimeliner to be set to something
+    // (auto repeated so that each failure below has a transmission to go along with it)
     EXPECT_CALL(mMapleBus, mockWrite(_, _, _)).Times(AnyNumber()).WillRepeatedly(Return(true));
-    mDreamcastMainNode.getEndpointTxScheduler()->add(0, &mDreamcastMainNode, 123, (uint32_t*)nullptr, 0, true);
+    mDreamcastMainNode.getEndpointTxScheduler()->add(0, &mDreamcastMainNode, 123, (uint32_t*)nullptr, 0, true, 0, 1);
     mDreamcastMainNode.getTransmissionTimeliner().writeTask(0);
 
     // --- MOCKING ---
@@ -0,0 +1,266 @@
+// MIT License
+//
+// Copyright (c) 2022-2025 James Smith of OrangeFox86
+// https://github.com/OrangeFox86/DreamcastControllerUsbPico
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "MockMutex.hpp"
+#include "MockVendorStream.hpp"
+
+#include "MapleBinaryRequestHandler.hpp"
+#include "PrioritizedTxScheduler.hpp"
+#include "hal/MapleBus/MaplePacket.hpp"
+
+#include <memory>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+using ::testing::NiceMock;
+using ::testing::ElementsAre;
+using ::testing::ElementsAreArray;
+
+class MapleBinaryRequestHandlerTest : public ::testing::Test
+{
+    public:
+        MapleBinaryRequestHandlerTest() :
+            mSchedulers{
+                std::make_shared<PrioritizedTxScheduler>(mMutex, 0x00),
+                std::make_shared<PrioritizedTxScheduler>(mMutex, 0x40)},
+            mHandler(mSchedulers, SENDER_ADDRESSES, 2)
+        {}
+
+    protected:
+        //! Appends a little endian value of the given number of bytes
+        static void append(std::vector<uint8_t>& bytes, uint32_t value, uint32_t size)
+        {
+            for (uint32_t i = 0; i < size; ++i)
+            {
+                bytes.push_back((value >> (i * 8)) & 0xFF);
+            }
+        }
+
+        //! Builds a request from tag and maple words
+        static std::vector<uint8_t> request(uint16_t tag, const std::vector<uint32_t>& words)
+        {
+            std::vector<uint8_t> bytes;
+            append(bytes, tag, 2);
+            for (uint32_t word : words)
+            {
+                append(bytes, word, 4);
+            }
+            return bytes;
+        }
+
+        //! Pops the next transmission from the given scheduler
+        std::shared_ptr<Transmission> popNext(uint32_t idx)
+        {
+            PrioritizedTxScheduler::ScheduleItem item = mSchedulers[idx]->peekNext(0);
+            return mSchedulers[idx]->popItem(item);
+        }
+
+        static const uint8_t SENDER_ADDRESSES[2];
+        NiceMock<MockMutex> mMutex;
+        std::shared_ptr<PrioritizedTxScheduler> mSchedulers[2];
+        MockVendorStream mStream;
+        MapleBinaryRequestHandler mHandler;
+};
+
+const uint8_t MapleBinaryRequestHandlerTest::SENDER_ADDRESSES[2] = {0x00, 0x40};
+
+TEST_F(MapleBinaryRequestHandlerTest, requestIsScheduledOnSenderBus)
+{
+    // --- MOCKING ---
+    // Get condition (0x09) from 0x41 on behalf of 0x40 with function code payload
+    std::vector<uint8_t> req = request(0x1234, {0x09414001, 0x00000001});
+
+    // --- TEST EXECUTION ---
+    mHandler.handleRequest(req.data(), req.size(), mStream);
+
+    // --- EXPECTATIONS ---
+    EXPECT_EQ(popNext(0), nullptr);
+    std::shared_ptr<Transmission> tx = popNext(1);
+    ASSERT_NE(tx, nullptr);
+    EXPECT_EQ(tx->packet->frame.command, 0x09);
+    EXPECT_EQ(tx->packet->frame.recipientAddr, 0x41);
+    EXPECT_EQ(tx->packet->frame.senderAddr, 0x40);
+    EXPECT_THAT(tx->packet->payload, ElementsAre(0x00000001));
+    EXPECT_EQ(tx->priority, PrioritizedTxScheduler::EXTERNAL_TRANSMISSION_PRIORITY);
+    EXPECT_TRUE(tx->expectResponse);
+    EXPECT_EQ(tx->transmitter, &mHandler);
+    EXPECT_TRUE(mStream.mResponses.empty());
+    EXPECT_EQ(mHandler.getNumPending(), 1U);
+}
+
+TEST_F(MapleBinaryRequestHandlerTest, responsesCarryRequestTags)
+{
+    // --- MOCKING ---
+    std::vector<uint8_t> req1 = request(0xBEEF, {0x01200000});
+    std::vector<uint8_t> req2 = request(0x0102, {0x01204000});
+    mHandler.handleRequest(req1.data(), req1.size(), mStream);
+    mHandler.handleRequest(req2.data(), req2.size(), mStream);
+    std::shared_ptr<Transmission> tx1 = popNext(0);
+    std::shared_ptr<Transmission> tx2 = popNext(1);
+    ASSERT_NE(tx1, nullptr);
+    ASSERT_NE(tx2, nullptr);
+    uint32_t payload[2] = {0x11223344, 0xAABBCCDD};
+    std::shared_ptr<const MaplePacket> response =
+        std::make_shared<MaplePacket>(MaplePacket::Frame::fromWord(0x05004000), payload, 2);
+
+    // --- TEST EXECUTION ---
+    // Completed out of order
+    mHandler.txComplete(response, tx2);
+    mHandler.txFailed(false, true, tx1);
+
+    // --- EXPECTATIONS ---
+    ASSERT_EQ(mStream.mResponses.size(), 2U);
+    EXPECT_THAT(
+        mStream.mResponses[0],
+        ElementsAreArray(std::vector<uint8_t>{
+            0x02, 0x01,
+            MapleBinaryFrame::STATUS_COMPLETE,
+            0x02, 0x40, 0x00, 0x05,
+            0x44, 0x33, 0x22, 0x11,
+            0xDD, 0xCC, 0xBB, 0xAA}));
+    EXPECT_THAT(
+        mStream.mResponses[1],
+        ElementsAre(0xEF, 0xBE, MapleBinaryFrame::STATUS_READ_FAILED));
+    EXPECT_EQ(mHandler.getNumPending(), 0U);
+}
+
+TEST_F(MapleBinaryRequestHandlerTest, writeFailureReported)
+{
+    // --- MOCKING ---
+    std::vector<uint8_t> req = request(7, {0x01200000});
+    mHandler.handleRequest(req.data(), req.size(), mStream);
+    std::shared_ptr<Transmission> tx = popNext(0);
+    ASSERT_NE(tx, nullptr);
+
+    // --- TEST EXECUTION ---
+    mHandler.txFailed(true, false, tx);
+    // A transmission which was never requested is ignored
+    mHandler.txFailed(true, false, tx);
+
+    // --- EXPECTATIONS ---
+    ASSERT_EQ(mStream.mResponses.size(), 1U);
+    EXPECT_THAT(
+        mStream.mResponses[0],
+        ElementsAre(7, 0, MapleBinaryFrame::STATUS_WRITE_FAILED));
+}
+
+TEST_F(MapleBinaryRequestHandlerTest, requestsToRemovedDeviceAreAnswered)
+{
+    // --- MOCKING ---
+    std::vector<uint8_t> req1 = request(0x0A0B, {0x01200000});
+    std::vector<uint8_t> req2 = request(0x0C0D, {0x01010000});
+    mHandler.handleRequest(req1.data(), req1.size(), mStream);
+    mHandler.handleRequest(req2.data(), req2.size(), mStream);
+
+    // --- TEST EXECUTION ---
+    // Device at 0x20 is unplugged while its request is still queued
+    uint32_t numCanceled = mSchedulers[0]->cancelByRecipient(0x20);
+
+    // --- EXPECTATIONS ---
+    EXPECT_EQ(numCanceled, 1U);
+    ASSERT_EQ(mStream.mResponses.size(), 1U);
+    EXPECT_THAT(
+        mStream.mResponses[0],
+        ElementsAre(0x0B, 0x0A, MapleBinaryFrame::STATUS_WRITE_FAILED));
+    // Only the tag for the request still in the schedule remains
+    EXPECT_EQ(mHandler.getNumPending(), 1U);
+    std::shared_ptr<Transmission> tx = popNext(0);
+    ASSERT_NE(tx, nullptr);
+    EXPECT_EQ(tx->packet->frame.recipientAddr, 0x01);
+}
+
+TEST_F(MapleBinaryRequestHandlerTest, droppedResponseReported)
+{
+    // --- MOCKING ---
+    std::vector<uint8_t> req = request(0x0102, {0x01200000});
+    mHandler.handleRequest(req.data(), req.size(), mStream);
+    std::shared_ptr<Transmission> tx = popNext(0);
+    ASSERT_NE(tx, nullptr);
+    uint32_t payload[2] = {0x11223344, 0xAABBCCDD};
+    std::shared_ptr<const MaplePacket> response =
+        std::make_shared<MaplePacket>(MaplePacket::Frame::fromWord(0x05000020), payload, 2);
+    // Output queue only has room for a status frame
+    mStream.mMaxResponseLen = 3;
+
+    // --- TEST EXECUTION ---
+    mHandler.txComplete(response, tx);
+
+    // --- EXPECTATIONS ---
+    ASSERT_EQ(mStream.mResponses.size(), 1U);
+    EXPECT_THAT(
+        mStream.mResponses[0],
+        ElementsAre(0x02, 0x01, MapleBinaryFrame::STATUS_RESPONSE_DROPPED));
+    EXPECT_EQ(mHandler.getNumPending(), 0U);
+}
+
+TEST_F(MapleBinaryRequestHandlerTest, badRequestsRejectedImmediately)
+{
+    // --- MOCKING ---
+    std::vector<uint8_t> partialWord = request(1, {0x01200000});
+    partialWord.pop_back();
+    std::vector<uint8_t> noWords = request(2, {});
+    std::vector<uint8_t> invalidPacket = request(3, {0xFF200000});
+    std::vector<uint8_t> invalidSender = request(4, {0x01208000});
+    uint8_t noTag[1] = {5};
+
+    // --- TEST EXECUTION ---
+    mHandler.handleRequest(partialWord.data(), partialWord.size(), mStream);
+    mHandler.handleRequest(noWords.data(), noWords.size(), mStream);
+    mHandler.handleRequest(invalidPacket.data(), invalidPacket.size(), mStream);
+    mHandler.handleRequest(invalidSender.data(), invalidSender.size(), mStream);
+    mHandler.handleRequest(noTag, sizeof(noTag), mStream);
+
+    // --- EXPECTATIONS ---
+    EXPECT_EQ(popNext(0), nullptr);
+    EXPECT_EQ(popNext(1), nullptr);
+    ASSERT_EQ(mStream.mResponses.size(), 4U);
+    EXPECT_THAT(mStream.mResponses[0], ElementsAre(1, 0, MapleBinaryFrame::STATUS_MALFORMED));
+    EXPECT_THAT(mStream.mResponses[1], ElementsAre(2, 0, MapleBinaryFrame::STATUS_MALFORMED));
+    EXPECT_THAT(mStream.mResponses[2], ElementsAre(3, 0, MapleBinaryFrame::STATUS_INVALID_PACKET));
+    EXPECT_THAT(mStream.mResponses[3], ElementsAre(4, 0, MapleBinaryFrame::STATUS_INVALID_SENDER));
+}
+
+TEST(MapleBinaryRequestHandlerSingleTest, singleSenderTakesAnyAddress)
+{
+    // --- MOCKING ---
+    NiceMock<MockMutex> mutex;
+    std::shared_ptr<PrioritizedTxScheduler> schedulers[1] = {
+        std::make_shared<PrioritizedTxScheduler>(mutex, 0x00)};
+    const uint8_t senderAddresses[1] = {0x00};
+    MapleBinaryRequestHandler handler(schedulers, senderAddresses, 1);
+    MockVendorStream stream;
+    const uint8_t req[] = {0x00, 0x00, 0x00, 0xC0, 0xC1, 0x01};
+
+    // --- TEST EXECUTION ---
+    handler.handleRequest(req, sizeof(req), stream);
+
+    // --- EXPECTATIONS ---
+    PrioritizedTxScheduler::ScheduleItem item = schedulers[0]->peekNext(0);
+    std::shared_ptr<Transmission> tx = schedulers[0]->popItem(item);
+    ASSERT_NE(tx, nullptr);
+    EXPECT_EQ(tx->packet->frame.senderAddr, 0x00);
+    EXPECT_EQ(tx->packet->frame.recipientAddr, 0x01);
+    EXPECT_TRUE(stream.mResponses.empty());
+}
@@ -0,0 +1,279 @@
+// MIT License
+//
+// Copyright (c) 2022-2025 James Smith of OrangeFox86
+// https://github.com/OrangeFox86/DreamcastControllerUsbPico
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "MapleHexDecoder.hpp"
+
+#include <chrono>
+#include <random>
+#include <string>
+#include <vector>
+#include <stdio.h>
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+using ::testing::ElementsAre;
+
+// The per character decoding which MapleHexDecoder replaced
+// @returns false if a partial word was given
+static bool referenceDecode(const char* chars, uint32_t len, std::vector<uint32_t>& words)
+{
+    bool valid = false;
+    const char* const eol = chars + len;
+    const char* iter = chars;
+    while(iter < eol)
+    {
+        uint32_t word = 0;
+        uint32_t i = 0;
+        while (i < 8 && iter < eol)
+        {
+            char v = *iter++;
+            uint_fast8_t value = 0;
+
+            if (v >= '0' && v <= '9')
+            {
+                value = v - '0';
+            }
+            else if (v >= 'a' && v <= 'f')
+            {
+                value = v - 'a' + 0xa;
+            }
+            else if (v >= 'A' && v <= 'F')
+            {
+                value = v - 'A' + 0xA;
+            }
+            else
+            {
+                continue;
+            }
+
+            word |= (value << ((8 - i) * 4 - 4));
+            ++i;
+        }
+
+        valid = ((i == 8) || (i == 0));
+
+        if (i == 8)
+        {
+            words.push_back(word);
+        }
+    }
+    return valid;
+}
+
+static void expectSameAsReference(const std::string& text)
+{
+    std::vector<uint32_t> expectedWords;
+    bool expectedValid = referenceDecode(text.data(), text.size(), expectedWords);
+
+    std::vector<uint32_t> words(expectedWords.size() + 1);
+    int32_t numWords = MapleHexDecoder::decode(text.data(), text.size(), words.data(), words.size());
+
+    if (expectedValid)
+    {
+        ASSERT_EQ(numWords, (int32_t)expectedWords.size()) << text;
+        words.resize(numWords);
+        ASSERT_EQ(words, expectedWords) << text;
+    }
+    else
+    {
+        ASSERT_EQ(numWords, MapleHexDecoder::MISSING_DATA) << text;
+    }
+}
+
+//! @returns a flycast style line: each word as hex, separated by spaces
+static std::string wordsToLine(std::mt19937& rng, uint32_t numWords)
+{
+    std::string line;
+    char word[10];
+    for (uint32_t i = 0; i < numWords; ++i)
+    {
+        snprintf(word, sizeof(word), (i == 0) ? "%08lX" : " %08lx", (long unsigned int)rng());
+        line += word;
+    }
+    return line;
+}
+
+TEST(MapleHexDecoderTest, decode8AllCharacters)
+{
+    // --- TEST EXECUTION ---
+    uint32_t upper = 0;
+    bool upperValid = MapleHexDecoder::decode8("09AFaf10", upper);
+    uint32_t lower = 0;
+    bool lowerValid = MapleHexDecoder::decode8("bcdeBCDE", lower);
+
+    // --- EXPECTATIONS ---
+    EXPECT_TRUE(upperValid);
+    EXPECT_EQ(upper, 0x09AFAF10);
+    EXPECT_TRUE(lowerValid);
+    EXPECT_EQ(lower, 0xBCDEBCDE);
+}
+
+TEST(MapleHexDecoderTest, decode8RejectsEveryNonHexCharacter)
+{
+    for (uint32_t c = 0; c < 256; ++c)
+    {
+        if ((c >= '0' && c <= '9') || (c >= 'a' && c <= 'f') || (c >= 'A' && c <= 'F'))
+        {
+            continue;
+        }
+
+        for (uint32_t pos = 0; pos < 8; ++pos)
+        {
+            // --- MOCKING ---
+            char text[] = "12345678";
+            text[pos] = static_cast<char>(c);
+
+            // --- TEST EXECUTION ---
+            uint32_t word = 0;
+            bool valid = MapleHexDecoder::decode8(text, word);
+
+            // --- EXPECTATIONS ---
+            ASSERT_FALSE(valid) << c << " at " << pos;
+        }
+    }
+}
+
+TEST(MapleHexDecoderTest, skipsNonHexCharacters)
+{
+    // --- TEST EXECUTION ---
+    const char text[] = " 0102 0304-zz05060708\r";
+    uint32_t words[4];
+    int32_t numWords = MapleHexDecoder::decode(text, sizeof(text) - 1, words, 4);
+
+    // --- EXPECTATIONS ---
+    ASSERT_EQ(numWords, 2);
+    EXPECT_EQ(words[0], 0x01020304);
+    EXPECT_EQ(words[1], 0x05060708);
+}
+
+TEST(MapleHexDecoderTest, rejectsPartialWord)
+{
+    // --- TEST EXECUTION ---
+    const char text[] = "01020304 050607";
+    uint32_t words[4];
+    int32_t numWords = MapleHexDecoder::decode(text, sizeof(text) - 1, words, 4);
+
+    // --- EXPECTATIONS ---
+    EXPECT_EQ(numWords, MapleHexDecoder::MISSING_DATA);
+}
+
+TEST(MapleHexDecoderTest, emptyAndNoHex)
+{
+    // --- TEST EXECUTION ---
+    uint32_t words[4];
+    int32_t emptyNumWords = MapleHexDecoder::decode("", 0, words, 4);
+    int32_t noHexNumWords = MapleHexDecoder::decode(" \r", 2, words, 4);
+
+    // --- EXPECTATIONS ---
+    EXPECT_EQ(emptyNumWords, MapleHexDecoder::MISSING_DATA);
+    EXPECT_EQ(noHexNumWords, 0);
+}
+
+TEST(MapleHexDecoderTest, tooManyWords)
+{
+    // --- TEST EXECUTION ---
+    const char text[] = "00000001 00000002 00000003";
+    uint32_t words[2] = {};
+    int32_t numWords = MapleHexDecoder::decode(text, sizeof(text) - 1, words, 2);
+
+    // --- EXPECTATIONS ---
+    EXPECT_EQ(numWords, MapleHexDecoder::TOO_MANY_WORDS);
+    EXPECT_THAT(words, ElementsAre(1, 2));
+}
+
+TEST(MapleHexDecoderTest, matchesReferenceOnLines)
+{
+    // --- MOCKING ---
+    std::mt19937 rng(45);
+
+    for (uint32_t numWords = 0; numWords <= 256; ++numWords)
+    {
+        // --- TEST EXECUTION / EXPECTATIONS ---
+        std::string line = wordsToLine(rng, numWords);
+        expectSameAsReference(line);
+        expectSameAsReference(line + " ");
+        if (!line.empty())
+        {
+            expectSameAsReference(line.substr(0, line.size() - 1));
+        }
+    }
+}
+
+TEST(MapleHexDecoderTest, fuzzAgainstReference)
+{
+    // --- MOCKING ---
+    // Weighted towards hex characters so that many runs form whole words
+    static const char CHARS[] = "0123456789abcdefABCDEF0123456789ABCDEF     \r\t-xXgG:\x80\xff";
+    std::mt19937 rng(45);
+
+    for (uint32_t run = 0; run < 20000; ++run)
+    {
+        std::string text(rng() % 80, ' ');
+        for (char& c : text)
+        {
+            c = (rng() % 64 == 0) ? static_cast<char>(rng()) : CHARS[rng() % (sizeof(CHARS) - 1)];
+        }
+
+        // --- TEST EXECUTION / EXPECTATIONS ---
+        expectSameAsReference(text);
+    }
+}
+
+TEST(MapleHexDecoderTest, benchmarkAgainstReference)
+{
+    // --- MOCKING ---
+    // About 2 KB, like the LCD and VMU writes that flycast sends
+    const uint32_t numIterations = 2000;
+    std::mt19937 rng(45);
+    std::string line = wordsToLine(rng, 228);
+    std::vector<uint32_t> referenceWords;
+    uint32_t words[256];
+    uint32_t checksum = 0;
+
+    // --- TEST EXECUTION ---
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < numIterations; ++i)
+    {
+        referenceWords.clear();
+        referenceDecode(line.data(), line.size(), referenceWords);
+        checksum += referenceWords.size();
+    }
+    std::chrono::steady_clock::time_point middle = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < numIterations; ++i)
+    {
+        checksum += MapleHexDecoder::decode(line.data(), line.size(), words, 256);
+    }
+    std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+
+    // --- EXPECTATIONS ---
+    EXPECT_EQ(checksum, 2 * numIterations * 228);
+
+    double referenceNs = std::chrono::duration<double, std::nano>(middle - start).count();
+    double decoderNs = std::chrono::duration<double, std::nano>(end - middle).count();
+    printf("[ BENCHMARK] %lu character line: per character %.1f ns, SWAR %.1f ns (%.1fx)\n",
+           (long unsigned int)line.size(),
+           referenceNs / numIterations,
+           decoderNs / numIterations,
+           referenceNs / decoderNs);
+}
@@ -0,0 +1,170 @@
+// MIT License
+//
+// Copyright (c) 2022-2025 James Smith of OrangeFox86
+// https://github.com/OrangeFox86/DreamcastControllerUsbPico
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "MapleHexEncoder.hpp"
+
+#include <chrono>
+#include <random>
+#include <string>
+#include <stdio.h>
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+// The formatting which MapleHexEncoder replaced
+static uint32_t printfFlycast(const MaplePacket& packet, char* out, uint32_t size)
+{
+    int len = snprintf(
+        out,
+        size,
+        "%02hhX %02hhX %02hhX %02hhX",
+        packet.frame.command,
+        packet.frame.recipientAddr,
+        packet.frame.senderAddr,
+        packet.frame.length);
+
+    for (uint32_t p : packet.payload)
+    {
+        len += snprintf(out + len, size - len, " %08lX", (long unsigned int)p);
+    }
+
+    len += snprintf(out + len, size - len, "\n");
+    return len;
+}
+
+static std::string encodeFlycast(const MaplePacket& packet)
+{
+    char text[MapleHexEncoder::MAX_FLYCAST_LEN];
+    char* end = MapleHexEncoder::encodeFlycast(packet, text);
+    return std::string(text, end);
+}
+
+static MaplePacket randomPacket(std::mt19937& rng, uint32_t numPayloadWords)
+{
+    MaplePacket packet(MaplePacket::Frame::fromWord(rng()));
+    for (uint32_t i = 0; i < numPayloadWords; ++i)
+    {
+        packet.appendPayload(rng());
+    }
+    return packet;
+}
+
+TEST(MapleHexEncoderTest, encodeWord)
+{
+    // --- TEST EXECUTION ---
+    char text[8];
+    char* end = MapleHexEncoder::encodeWord(0x09AF00E1, text);
+
+    // --- EXPECTATIONS ---
+    EXPECT_EQ(std::string(text, end), "09AF00E1");
+}
+
+TEST(MapleHexEncoderTest, encodeDecimal)
+{
+    // --- TEST EXECUTION ---
+    char text[MapleHexEncoder::MAX_DECIMAL_LEN];
+    std::string zero(text, MapleHexEncoder::encodeDecimal(0, text));
+    std::string some(text, MapleHexEncoder::encodeDecimal(1203, text));
+    std::string max(text, MapleHexEncoder::encodeDecimal(0xFFFFFFFF, text));
+
+    // --- EXPECTATIONS ---
+    EXPECT_EQ(zero, "0");
+    EXPECT_EQ(some, "1203");
+    EXPECT_EQ(max, "4294967295");
+}
+
+TEST(MapleHexEncoderTest, encodeWords)
+{
+    // --- MOCKING ---
+    MaplePacket packet({.command=0x05, .recipientAddr=0x00, .senderAddr=0x20}, 0x00000001);
+    packet.appendPayload(0xABCDEF12);
+
+    // --- TEST EXECUTION ---
+    char text[MapleHexEncoder::MAX_WORDS_LEN];
+    char* end = MapleHexEncoder::encodeWords(packet, text);
+
+    // --- EXPECTATIONS ---
+    EXPECT_EQ(std::string(text, end), "05002002 00000001 ABCDEF12");
+}
+
+TEST(MapleHexEncoderTest, encodeFlycastMatchesPrintf)
+{
+    // --- MOCKING ---
+    std::mt19937 rng(44);
+
+    for (uint32_t numWords = 0; numWords <= 255; ++numWords)
+    {
+        MaplePacket packet = randomPacket(rng, numWords);
+
+        // --- TEST EXECUTION ---
+        char expected[MapleHexEncoder::MAX_FLYCAST_LEN + 1];
+        uint32_t expectedLen = printfFlycast(packet, expected, sizeof(expected));
+
+        // --- EXPECTATIONS ---
+        ASSERT_EQ(encodeFlycast(packet), std::string(expected, expectedLen)) << numWords;
+    }
+}
+
+TEST(MapleHexEncoderTest, maxFlycastLen)
+{
+    // --- MOCKING ---
+    std::mt19937 rng(44);
+    MaplePacket packet = randomPacket(rng, 255);
+
+    // --- EXPECTATIONS ---
+    EXPECT_EQ(encodeFlycast(packet).size(), MapleHexEncoder::MAX_FLYCAST_LEN);
+}
+
+TEST(MapleHexEncoderTest, benchmarkAgainstPrintf)
+{
+    // --- MOCKING ---
+    // A full VMU block read response is the worst case
+    const uint32_t numIterations = 2000;
+    std::mt19937 rng(44);
+    MaplePacket packet = randomPacket(rng, 255);
+    static char text[MapleHexEncoder::MAX_FLYCAST_LEN + 1];
+    uint32_t checksum = 0;
+
+    // --- TEST EXECUTION ---
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < numIterations; ++i)
+    {
+        checksum += printfFlycast(packet, text, sizeof(text));
+    }
+    std::chrono::steady_clock::time_point middle = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < numIterations; ++i)
+    {
+        checksum += MapleHexEncoder::encodeFlycast(packet, text) - text;
+    }
+    std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+
+    // --- EXPECTATIONS ---
+    EXPECT_EQ(checksum, 2 * numIterations * MapleHexEncoder::MAX_FLYCAST_LEN);
+
+    double printfNs = std::chrono::duration<double, std::nano>(middle - start).count();
+    double encoderNs = std::chrono::duration<double, std::nano>(end - middle).count();
+    printf("[ BENCHMARK] 255 word response: printf %.1f ns, encoder %.1f ns (%.1fx)\n",
+           printfNs / numIterations,
+           encoderNs / numIterations,
+           printfNs / encoderNs);
+}
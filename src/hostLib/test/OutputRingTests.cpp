@@ -0,0 +1,301 @@
+// MIT License
+//
+// Copyright (c) 2022-2025 James Smith of OrangeFox86
+// https://github.com/OrangeFox86/DreamcastControllerUsbPico
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "OutputRing.hpp"
+#include "MockMutex.hpp"
+
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+using ::testing::NiceMock;
+using ::testing::Return;
+using ::testing::ElementsAre;
+
+class OutputRingTest : public ::testing::Test
+{
+    public:
+        OutputRingTest() : mRing(mBuffer, sizeof(mBuffer), mMutex) {}
+
+    protected:
+        std::vector<uint8_t> readAll(uint32_t maxLen = 64)
+        {
+            std::vector<uint8_t> out(maxLen);
+            out.resize(mRing.read(out.data(), maxLen));
+            return out;
+        }
+
+        NiceMock<MockMutex> mMutex;
+        uint8_t mBuffer[8];
+        OutputRing mRing;
+};
+
+TEST_F(OutputRingTest, writeThenRead)
+{
+    // --- TEST EXECUTION ---
+    const uint8_t data[] = {1, 2, 3};
+    EXPECT_TRUE(mRing.write(data, sizeof(data)));
+
+    // --- EXPECTATIONS ---
+    EXPECT_FALSE(mRing.isEmpty());
+    EXPECT_THAT(readAll(), ElementsAre(1, 2, 3));
+    EXPECT_TRUE(mRing.isEmpty());
+    EXPECT_EQ(mRing.getDroppedCount(), 0);
+}
+
+TEST_F(OutputRingTest, partialRead)
+{
+    // --- TEST EXECUTION ---
+    const uint8_t data[] = {1, 2, 3, 4, 5};
+    mRing.write(data, sizeof(data));
+
+    // --- EXPECTATIONS ---
+    EXPECT_THAT(readAll(2), ElementsAre(1, 2));
+    EXPECT_THAT(readAll(2), ElementsAre(3, 4));
+    EXPECT_THAT(readAll(2), ElementsAre(5));
+    EXPECT_TRUE(readAll(2).empty());
+}
+
+TEST_F(OutputRingTest, wrapAround)
+{
+    // --- MOCKING ---
+    const uint8_t first[] = {1, 2, 3, 4, 5, 6};
+    mRing.write(first, sizeof(first));
+    readAll(5);
+
+    // --- TEST EXECUTION ---
+    const uint8_t second[] = {7, 8, 9, 10, 11, 12};
+    EXPECT_TRUE(mRing.write(second, sizeof(second)));
+
+    // --- EXPECTATIONS ---
+    EXPECT_THAT(readAll(), ElementsAre(6, 7, 8, 9, 10, 11, 12));
+}
+
+TEST_F(OutputRingTest, fullWriteIsDroppedWhole)
+{
+    // --- MOCKING ---
+    const uint8_t first[] = {1, 2, 3, 4, 5, 6};
+    mRing.write(first, sizeof(first));
+
+    // --- TEST EXECUTION ---
+    const uint8_t second[] = {7, 8, 9};
+    bool added = mRing.write(second, sizeof(second));
+    const uint8_t third[] = {10, 11};
+    bool thirdAdded = mRing.write(third, sizeof(third));
+
+    // --- EXPECTATIONS ---
+    EXPECT_FALSE(added);
+    EXPECT_TRUE(thirdAdded);
+    EXPECT_EQ(mRing.getDroppedCount(), 3);
+    EXPECT_THAT(readAll(), ElementsAre(1, 2, 3, 4, 5, 6, 10, 11));
+}
+
+TEST_F(OutputRingTest, dropWhenLockWouldDeadlock)
+{
+    // --- MOCKING ---
+    ON_CALL(mMutex, tryLock).WillByDefault(Return(-1));
+
+    // --- TEST EXECUTION ---
+    const uint8_t data[] = {1};
+    bool added = mRing.write(data, sizeof(data));
+
+    // --- EXPECTATIONS ---
+    EXPECT_FALSE(added);
+    EXPECT_TRUE(mRing.isEmpty());
+}
+
+class OutputRingTextTest : public ::testing::Test
+{
+    public:
+        OutputRingTextTest() : mRing(mBuffer, sizeof(mBuffer), mMutex, 8) {}
+
+    protected:
+        bool writeText(const std::string& text)
+        {
+            return mRing.writeText(reinterpret_cast<const uint8_t*>(text.data()), text.size());
+        }
+
+        std::string readAll()
+        {
+            uint8_t out[32];
+            uint32_t len = mRing.read(out, sizeof(out));
+            return std::string(reinterpret_cast<const char*>(out), len);
+        }
+
+        NiceMock<MockMutex> mMutex;
+        uint8_t mBuffer[16];
+        OutputRing mRing;
+};
+
+TEST_F(OutputRingTextTest, lineWrittenInPieces)
+{
+    // --- TEST EXECUTION ---
+    // The way stdio writes a line with CRLF translation
+    EXPECT_TRUE(writeText("ok"));
+    EXPECT_TRUE(writeText("\r\n"));
+    EXPECT_TRUE(writeText("a\nb\n"));
+
+    // --- EXPECTATIONS ---
+    EXPECT_EQ(readAll(), "ok\r\na\nb\n");
+    EXPECT_EQ(mRing.getDroppedCount(), 0);
+}
+
+TEST_F(OutputRingTextTest, lineNotStartedWithoutReserveIsDroppedWhole)
+{
+    // --- MOCKING ---
+    const uint8_t raw[8] = {1, 2, 3, 4, 5, 6, 7, 8};
+    mRing.write(raw, sizeof(raw));
+
+    // --- TEST EXECUTION ---
+    // Each piece would fit, but the line couldn't be started with room for the rest of it
+    bool added1 = writeText("ab");
+    bool added2 = writeText("cd");
+    bool added3 = writeText("\r\n");
+    std::string out = readAll();
+    bool added4 = writeText("ef\r\n");
+
+    // --- EXPECTATIONS ---
+    EXPECT_FALSE(added1);
+    EXPECT_FALSE(added2);
+    EXPECT_FALSE(added3);
+    EXPECT_TRUE(added4);
+    EXPECT_EQ(out, std::string(reinterpret_cast<const char*>(raw), sizeof(raw)));
+    EXPECT_EQ(readAll(), "ef\r\n");
+    EXPECT_EQ(mRing.getDroppedCount(), 6);
+}
+
+TEST_F(OutputRingTextTest, startedLineIsFinished)
+{
+    // --- MOCKING ---
+    const uint8_t raw[7] = {1, 2, 3, 4, 5, 6, 7};
+    mRing.write(raw, sizeof(raw));
+
+    // --- TEST EXECUTION ---
+    bool added1 = writeText("abc");
+    bool added2 = writeText("def");
+    bool added3 = writeText("\r\n");
+
+    // --- EXPECTATIONS ---
+    EXPECT_TRUE(added1);
+    EXPECT_TRUE(added2);
+    EXPECT_TRUE(added3);
+    EXPECT_EQ(readAll().substr(sizeof(raw)), "abcdef\r\n");
+    EXPECT_EQ(mRing.getDroppedCount(), 0);
+}
+
+TEST_F(OutputRingTextTest, lineLongerThanReserveIsTerminated)
+{
+    // --- TEST EXECUTION ---
+    writeText("abcdefgh");
+    bool added = writeText("ijklmnop");
+    writeText("\r\n");
+    writeText("x\n");
+
+    // --- EXPECTATIONS ---
+    EXPECT_FALSE(added);
+    // Cut short, but the following line is intact
+    EXPECT_EQ(readAll(), "abcdefgh\nx\n");
+    EXPECT_EQ(mRing.getDroppedCount(), 10);
+}
+
+class OutputRingLineTest : public ::testing::Test
+{
+    public:
+        OutputRingLineTest() : mRing(mBuffer, sizeof(mBuffer), mMutex, 0, 96, "\r\n") {}
+
+    protected:
+        bool writeLine(const std::string& text)
+        {
+            return mRing.writeLine(text.data(), text.size());
+        }
+
+        std::string readAll()
+        {
+            uint8_t out[256];
+            uint32_t len = mRing.read(out, sizeof(out));
+            return std::string(reinterpret_cast<const char*>(out), len);
+        }
+
+        NiceMock<MockMutex> mMutex;
+        uint8_t mBuffer[256];
+        OutputRing mRing;
+};
+
+TEST_F(OutputRingLineTest, lineEndIsAdded)
+{
+    // --- TEST EXECUTION ---
+    bool added1 = writeLine("abc");
+    bool added2 = writeLine("");
+
+    // --- EXPECTATIONS ---
+    EXPECT_TRUE(added1);
+    EXPECT_TRUE(added2);
+    EXPECT_EQ(readAll(), "abc\r\n\r\n");
+}
+
+TEST_F(OutputRingLineTest, longLineDroppedWholeButShortLineUsesReserve)
+{
+    // --- MOCKING ---
+    // Leaves 60 bytes before the reserve
+    mRing.write(std::vector<uint8_t>(100, 'x').data(), 100);
+    std::string longLine(70, 'y');
+    std::string shortLine("@1 *failed dropped");
+
+    // --- TEST EXECUTION ---
+    bool longAdded = writeLine(longLine);
+    bool shortAdded = writeLine(shortLine);
+
+    // --- EXPECTATIONS ---
+    EXPECT_FALSE(longAdded);
+    EXPECT_TRUE(shortAdded);
+    EXPECT_EQ(readAll(), std::string(100, 'x') + shortLine + "\r\n");
+    EXPECT_EQ(mRing.getDroppedCount(), 72);
+}
+
+TEST_F(OutputRingLineTest, reserveIsKeptFromOtherWrites)
+{
+    // --- TEST EXECUTION ---
+    bool rawAdded = mRing.write(std::vector<uint8_t>(161, 'x').data(), 161);
+    bool textAdded = mRing.writeText(reinterpret_cast<const uint8_t*>("ab\n"), 3);
+
+    // --- EXPECTATIONS ---
+    EXPECT_FALSE(rawAdded);
+    EXPECT_TRUE(textAdded);
+    EXPECT_EQ(readAll(), "ab\n");
+}
+
+TEST_F(OutputRingLineTest, longestLine)
+{
+    // --- TEST EXECUTION ---
+    uint32_t maxLen = mRing.getMaxLineLength();
+    bool tooLongAdded = writeLine(std::string(maxLen + 1, 'z'));
+    bool longestAdded = writeLine(std::string(maxLen, 'z'));
+
+    // --- EXPECTATIONS ---
+    EXPECT_EQ(maxLen, 256U - 96U - 2U);
+    EXPECT_FALSE(tooLongAdded);
+    EXPECT_TRUE(longestAdded);
+    EXPECT_EQ(readAll(), std::string(maxLen, 'z') + "\r\n");
+}
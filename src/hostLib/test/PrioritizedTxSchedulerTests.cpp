@@ -37,6 +37,8 @@ using ::testing::_;
 using ::testing::Return;
 using ::testing::SetArgReferee;
 using ::testing::DoAll;
+using ::testing::Pointee;
+using ::testing::Field;
 
 class PrioritizedTxSchedulerUnitTest : public PrioritizedTxScheduler
 {
@@ -582,3 +584,30 @@ TEST_F(TransmissionScheduleCancelTest, cancelAll)
     ASSERT_EQ(schedule.size(), 256);
     ASSERT_EQ(schedule[255].size(), 0);
 }
+
+TEST_F(TransmissionScheduleTest, cancelByRecipientNotifiesExternalTransmitters)
+{
+    // --- MOCKING ---
+    MockDreamcastPeripheral external(0x01, 0, nullptr, 0);
+    MockDreamcastPeripheral peripheral(0x01, 0, nullptr, 0);
+    MaplePacket packet1({.command=0x11, .recipientAddr=0x01}, 0x99887766);
+    MaplePacket packet2({.command=0x22, .recipientAddr=0x01}, 0x99887766);
+    uint32_t externalId = scheduler.add(PrioritizedTxScheduler::EXTERNAL_TRANSMISSION_PRIORITY,
+                                        PrioritizedTxScheduler::TX_TIME_ASAP,
+                                        &external,
+                                        packet1,
+                                        true);
+    scheduler.add(PrioritizedTxScheduler::MAIN_TRANSMISSION_PRIORITY,
+                  PrioritizedTxScheduler::TX_TIME_ASAP,
+                  &peripheral,
+                  packet2,
+                  true);
+
+    // --- EXPECTATIONS ---
+    EXPECT_CALL(external, txFailed(true, false, Pointee(Field(&Transmission::transmissionId, externalId))))
+        .Times(1);
+    EXPECT_CALL(peripheral, txFailed(_, _, _)).Times(0);
+
+    // --- TEST EXECUTION ---
+    EXPECT_EQ(scheduler.cancelByRecipient(0x01), 2);
+}
@@ -0,0 +1,82 @@
+// MIT License
+//
+// Copyright (c) 2022-2025 James Smith of OrangeFox86
+// https://github.com/OrangeFox86/DreamcastControllerUsbPico
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "ScreenData.hpp"
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+class ScreenDataTest : public ::testing::Test
+{
+    public:
+        ScreenDataTest() : mScreenData() {}
+
+    protected:
+        ScreenData mScreenData;
+};
+
+TEST_F(ScreenDataTest, defaultIsAvailableOnInit)
+{
+    // --- EXPECTATIONS ---
+    EXPECT_TRUE(mScreenData.isNewDataAvailable());
+    uint32_t out[ScreenData::NUM_SCREEN_WORDS];
+    mScreenData.readData(out);
+    EXPECT_FALSE(mScreenData.isNewDataAvailable());
+}
+
+TEST_F(ScreenDataTest, partialSetKeepsRemainingWords)
+{
+    // --- MOCKING ---
+    uint32_t words[ScreenData::NUM_SCREEN_WORDS];
+    for (uint32_t i = 0; i < ScreenData::NUM_SCREEN_WORDS; ++i)
+    {
+        words[i] = i;
+    }
+    mScreenData.setData(words);
+    uint32_t update[2] = {0x11111111, 0x22222222};
+
+    // --- TEST EXECUTION ---
+    mScreenData.setData(update, 10, 2);
+    uint32_t out[ScreenData::NUM_SCREEN_WORDS];
+    uint32_t generation = mScreenData.readData(out);
+
+    // --- EXPECTATIONS ---
+    // 1 for initialization plus 2 sets
+    EXPECT_EQ(generation, 3);
+    for (uint32_t i = 0; i < ScreenData::NUM_SCREEN_WORDS; ++i)
+    {
+        if (i == 10)
+        {
+            EXPECT_EQ(out[i], 0x11111111);
+        }
+        else if (i == 11)
+        {
+            EXPECT_EQ(out[i], 0x22222222);
+        }
+        else
+        {
+            EXPECT_EQ(out[i], i);
+        }
+    }
+    EXPECT_FALSE(mScreenData.isNewDataAvailable());
+}
@@ -95,9 +95,8 @@ class SubNodeTest : public ::testing::Test
         //! Sets up the DreamcastMainNode with mocked interfaces
         SubNodeTest() :
             mDreamcastControllerObserver(),
-            mMutex(),
-            mScreenData(mMutex),
-            mPlayerData{1, mDreamcastControllerObserver, mScreenData, mClock, mUsbFileSystem},
+            mScreenData(),
+            mPlayerData{1, mDreamcastControllerObserver, mScreenData, mClock, mUsbFileSystem, mPollSettings},
             mPrioritizedTxScheduler(std::make_shared<PrioritizedTxScheduler>(mMutex2, 0x00)),
             mEndpointTxScheduler(std::make_shared<EndpointTxScheduler>(
                 mPrioritizedTxScheduler, 0, DreamcastPeripheral::getRecipientAddress(1, 0x01))),
@@ -106,11 +105,11 @@ class SubNodeTest : public ::testing::Test
 
     protected:
         MockDreamcastControllerObserver mDreamcastControllerObserver;
-        MockMutex mMutex;
         MockMutex mMutex2;
         MockClock mClock;
         MockUsbFileSystem mUsbFileSystem;
         ScreenData mScreenData;
+        PollSettings mPollSettings;
         PlayerData mPlayerData;
         std::shared_ptr<PrioritizedTxScheduler> mPrioritizedTxScheduler;
         std::shared_ptr<EndpointTxScheduler> mEndpointTxScheduler;
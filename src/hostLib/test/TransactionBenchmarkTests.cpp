@@ -0,0 +1,165 @@
+// MIT License
+//
+// Copyright (c) 2022-2025 James Smith of OrangeFox86
+// https://github.com/OrangeFox86/DreamcastControllerUsbPico
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "TransmissionTimeliner.hpp"
+#include "PrioritizedTxScheduler.hpp"
+#include "Transmitter.hpp"
+#include "hal/System/MutexInterface.hpp"
+
+#include <chrono>
+#include <memory>
+#include <stdio.h>
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+// gmock call recording would dominate the measurement, so light fakes are used here instead
+
+class BenchmarkMutex : public MutexInterface
+{
+    public:
+        void lock() override {}
+        void unlock() override {}
+        int8_t tryLock() override { return 1; }
+};
+
+//! Completes every write immediately with a canned 4 word response on the next processEvents()
+class BenchmarkMapleBus : public MapleBusInterface
+{
+    public:
+        BenchmarkMapleBus() : mPending(false), mResponse{0x03002001, 0x00000001, 0, 0} {}
+
+        bool write(const MaplePacket& packet,
+                   bool autostartRead,
+                   uint64_t readTimeoutUs=MAPLE_RESPONSE_TIMEOUT_US) override
+        {
+            mPending = true;
+            return true;
+        }
+
+        Status processEvents(uint64_t currentTimeUs) override
+        {
+            Status status;
+            if (mPending)
+            {
+                mPending = false;
+                status.phase = Phase::READ_COMPLETE;
+                status.readBuffer = mResponse;
+                status.readBufferLen = sizeof(mResponse) / sizeof(mResponse[0]);
+            }
+            else
+            {
+                status.phase = Phase::IDLE;
+            }
+            return status;
+        }
+
+        bool isBusy() override { return mPending; }
+
+        bool startRead(uint64_t readTimeoutUs) override { return true; }
+
+    private:
+        bool mPending;
+        uint32_t mResponse[4];
+};
+
+class CountingTransmitter : public Transmitter
+{
+    public:
+        CountingTransmitter() : mStarted(0), mFailed(0), mCompleted(0) {}
+
+        void txStarted(const std::shared_ptr<const Transmission>& tx) override
+        {
+            ++mStarted;
+        }
+
+        void txFailed(bool writeFailed,
+                      bool readFailed,
+                      const std::shared_ptr<const Transmission>& tx) override
+        {
+            ++mFailed;
+        }
+
+        void txComplete(const std::shared_ptr<const MaplePacket>& packet,
+                        const std::shared_ptr<const Transmission>& tx) override
+        {
+            ++mCompleted;
+        }
+
+        uint32_t mStarted;
+        uint32_t mFailed;
+        uint32_t mCompleted;
+};
+
+TEST(TransactionBenchmark, perTransactionOverhead)
+{
+    // --- MOCKING ---
+    const uint32_t numTransactions = 100000;
+    BenchmarkMutex mutex;
+    BenchmarkMapleBus bus;
+    std::shared_ptr<PrioritizedTxScheduler> scheduler =
+        std::make_shared<PrioritizedTxScheduler>(mutex, 0x00);
+    TransmissionTimeliner timeliner(bus, scheduler);
+    CountingTransmitter transmitter;
+    // Recurring condition request, just like a controller
+    MaplePacket packet({.command=0x09, .recipientAddr=0x20}, 0x00000001);
+    scheduler->add(PrioritizedTxScheduler::MAIN_TRANSMISSION_PRIORITY,
+                   PrioritizedTxScheduler::TX_TIME_ASAP,
+                   &transmitter,
+                   packet,
+                   true,
+                   3,
+                   1);
+
+    // --- TEST EXECUTION ---
+    // Dispatch the same way DreamcastMainNode does
+    uint64_t timeUs = 0;
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < numTransactions; ++i)
+    {
+        std::shared_ptr<const Transmission> sentTx = timeliner.writeTask(timeUs);
+        if (sentTx != nullptr && sentTx->transmitter != nullptr)
+        {
+            sentTx->transmitter->txStarted(sentTx);
+        }
+
+        TransmissionTimeliner::ReadStatus readStatus = timeliner.readTask(++timeUs);
+        if (readStatus.transmission != nullptr && readStatus.transmission->transmitter != nullptr)
+        {
+            readStatus.transmission->transmitter->txComplete(readStatus.received,
+                                                             readStatus.transmission);
+        }
+        ++timeUs;
+    }
+    std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+
+    // --- EXPECTATIONS ---
+    EXPECT_EQ(transmitter.mStarted, numTransactions);
+    EXPECT_EQ(transmitter.mCompleted, numTransactions);
+    EXPECT_EQ(transmitter.mFailed, 0);
+
+    double totalNs = std::chrono::duration<double, std::nano>(end - start).count();
+    printf("[ BENCHMARK] %.1f ns per transaction over %lu transactions\n",
+           totalNs / numTransactions,
+           (long unsigned int)numTransactions);
+}
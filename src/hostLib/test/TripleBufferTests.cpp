@@ -0,0 +1,131 @@
+// MIT License
+//
+// Copyright (c) 2022-2025 James Smith of OrangeFox86
+// https://github.com/OrangeFox86/DreamcastControllerUsbPico
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "TripleBuffer.hpp"
+
+#include <thread>
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+struct TestData
+{
+    uint32_t a;
+    uint32_t b;
+    uint32_t c;
+};
+
+class TripleBufferTest : public ::testing::Test
+{
+    public:
+        TripleBufferTest() : mBuffer(TestData{1, 2, 3}) {}
+
+    protected:
+        TripleBuffer<TestData> mBuffer;
+};
+
+TEST_F(TripleBufferTest, initialValue)
+{
+    // --- EXPECTATIONS ---
+    EXPECT_FALSE(mBuffer.isNewDataAvailable());
+    const TestData& data = mBuffer.read();
+    EXPECT_EQ(data.a, 1);
+    EXPECT_EQ(data.b, 2);
+    EXPECT_EQ(data.c, 3);
+    EXPECT_EQ(mBuffer.getReadGeneration(), 0);
+}
+
+TEST_F(TripleBufferTest, readLatestOnly)
+{
+    // --- TEST EXECUTION ---
+    mBuffer.write(TestData{4, 5, 6});
+    mBuffer.write(TestData{7, 8, 9});
+
+    // --- EXPECTATIONS ---
+    EXPECT_TRUE(mBuffer.isNewDataAvailable());
+    EXPECT_EQ(mBuffer.getLatestGeneration(), 2);
+    const TestData& data = mBuffer.read();
+    EXPECT_EQ(data.a, 7);
+    EXPECT_EQ(data.b, 8);
+    EXPECT_EQ(data.c, 9);
+    EXPECT_EQ(mBuffer.getReadGeneration(), 2);
+    EXPECT_FALSE(mBuffer.isNewDataAvailable());
+}
+
+TEST_F(TripleBufferTest, writerNeverTouchesReadBuffer)
+{
+    // --- TEST EXECUTION ---
+    mBuffer.write(TestData{4, 5, 6});
+    const TestData& data = mBuffer.read();
+    // Publish many times while the reader holds its reference
+    for (uint32_t i = 0; i < 10; ++i)
+    {
+        TestData& out = mBuffer.getWriteBuffer();
+        EXPECT_NE(&out, &data);
+        out = TestData{i, i, i};
+        mBuffer.publish();
+    }
+
+    // --- EXPECTATIONS ---
+    EXPECT_EQ(data.a, 4);
+    EXPECT_EQ(data.b, 5);
+    EXPECT_EQ(data.c, 6);
+    EXPECT_EQ(mBuffer.read().a, 9);
+}
+
+TEST_F(TripleBufferTest, concurrentReadsAreNeverTorn)
+{
+    // --- TEST EXECUTION ---
+    const uint32_t numWrites = 200000;
+    mBuffer.write(TestData{0, 0, 0});
+    std::thread writer([this, numWrites]()
+    {
+        for (uint32_t i = 1; i <= numWrites; ++i)
+        {
+            mBuffer.write(TestData{i, i, i});
+        }
+    });
+
+    uint32_t torn = 0;
+    uint32_t lastValue = 0;
+    uint32_t regressions = 0;
+    while (lastValue < numWrites)
+    {
+        const TestData& data = mBuffer.read();
+        if (data.a != data.b || data.b != data.c)
+        {
+            ++torn;
+        }
+        if (data.a < lastValue)
+        {
+            ++regressions;
+        }
+        lastValue = data.a;
+    }
+    writer.join();
+
+    // --- EXPECTATIONS ---
+    EXPECT_EQ(torn, 0);
+    EXPECT_EQ(regressions, 0);
+    EXPECT_EQ(mBuffer.getReadGeneration(), numWrites + 1);
+}
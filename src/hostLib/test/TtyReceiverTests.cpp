@@ -0,0 +1,208 @@
+// MIT License
+//
+// Copyright (c) 2022-2025 James Smith of OrangeFox86
+// https://github.com/OrangeFox86/DreamcastControllerUsbPico
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "TtyReceiver.hpp"
+
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+//! Everything echoed back by the receiver under test
+static std::string echoed;
+
+static void captureEcho(const uint8_t* data, uint32_t len)
+{
+    echoed.append(reinterpret_cast<const char*>(data), len);
+}
+
+class TtyReceiverTest : public ::testing::Test
+{
+    public:
+        TtyReceiverTest() : mReceiver(captureEcho)
+        {
+            echoed.clear();
+        }
+
+    protected:
+        void add(const std::string& chars)
+        {
+            mReceiver.addChars(chars.data(), chars.size());
+        }
+
+        //! @returns a binary frame with the given content
+        static std::string frame(const std::string& content)
+        {
+            std::string f;
+            f.push_back(content.size() & 0xFF);
+            f.push_back((content.size() >> 8) & 0xFF);
+            return f + content;
+        }
+
+        //! Takes the next command, prefixing text with "T:" and frames with "F:"
+        std::string take()
+        {
+            CommandRing::Item item;
+            const char* chars = nullptr;
+            if (!mReceiver.peek(item, chars))
+            {
+                return std::string("<none>");
+            }
+            std::string s = (item.isFrame ? "F:" : "T:") + std::string(chars, item.len);
+            mReceiver.release();
+            return s;
+        }
+
+        TtyReceiver mReceiver;
+};
+
+TEST_F(TtyReceiverTest, textCommandsAreEchoed)
+{
+    // --- TEST EXECUTION ---
+    add("X ab\x08" "c\r\n\n Y\n");
+
+    // --- EXPECTATIONS ---
+    EXPECT_EQ(echoed, "X ab\x08" "c\r\n\n Y\n");
+    EXPECT_EQ(take(), "T:X ac");
+    EXPECT_EQ(take(), "T: Y");
+    EXPECT_EQ(take(), "<none>");
+    EXPECT_FALSE(mReceiver.isBinaryMode());
+}
+
+TEST_F(TtyReceiverTest, switchToBinaryMode)
+{
+    // --- TEST EXECUTION ---
+    // Frame which follows the mode command in the same chunk, then one split across chunks
+    add("#B\n" + frame("Xab") + "\x02");
+    add(std::string("\0Y", 2));
+    add("z");
+
+    // --- EXPECTATIONS ---
+    EXPECT_TRUE(mReceiver.isBinaryMode());
+    // Binary data is never echoed
+    EXPECT_EQ(echoed, "#B\n");
+    // Switch is acknowledged in order with everything else
+    EXPECT_EQ(take(), "F:#");
+    EXPECT_EQ(take(), "F:Xab");
+    EXPECT_EQ(take(), "F:Yz");
+    EXPECT_EQ(take(), "<none>");
+}
+
+TEST_F(TtyReceiverTest, modeFrameSwitchesBackToText)
+{
+    // --- MOCKING ---
+    add("#B\n");
+    EXPECT_EQ(take(), "F:#");
+
+    // --- TEST EXECUTION ---
+    add(frame("#") + "A\n");
+    add("B\n");
+
+    // --- EXPECTATIONS ---
+    EXPECT_FALSE(mReceiver.isBinaryMode());
+    // Text following a frame in the same chunk isn't echoed, but following chunks are
+    EXPECT_EQ(echoed, "#B\nB\n");
+    // The consumer is told about the switch before the text which follows it
+    EXPECT_EQ(take(), "F:#T");
+    EXPECT_EQ(take(), "T:A");
+    EXPECT_EQ(take(), "T:B");
+    EXPECT_EQ(take(), "<none>");
+}
+
+TEST_F(TtyReceiverTest, truncatedFrameDroppedOnReset)
+{
+    // --- MOCKING ---
+    add("#B\n" + frame("Xa"));
+    EXPECT_EQ(take(), "F:#");
+    // Only part of this frame arrives before the host goes away
+    add(std::string("\x05\x00Yb", 4));
+
+    // --- TEST EXECUTION ---
+    mReceiver.resetMode();
+    add("Z\n");
+
+    // --- EXPECTATIONS ---
+    EXPECT_FALSE(mReceiver.isBinaryMode());
+    EXPECT_EQ(take(), "F:Xa");
+    EXPECT_EQ(take(), "F:#R");
+    EXPECT_EQ(take(), "T:Z");
+    EXPECT_EQ(take(), "<none>");
+}
+
+TEST_F(TtyReceiverTest, resetInTextModeKeepsCommands)
+{
+    // --- TEST EXECUTION ---
+    add("X\n");
+    mReceiver.resetMode();
+
+    // --- EXPECTATIONS ---
+    EXPECT_FALSE(mReceiver.isBinaryMode());
+    EXPECT_EQ(take(), "T:X");
+    EXPECT_EQ(take(), "F:#R");
+    EXPECT_EQ(take(), "<none>");
+}
+
+TEST_F(TtyReceiverTest, resetWaitsForRoomWhenFull)
+{
+    // --- MOCKING ---
+    const uint32_t maxItems = CommandRing::MAX_ITEMS;
+    for (uint32_t i = 0; i < maxItems; ++i)
+    {
+        add("X\n");
+    }
+
+    // --- TEST EXECUTION ---
+    mReceiver.resetMode();
+    for (uint32_t i = 0; i < maxItems; ++i)
+    {
+        EXPECT_EQ(take(), "T:X");
+    }
+    EXPECT_EQ(take(), "<none>");
+    add("Y\n");
+
+    // --- EXPECTATIONS ---
+    // The reset is never lost, and it still comes before anything received after it
+    EXPECT_EQ(take(), "F:#R");
+    EXPECT_EQ(take(), "T:Y");
+    EXPECT_EQ(take(), "<none>");
+}
+
+TEST_F(TtyReceiverTest, frameTooLargeReportsErrorFrame)
+{
+    // --- MOCKING ---
+    add("#B\n");
+    EXPECT_EQ(take(), "F:#");
+    std::string tooLarge = frame("Q" + std::string(CommandRing::MAX_QUEUE_SIZE, 'q'));
+
+    // --- TEST EXECUTION ---
+    add(tooLarge);
+    add(frame("Xa"));
+
+    // --- EXPECTATIONS ---
+    // The host is told which command was dropped, and framing stays in sync
+    EXPECT_TRUE(mReceiver.isBinaryMode());
+    EXPECT_EQ(take(), "F:!Q");
+    EXPECT_EQ(take(), "F:Xa");
+    EXPECT_EQ(take(), "<none>");
+}
@@ -31,7 +31,7 @@
 class MockDreamcastControllerObserver : public DreamcastControllerObserver
 {
     public:
-        MOCK_METHOD(void, setControllerCondition, (const ControllerCondition& controllerCondition), (override));
+        MOCK_METHOD(void, setControllerCondition, (const ControllerCondition& controllerCondition, uint64_t receivedTimeUs), (override));
 
         MOCK_METHOD(void, controllerConnected, (), (override));
 
@@ -38,19 +38,19 @@ class MockDreamcastPeripheral : public DreamcastPeripheral
             DreamcastPeripheral("mock", addr, fd, scheduler, playerIndex)
         {}
 
-        MOCK_METHOD(void, txStarted, (std::shared_ptr<const Transmission> tx), (override));
+        MOCK_METHOD(void, txStarted, (const std::shared_ptr<const Transmission>& tx), (override));
 
         MOCK_METHOD(void,
                     txFailed,
                     (bool writeFailed,
                           bool readFailed,
-                          std::shared_ptr<const Transmission> tx),
+                          const std::shared_ptr<const Transmission>& tx),
                     (override));
 
         MOCK_METHOD(void,
                     txComplete,
-                    (std::shared_ptr<const MaplePacket> packet,
-                        std::shared_ptr<const Transmission> tx),
+                    (const std::shared_ptr<const MaplePacket>& packet,
+                        const std::shared_ptr<const Transmission>& tx),
                     (override));
 
         MOCK_METHOD(void, task, (uint64_t currentTimeUs), (override));
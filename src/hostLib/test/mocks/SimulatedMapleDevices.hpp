@@ -0,0 +1,286 @@
+// MIT License
+//
+// Copyright (c) 2022-2025 James Smith of OrangeFox86
+// https://github.com/OrangeFox86/DreamcastControllerUsbPico
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include "DreamcastPeripheral.hpp"
+#include "dreamcast_constants.h"
+#include "hal/MapleBus/MapleBusInterface.hpp"
+#include "hal/MapleBus/MaplePacket.hpp"
+#include "hal/System/ClockInterface.hpp"
+#include "hal/System/MutexInterface.hpp"
+#include "hal/Usb/DreamcastControllerObserver.hpp"
+
+#include <atomic>
+#include <mutex>
+#include <string.h>
+
+// These are light fakes rather than gmock mocks so that they may be hammered every cycle
+
+//! Clock which may be advanced by the test and read from another thread
+class SimulatedClock : public ClockInterface
+{
+    public:
+        SimulatedClock() : mTimeUs(0) {}
+
+        uint64_t getTimeUs() const override
+        {
+            return mTimeUs.load();
+        }
+
+        void advance(uint64_t us)
+        {
+            mTimeUs.store(mTimeUs.load() + us);
+        }
+
+    private:
+        std::atomic<uint64_t> mTimeUs;
+};
+
+//! Real mutex for tests which run the maple side and the USB side on separate threads
+//! Recursive since the scheduler re-locks when auto repeating an item, which the firmware mutex
+//! tolerates by reporting a would-be deadlock
+class StdMutex : public MutexInterface
+{
+    public:
+        void lock() override { mMutex.lock(); }
+        void unlock() override { mMutex.unlock(); }
+        int8_t tryLock() override { return mMutex.try_lock() ? 1 : 0; }
+
+    private:
+        std::recursive_mutex mMutex;
+};
+
+//! Accepts all controller updates without recording them
+class NullControllerObserver : public DreamcastControllerObserver
+{
+    public:
+        void setControllerCondition(const ControllerCondition& controllerCondition,
+                                    uint64_t receivedTimeUs) override {}
+        void setSecondaryControllerCondition(
+            const SecondaryControllerCondition& secondaryControllerCondition) override {}
+        void controllerConnected() override {}
+        void controllerDisconnected() override {}
+};
+
+//! Simulates a controller with a VMU in its upper slot; responds to every write on next poll
+class SimulatedControllerWithVmu : public MapleBusInterface
+{
+    public:
+        SimulatedControllerWithVmu() :
+            mControllerAttached(true),
+            mVmuAttached(true),
+            mLineNoise(false),
+            mMainFunctionCode(DEVICE_FN_CONTROLLER),
+            mMainFunctionDefinition(0x000F06FE),
+            mWriteCount(0),
+            mCommandCounts{},
+            mPending(false),
+            mResponse{},
+            mResponseLen(0)
+        {}
+
+        //! Garbles the response to the next write (a device being plugged in may do this)
+        void injectLineNoise()
+        {
+            mLineNoise = true;
+        }
+
+        //! Replaces the controller with a different single function main peripheral
+        void setMainPeripheral(uint32_t functionCode, uint32_t functionDefinition)
+        {
+            mMainFunctionCode = functionCode;
+            mMainFunctionDefinition = functionDefinition;
+        }
+
+        //! @returns number of packets written to this bus
+        uint32_t getWriteCount() const
+        {
+            return mWriteCount;
+        }
+
+        //! @returns number of packets written to this bus with the given command
+        uint32_t getCommandCount(uint8_t command) const
+        {
+            return mCommandCounts[command];
+        }
+
+        //! Plugs or unplugs the controller (and the VMU along with it)
+        void setControllerAttached(bool attached)
+        {
+            mControllerAttached = attached;
+        }
+
+        //! Inserts or removes the VMU from the controller
+        void setVmuAttached(bool attached)
+        {
+            mVmuAttached = attached;
+        }
+
+        bool write(const MaplePacket& packet,
+                   bool autostartRead,
+                   uint64_t readTimeoutUs=MAPLE_RESPONSE_TIMEOUT_US) override
+        {
+            ++mWriteCount;
+            ++mCommandCounts[packet.frame.command];
+            const uint8_t recipientAddr = packet.frame.recipientAddr;
+            const uint8_t hostAddr = recipientAddr & 0xC0;
+            const uint8_t deviceAddr = recipientAddr & 0x3F;
+            if (mLineNoise
+                || !mControllerAttached
+                || (deviceAddr != DreamcastPeripheral::MAIN_PERIPHERAL_ADDR_MASK && !mVmuAttached))
+            {
+                // Nothing answers - the read times out
+                mPending = true;
+                mResponseLen = 0;
+                return true;
+            }
+
+            uint8_t senderAddr = recipientAddr;
+            if (deviceAddr == DreamcastPeripheral::MAIN_PERIPHERAL_ADDR_MASK && mVmuAttached)
+            {
+                // VMU is attached to the first sub peripheral slot
+                senderAddr |= DreamcastPeripheral::SUB_PERIPHERAL_ADDR_START_MASK;
+            }
+
+            uint32_t* payload = &mResponse[1];
+            uint8_t command = COMMAND_RESPONSE_ACK;
+            uint8_t len = 0;
+            switch (packet.frame.command)
+            {
+                case COMMAND_DEVICE_INFO_REQUEST:
+                {
+                    command = COMMAND_RESPONSE_DEVICE_INFO;
+                    len = EXPECTED_DEVICE_INFO_PAYLOAD_WORDS;
+                    memset(payload, 0, len * sizeof(uint32_t));
+                    if (deviceAddr == DreamcastPeripheral::MAIN_PERIPHERAL_ADDR_MASK)
+                    {
+                        payload[0] = mMainFunctionCode;
+                        payload[1] = mMainFunctionDefinition;
+                    }
+                    else
+                    {
+                        // Function definitions ordered from highest function bit
+                        payload[0] = DEVICE_FN_STORAGE | DEVICE_FN_LCD | DEVICE_FN_TIMER;
+                        payload[1] = 0x7E7E3F40;
+                        payload[2] = 0x00051000;
+                        payload[3] = 0x000F4100;
+                    }
+                }
+                break;
+
+                case COMMAND_GET_CONDITION:
+                {
+                    command = COMMAND_RESPONSE_DATA_XFER;
+                    payload[0] = packet.payload.empty() ? 0 : packet.payload[0];
+                    payload[1] = 0xFFFFFFFF;
+                    payload[2] = 0x80808080;
+                    len = (payload[0] == DEVICE_FN_CONTROLLER) ? 3 : 2;
+                }
+                break;
+
+                case COMMAND_BLOCK_READ:
+                {
+                    command = COMMAND_RESPONSE_DATA_XFER;
+                    len = 130;
+                    payload[0] = DEVICE_FN_STORAGE;
+                    payload[1] = packet.payload.size() > 1 ? packet.payload[1] : 0;
+                    for (uint32_t i = 2; i < len; ++i)
+                    {
+                        payload[i] = i;
+                    }
+                }
+                break;
+
+                default:
+                    // BLOCK_WRITE, SET_CONDITION, GET_LAST_ERROR are simply acknowledged
+                    break;
+            }
+
+            mResponse[0] = ((uint32_t)command << MaplePacket::Frame::COMMAND_POSITION)
+                           | ((uint32_t)hostAddr << MaplePacket::Frame::RECIPIENT_ADDR_POSITION)
+                           | ((uint32_t)senderAddr << MaplePacket::Frame::SENDER_ADDR_POSITION)
+                           | len;
+            mResponseLen = len + 1;
+            mPending = true;
+            return true;
+        }
+
+        Status processEvents(uint64_t currentTimeUs) override
+        {
+            Status status;
+            if (mPending && mResponseLen == 0)
+            {
+                mPending = false;
+                status.phase = Phase::READ_FAILED;
+                if (mLineNoise)
+                {
+                    mLineNoise = false;
+                    status.failureReason = FailureReason::CRC_INVALID;
+                }
+                else
+                {
+                    status.failureReason = FailureReason::TIMEOUT;
+                }
+            }
+            else if (mPending)
+            {
+                mPending = false;
+                status.phase = Phase::READ_COMPLETE;
+                status.readBuffer = mResponse;
+                status.readBufferLen = mResponseLen;
+                status.readCompleteTimeUs = currentTimeUs - READ_COMPLETE_LAG_US;
+            }
+            else
+            {
+                status.phase = Phase::IDLE;
+            }
+            return status;
+        }
+
+        bool isBusy() override
+        {
+            return mPending;
+        }
+
+        bool startRead(uint64_t readTimeoutUs) override
+        {
+            return true;
+        }
+
+    public:
+        //! How long before processEvents() each simulated response finished being read
+        static const uint64_t READ_COMPLETE_LAG_US = 40;
+
+    private:
+        bool mControllerAttached;
+        bool mVmuAttached;
+        bool mLineNoise;
+        uint32_t mMainFunctionCode;
+        uint32_t mMainFunctionDefinition;
+        uint32_t mWriteCount;
+        uint32_t mCommandCounts[256];
+        bool mPending;
+        uint32_t mResponse[256];
+        uint32_t mResponseLen;
+};
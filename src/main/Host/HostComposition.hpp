@@ -0,0 +1,178 @@
+// MIT License
+//
+// Copyright (c) 2022-2025 James Smith of OrangeFox86
+// https://github.com/OrangeFox86/DreamcastControllerUsbPico
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef __HOST_COMPOSITION_H__
+#define __HOST_COMPOSITION_H__
+
+#include "configuration.h"
+
+#include "DreamcastMainNode.hpp"
+#include "PlayerData.hpp"
+#include "ConditionPublisher.hpp"
+#include "ScreenData.hpp"
+#include "PrioritizedTxScheduler.hpp"
+
+#include "MapleBus.hpp"
+#include "Mutex.hpp"
+#include "Clock.hpp"
+
+#include "hal/Usb/DreamcastControllerObserver.hpp"
+#include "hal/Usb/UsbFileSystem.hpp"
+#include "hal/Usb/UsbFrameTiming.hpp"
+
+#include <memory>
+#include <utility>
+#include <vector>
+
+//! Maximum number of players supported by the hardware
+#define MAX_DEVICES 4
+
+//! Host address for each player
+static const uint8_t MAPLE_HOST_ADDRESSES[MAX_DEVICES] = {0x00, 0x40, 0x80, 0xC0};
+//! The start pin of the two-pin bus for each player
+static const uint32_t MAPLE_PINS[MAX_DEVICES] = {
+    P1_BUS_START_PIN, P2_BUS_START_PIN, P3_BUS_START_PIN, P4_BUS_START_PIN
+};
+//! The DIR pin for each player
+static const int32_t MAPLE_DIR_PINS[MAX_DEVICES] = {
+    P1_DIR_PIN, P2_DIR_PIN, P3_DIR_PIN, P4_DIR_PIN
+};
+
+//! Owns everything needed to run the host for a player count known at compile time
+//! An instance is meant to have static storage duration so that all of the objects below have a
+//! fixed location in RAM. Objects are shared with the rest of the system through non-owning shared
+//! pointers, so no heap memory is used for them. Note: peripherals and sub nodes which are created
+//! within each DreamcastMainNode are still dynamically allocated.
+template <uint32_t NumPlayers>
+class HostComposition
+{
+    static_assert(NumPlayers > 0 && NumPlayers <= MAX_DEVICES, "Invalid number of players");
+
+    public:
+        //! Constructor - must be called from the context which will execute task()
+        //! @param[in] observers  Controller observer for each player (at least NumPlayers)
+        //! @param[in] fileSystem  The file system to add storage peripherals to
+        //! @param[in] frameTiming  USB start of frame timing which controller polls may be aligned to
+        HostComposition(DreamcastControllerObserver** observers,
+                        UsbFileSystem& fileSystem,
+                        const UsbFrameTiming* frameTiming) :
+            HostComposition(observers, fileSystem, frameTiming, std::make_index_sequence<NumPlayers>())
+        {}
+
+        //! Runs the task of each main node
+        //! @param[in] currentTimeUs  The current time in microseconds
+        inline void task(uint64_t currentTimeUs)
+        {
+            for (Player& player : mPlayers)
+            {
+                player.node.task(currentTimeUs);
+            }
+        }
+
+        //! @returns the scheduler of each player
+        inline std::shared_ptr<PrioritizedTxScheduler>* getSchedulers()
+        {
+            return mSchedulers;
+        }
+
+        //! @returns the player data of each player
+        inline const std::vector<std::shared_ptr<PlayerData>>& getPlayerData() const
+        {
+            return mPlayerData;
+        }
+
+        //! @returns the clock shared by all players
+        inline ClockInterface& getClock()
+        {
+            return mClock;
+        }
+
+        //! @returns the main node of each player
+        inline const std::vector<std::shared_ptr<DreamcastMainNode>>& getMainNodes() const
+        {
+            return mMainNodes;
+        }
+
+    private:
+        //! @returns a shared pointer to obj which doesn't own it (no control block is allocated)
+        template <typename T>
+        static inline std::shared_ptr<T> nonOwning(T& obj)
+        {
+            return std::shared_ptr<T>(std::shared_ptr<T>(), &obj);
+        }
+
+        //! Everything owned for a single player
+        struct Player
+        {
+            Player(uint32_t idx,
+                   DreamcastControllerObserver& observer,
+                   ClockInterface& clock,
+                   UsbFileSystem& fileSystem,
+                   const UsbFrameTiming* frameTiming) :
+                screenData(idx),
+                pollSettings(frameTiming),
+                conditionPublisher(idx, observer),
+                playerData(
+                    idx, conditionPublisher, screenData, clock, fileSystem, pollSettings, &conditionPublisher),
+                bus(MAPLE_PINS[idx], MAPLE_DIR_PINS[idx], DIR_OUT_HIGH),
+                schedulerMutex(),
+                scheduler(schedulerMutex, MAPLE_HOST_ADDRESSES[idx]),
+                node(bus, playerData, nonOwning(scheduler))
+            {}
+
+            ScreenData screenData;
+            PollSettings pollSettings;
+            ConditionPublisher conditionPublisher;
+            PlayerData playerData;
+            MapleBus bus;
+            Mutex schedulerMutex;
+            PrioritizedTxScheduler scheduler;
+            DreamcastMainNode node;
+        };
+
+        template <std::size_t... Idx>
+        HostComposition(DreamcastControllerObserver** observers,
+                        UsbFileSystem& fileSystem,
+                        const UsbFrameTiming* frameTiming,
+                        std::index_sequence<Idx...>) :
+            mClock(),
+            mPlayers{Player(Idx, *observers[Idx], mClock, fileSystem, frameTiming)...},
+            mSchedulers{nonOwning(mPlayers[Idx].scheduler)...},
+            mPlayerData{nonOwning(mPlayers[Idx].playerData)...},
+            mMainNodes{nonOwning(mPlayers[Idx].node)...}
+        {}
+
+    private:
+        //! The clock shared by all players
+        Clock mClock;
+        //! Objects for each player
+        Player mPlayers[NumPlayers];
+        //! Non-owning pointers to each player's scheduler
+        std::shared_ptr<PrioritizedTxScheduler> mSchedulers[NumPlayers];
+        //! Non-owning pointers to each player's data
+        const std::vector<std::shared_ptr<PlayerData>> mPlayerData;
+        //! Non-owning pointers to each player's main node
+        const std::vector<std::shared_ptr<DreamcastMainNode>> mMainNodes;
+};
+
+#endif // __HOST_COMPOSITION_H__
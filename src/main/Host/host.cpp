@@ -29,28 +29,28 @@
 
 #include "configuration.h"
 
-#include "DreamcastMainNode.hpp"
-#include "PlayerData.hpp"
+#include "HostComposition.hpp"
 #include "MaplePassthroughCommandParser.hpp"
 #include "FlycastCommandParser.hpp"
+#include "MapleBinaryRequestHandler.hpp"
 
-#include "CriticalSectionMutex.hpp"
 #include "Mutex.hpp"
-#include "Clock.hpp"
+#include "CriticalSectionMutex.hpp"
+#include "HeapStats.hpp"
 #include "PicoIdentification.cpp"
 
-#include "hal/System/LockGuard.hpp"
-#include "hal/MapleBus/MapleBusInterface.hpp"
 #include "hal/Usb/usb_interface.hpp"
 #include "hal/Usb/TtyParser.hpp"
+#include "hal/Usb/LineOutput.hpp"
+#include "hal/Usb/VendorStream.hpp"
 #include "hal/Usb/client_usb_interface.hpp"
 
-#include <memory>
-#include <algorithm>
-
-#define MAX_DEVICES 4
+#if SHOW_DEBUG_MESSAGES && DEFERRED_DEBUG_MESSAGES
+#include "DeferredLog.hpp"
+#include "hardware/uart.h"
+#endif
 
-const uint8_t MAPLE_HOST_ADDRESSES[MAX_DEVICES] = {0x00, 0x40, 0x80, 0xC0};
+#include <memory>
 
 // Second Core Process
 // The second core is in charge of handling communication with Dreamcast peripherals
@@ -61,66 +61,68 @@ void core1()
     // Wait for steady state
     sleep_ms(100);
 
-    uint32_t numUsbControllers = get_num_usb_controllers();
-    uint32_t numDevices = std::min(numUsbControllers, (uint32_t)MAX_DEVICES);
-
-    uint32_t maplePins[MAX_DEVICES] = {
-        P1_BUS_START_PIN, P2_BUS_START_PIN, P3_BUS_START_PIN, P4_BUS_START_PIN
-    };
-    int32_t mapleDirPins[MAX_DEVICES] = {
-        P1_DIR_PIN, P2_DIR_PIN, P3_DIR_PIN, P4_DIR_PIN
-    };
-    CriticalSectionMutex screenMutexes[numDevices];
-    std::shared_ptr<ScreenData> screenData[numDevices];
-    std::vector<std::shared_ptr<PlayerData>> playerData;
-    playerData.resize(numDevices);
-    DreamcastControllerObserver** observers = get_usb_controller_observers();
-    std::shared_ptr<MapleBusInterface> buses[numDevices];
-    std::vector<std::shared_ptr<DreamcastMainNode>> dreamcastMainNodes;
-    dreamcastMainNodes.resize(numDevices);
-    Mutex schedulerMutexes[numDevices];
-    std::shared_ptr<PrioritizedTxScheduler> schedulers[numDevices];
-    Clock clock;
-    for (uint32_t i = 0; i < numDevices; ++i)
-    {
-        screenData[i] = std::make_shared<ScreenData>(screenMutexes[i], i);
-        playerData[i] = std::make_shared<PlayerData>(i,
-                                                     *(observers[i]),
-                                                     *screenData[i],
-                                                     clock,
-                                                     usb_msc_get_file_system());
-        buses[i] = create_maple_bus(maplePins[i], mapleDirPins[i], DIR_OUT_HIGH);
-        schedulers[i] = std::make_shared<PrioritizedTxScheduler>(schedulerMutexes[i], MAPLE_HOST_ADDRESSES[i]);
-        dreamcastMainNodes[i] = std::make_shared<DreamcastMainNode>(
-            *buses[i],
-            *playerData[i],
-            schedulers[i]);
-    }
+    // Static storage, but constructed here once the system has settled
+    static HostComposition<SELECTED_NUMBER_OF_DEVICES> host(
+        get_usb_controller_observers(), usb_msc_get_file_system(), &usb_get_frame_timing());
 
     // Initialize CDC to Maple Bus interfaces
     Mutex ttyParserMutex;
     TtyParser* ttyParser = usb_cdc_create_parser(&ttyParserMutex, 'h');
     ttyParser->addCommandParser(
         std::make_shared<MaplePassthroughCommandParser>(
-            &schedulers[0], MAPLE_HOST_ADDRESSES, numDevices));
+            host.getSchedulers(), MAPLE_HOST_ADDRESSES, SELECTED_NUMBER_OF_DEVICES));
     PicoIdentification picoIdentification;
     ttyParser->addCommandParser(
         std::make_shared<FlycastCommandParser>(
-            picoIdentification, &schedulers[0], MAPLE_HOST_ADDRESSES, numDevices, playerData, dreamcastMainNodes));
+            picoIdentification,
+            host.getClock(),
+            host.getSchedulers(),
+            MAPLE_HOST_ADDRESSES,
+            SELECTED_NUMBER_OF_DEVICES,
+            host.getPlayerData(),
+            host.getMainNodes(),
+            usb_cdc_get_line_output()));
+
+    // Initialize vendor interface to Maple Bus
+    Mutex vendorStreamMutex;
+    VendorStream* vendorStream = usb_vendor_create_stream(&vendorStreamMutex);
+    vendorStream->setRequestHandler(
+        std::make_shared<MapleBinaryRequestHandler>(
+            host.getSchedulers(), MAPLE_HOST_ADDRESSES, SELECTED_NUMBER_OF_DEVICES));
 
     while(true)
     {
         // Process each main node
-        for (auto& node : dreamcastMainNodes)
-        {
-            // Worst execution duration of below is ~350 us at 133 MHz when debug print is disabled
-            node->task(time_us_64());
-        }
+        // Worst execution duration of below is ~350 us per node at 133 MHz when debug print is disabled
+        host.task(time_us_64());
         // Process any waiting commands in the TTY parser
         ttyParser->process();
+        // Process any waiting requests on the vendor interface
+        vendorStream->process();
     }
 }
 
+#if SHOW_DEBUG_MESSAGES && DEFERRED_DEBUG_MESSAGES
+// Sends deferred debug records out over UART0 without ever blocking on a full TX FIFO
+static void deferred_log_task()
+{
+    static uint8_t buffer[64];
+    static uint32_t len = 0;
+    static uint32_t idx = 0;
+
+    if (idx >= len)
+    {
+        len = get_deferred_log().read(buffer, sizeof(buffer));
+        idx = 0;
+    }
+
+    while (idx < len && uart_is_writable(uart_default))
+    {
+        uart_putc_raw(uart_default, buffer[idx++]);
+    }
+}
+#endif
+
 // First Core Process
 // The first core is in charge of initialization and USB communication
 int main()
@@ -128,6 +130,13 @@ int main()
     set_sys_clock_khz(CPU_FREQ_KHZ, true);
 
     set_usb_descriptor_number_of_gamepads(SELECTED_NUMBER_OF_DEVICES);
+    set_usb_descriptor_composite_gamepad(USB_COMPOSITE_GAMEPAD_REPORT);
+
+#if HEAP_STATS_ENABLED
+    // Both cores allocate, so counter updates must be serialized before core1 is started
+    static CriticalSectionMutex heapStatsMutex;
+    heap_stats_set_mutex(&heapStatsMutex);
+#endif
 
 #if SHOW_DEBUG_MESSAGES
     stdio_uart_init();
@@ -136,12 +145,16 @@ int main()
     multicore_launch_core1(core1);
 
     Mutex fileMutex;
-    Mutex cdcStdioMutex;
+    // Only held while copying into the CDC output buffer, which may be done from either core
+    static CriticalSectionMutex cdcStdioMutex;
     usb_init(&fileMutex, &cdcStdioMutex);
 
     while(true)
     {
         usb_task();
+#if SHOW_DEBUG_MESSAGES && DEFERRED_DEBUG_MESSAGES
+        deferred_log_task();
+#endif
     }
 }
 